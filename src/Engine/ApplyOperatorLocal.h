@@ -204,7 +204,7 @@ public:
 		SizeType final = offset + src.effectiveSize(i0);
 		SizeType ns = lrs_.left().permutationVector().size();
 		SizeType nx = ns/A.getCRS().rows();
-		if (src.size() != lrs_.super().permutationVector().size())
+		if (src.size() != lrs_.super().permutationSize())
 			err("applyLocalOpSystem SE\n");
 
 		PackIndicesType pack1(ns);
@@ -274,7 +274,7 @@ private:
 		SizeType final = offset + src.effectiveSize(i0);
 		SizeType ns = lrs_.left().permutationVector().size();
 		SizeType nx = ns/A.getCRS().rows();
-		if (src.size() != lrs_.super().permutationVector().size())
+		if (src.size() != lrs_.super().permutationSize())
 			err("applyLocalOpSystem SE\n");
 
 		PackIndicesType pack1(ns);
@@ -398,7 +398,7 @@ private:
 		SizeType offset = src.offset(i0);
 		SizeType final = offset + src.effectiveSize(i0);
 		SizeType ns = lrs_.left().permutationVector().size();
-		if (src.size() != lrs_.super().permutationVector().size())
+		if (src.size() != lrs_.super().permutationSize())
 			err("applyLocalOpSystem SE\n");
 
 		PackIndicesType pack(ns);
@@ -0,0 +1,214 @@
+#ifndef ASYNCWRITER_H
+#define ASYNCWRITER_H
+#include "Vector.h"
+#include "ProgressIndicator.h"
+#include "Concurrency.h"
+#include <functional>
+#include <deque>
+
+namespace Dmrg {
+
+/* PSIDOC AsyncWriter
+ A thread that does writes to disk in the order they are pushed, see AsyncWrite in
+ SolverOptions. Each write is a job that owns the data it writes, together with
+ an estimate of the bytes of that data. A push waits while the jobs not yet finished
+ hold more than maxBytes, unless there are none, so that memory stays bounded.
+ push() returns a ticket; waitFor(ticket) waits until that job and all jobs before it
+ are done, and wait() until all are done. An exception thrown by a job is thrown again,
+ as a RuntimeError, by the next push or wait.
+ Without USE\_PTHREADS there is no thread, and push() does the job right away.
+ */
+class AsyncWriter {
+
+	typedef PsimagLite::Concurrency ConcurrencyType;
+	typedef std::function<void()> JobType;
+	typedef std::pair<JobType, SizeType> PairJobSizeType;
+
+public:
+
+	AsyncWriter(SizeType maxBytes)
+	    : maxBytes_(maxBytes),
+	      bytes_(0),
+	      pushed_(0),
+	      done_(0),
+	      throttled_(0),
+	      stop_(false),
+	      progress_("AsyncWriter")
+	{
+		ConcurrencyType::mutexInit(&mutex_);
+#ifdef USE_PTHREADS
+		pthread_cond_init(&work_, 0);
+		pthread_cond_init(&idle_, 0);
+		if (pthread_create(&thread_, 0, threadFunction, this) != 0)
+			err("AsyncWriter: could not create its thread\n");
+#endif
+	}
+
+	~AsyncWriter()
+	{
+		ConcurrencyType::mutexLock(&mutex_);
+		stop_ = true;
+#ifdef USE_PTHREADS
+		pthread_cond_signal(&work_);
+#endif
+		ConcurrencyType::mutexUnlock(&mutex_);
+
+#ifdef USE_PTHREADS
+		pthread_join(thread_, 0);
+		pthread_cond_destroy(&work_);
+		pthread_cond_destroy(&idle_);
+#endif
+		ConcurrencyType::mutexDestroy(&mutex_);
+
+		PsimagLite::OstringStream msgg(std::cout.precision());
+		PsimagLite::OstringStream::OstringStreamType& msg = msgg();
+		msg<<"jobs= "<<done_<<" throttled= "<<throttled_;
+		if (error_ != "") msg<<" last error= "<<error_;
+		progress_.printline(msgg, std::cout);
+	}
+
+	SizeType push(JobType job, SizeType bytes)
+	{
+#ifndef USE_PTHREADS
+		throwIfError();
+		doJob(PairJobSizeType(job, bytes));
+		++pushed_;
+		throwIfError();
+		return pushed_;
+#else
+		ConcurrencyType::mutexLock(&mutex_);
+		try {
+			throwIfError();
+		} catch (...) {
+			ConcurrencyType::mutexUnlock(&mutex_);
+			throw;
+		}
+
+		if (bytes_ > 0 && bytes_ + bytes > maxBytes_) {
+			++throttled_;
+			while (bytes_ > 0 && bytes_ + bytes > maxBytes_)
+				pthread_cond_wait(&idle_, &mutex_);
+		}
+
+		queue_.push_back(PairJobSizeType(job, bytes));
+		bytes_ += bytes;
+		const SizeType ticket = ++pushed_;
+		pthread_cond_signal(&work_);
+		ConcurrencyType::mutexUnlock(&mutex_);
+		return ticket;
+#endif
+	}
+
+	void waitFor(SizeType ticket)
+	{
+		ConcurrencyType::mutexLock(&mutex_);
+		waitLocked(ticket);
+	}
+
+	void wait()
+	{
+		ConcurrencyType::mutexLock(&mutex_);
+		waitLocked(pushed_);
+	}
+
+private:
+
+	// unlocks mutex_
+	void waitLocked(SizeType ticket)
+	{
+#ifdef USE_PTHREADS
+		while (done_ < ticket)
+			pthread_cond_wait(&idle_, &mutex_);
+#endif
+
+		try {
+			throwIfError();
+		} catch (...) {
+			ConcurrencyType::mutexUnlock(&mutex_);
+			throw;
+		}
+
+		ConcurrencyType::mutexUnlock(&mutex_);
+	}
+
+#ifdef USE_PTHREADS
+	static void* threadFunction(void* arg)
+	{
+		static_cast<AsyncWriter*>(arg)->run();
+		return 0;
+	}
+
+	void run()
+	{
+		while (true) {
+			ConcurrencyType::mutexLock(&mutex_);
+			while (!stop_ && queue_.size() == 0)
+				pthread_cond_wait(&work_, &mutex_);
+
+			if (queue_.size() == 0) { // stop_ and nothing left
+				ConcurrencyType::mutexUnlock(&mutex_);
+				return;
+			}
+
+			PairJobSizeType job = queue_.front();
+			queue_.pop_front();
+			ConcurrencyType::mutexUnlock(&mutex_);
+
+			doJob(job);
+		}
+	}
+#endif
+
+	// the data of the job is freed with it, before it counts as done
+	void doJob(PairJobSizeType job)
+	{
+		PsimagLite::String error;
+		try {
+			job.first();
+		} catch (std::exception& e) {
+			error = e.what();
+		}
+
+		job.first = JobType();
+
+		ConcurrencyType::mutexLock(&mutex_);
+		if (error != "") error_ = error;
+		bytes_ -= job.second;
+		++done_;
+#ifdef USE_PTHREADS
+		pthread_cond_broadcast(&idle_);
+#endif
+		ConcurrencyType::mutexUnlock(&mutex_);
+	}
+
+	// must be called with mutex_ locked, or without USE_PTHREADS
+	void throwIfError()
+	{
+		if (error_ == "") return;
+		PsimagLite::String error = error_;
+		error_ = "";
+		throw PsimagLite::RuntimeError("AsyncWriter: " + error + "\n");
+	}
+
+	AsyncWriter(const AsyncWriter&);
+
+	AsyncWriter& operator=(const AsyncWriter&);
+
+	SizeType maxBytes_;
+	SizeType bytes_;
+	SizeType pushed_;
+	SizeType done_;
+	SizeType throttled_;
+	bool stop_;
+	PsimagLite::String error_;
+	std::deque<PairJobSizeType> queue_;
+	ConcurrencyType::MutexType mutex_;
+#ifdef USE_PTHREADS
+	pthread_cond_t work_;
+	pthread_cond_t idle_;
+	pthread_t thread_;
+#endif
+	PsimagLite::ProgressIndicator progress_;
+}; // class AsyncWriter
+} // namespace Dmrg
+#endif // ASYNCWRITER_H
@@ -87,6 +87,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Qn.h"
 #include "QnHash.h"
 #include "Parallelizer2.h"
+#include <algorithm>
 
 namespace Dmrg {
 // A class to represent in a light way a Dmrg basis (used only to implement symmetries).
@@ -113,7 +114,7 @@ public:
 
 	//! Constructor, s=name of this basis
 	Basis(const PsimagLite::String& s)
-	    : dmrgTransformed_(false), name_(s)
+	    : dmrgTransformed_(false), name_(s), sectorOnly_(false), sectorStart_(0), sectorEnd_(0)
 	{}
 
 	//! Loads this basis from memory or disk
@@ -121,7 +122,7 @@ public:
 	Basis(IoInputter& io,
 	      const PsimagLite::String& ss,
 	      bool minimizeRead)
-	    : dmrgTransformed_(false), name_(ss)
+	    : dmrgTransformed_(false), name_(ss), sectorOnly_(false), sectorStart_(0), sectorEnd_(0)
 	{
 		correctNameIfNeeded();
 		PsimagLite::String prefix =  ss + "/";
@@ -139,7 +140,14 @@ public:
 	//! Returns the name of this basis
 	const PsimagLite::String& name() const { return name_; }
 
-	const VectorBoolType& signs() const { return signs_; }
+	//! Not stored per state for sector only products, use fermionicSign(i, f) instead
+	const VectorBoolType& signs() const
+	{
+		if (sectorOnly_)
+			err("signs(): sector only basis, use fermionicSign(i, f)\n");
+
+		return signs_;
+	}
 
 	//! Sets the block of sites for this basis
 	void set(BlockType const &B) { block_ = B; }
@@ -160,11 +168,19 @@ public:
 		quantum numbers of discarded states are discarded.
 		In this way, symmetries are implemented efficiently,
 		with minimal dependencies and in a model-independent way.
+
+		If sectorOnly is true, the permutation of the product is not stored;
+		only the offsets of each pair of partitions of basis1 and basis2 are kept,
+		and the permutation is stored for the sector of pseudoQn only.
+		The other entries of the permutation and its inverse are computed from the offsets.
+		The fermionic signs are then kept per partition, and only the offsets are written to disk.
+		This is enabled for the superblock with SectorOnlySuperBasis in SolverOptions.
 		*/
 	void setToProduct(const ThisType& basis1,
 	                  const ThisType& basis2,
 	                  const QnType* pseudoQn = 0,
-	                  SizeType initialSizeOfHashTable = 10)
+	                  SizeType initialSizeOfHashTable = 10,
+	                  bool sectorOnly = false)
 	{
 		if (useSu2Symmetry_)
 			err("SU(2) symmetry no longer supported\n");
@@ -243,17 +259,24 @@ public:
 		qns_.resize(counter, dummyQn);
 		signsPerOffset.resize(counter);
 
+		sectorOnly_ = sectorOnly;
 		const SizeType total = basis1.size() * basis2.size();
 		signs_.clear();
-		signs_.resize(total);
+		signs_.resize((sectorOnly_) ? counter : total);
 
 		offsetsFromSizes(offsets, qnSizes, signsPerOffset);
 
 		// second pass for permutation in super
 		const SizeType basisLeftSize = basis1.size();
 		const SizeType basisRightSize = basis2.size();
-		permInverse_.resize(basisLeftSize*basisRightSize);
-		permutationVector_.resize(permInverse_.size());
+		if (sectorOnly_) {
+			VectorSizeType().swap(permInverse_);
+			VectorSizeType().swap(permutationVector_);
+		} else {
+			permInverse_.resize(basisLeftSize*basisRightSize);
+			permutationVector_.resize(permInverse_.size());
+		}
+
 		counter = 0;
 
 		// -----------------------------------
@@ -285,6 +308,12 @@ public:
 			};
 		};
 
+		if (sectorOnly_) {
+			setUpSectorOnly(basis1, basis2, offset_into_perm_array, pseudoQn);
+			signsOld_ = signs_;
+			return;
+		}
+
 		// -----------------------------------------
 		// collapsed loop to fill permutation vector
 		// -----------------------------------------
@@ -356,32 +385,83 @@ public:
 	//! returns the permutation of i
 	SizeType permutation(SizeType i) const
 	{
+		if (sectorOnly_) {
+			if (i >= sectorStart_ && i < sectorEnd_)
+				return sectorPermutation_[i - sectorStart_];
+			return permutationFromPatches(i);
+		}
+
 		assert(i<permutationVector_.size());
 		return  permutationVector_[i];
 	}
 
 	//! Return the permutation vector
+	//! Not stored for sector only products, use permutation(i) instead
 	const VectorSizeType& permutationVector() const
 	{
+		if (sectorOnly_)
+			err("permutationVector(): sector only basis, use permutation(i)\n");
+
 		return  permutationVector_;
 	}
 
 	//! returns the inverse permutation of i
 	int permutationInverse(SizeType i) const
 	{
+		if (sectorOnly_)
+			return permutationInverseFromPatches(i);
+
 		assert(i<permInverse_.size());
 		return permInverse_[i];
 	}
 
 	//! returns the inverse permutation vector
+	//! Not stored for sector only products, use permutationInverse(i) instead
 	const VectorSizeType& permutationInverse() const
 	{
+		if (sectorOnly_)
+			err("permutationInverse(): sector only basis, use permutationInverse(i)\n");
+
 		return permInverse_;
 	}
 
+	//! returns the size of the permutation
+	SizeType permutationSize() const
+	{
+		if (sectorOnly_)
+			return productLeftSize() * (rightOffsets_[rightOffsets_.size() - 1]);
+
+		return permInverse_.size();
+	}
+
+	//! prints the permutation in the format of a vector, one entry at a time
+	void printPermutation(std::ostream& os) const
+	{
+		if (!sectorOnly_) {
+			os<<permutationVector_;
+			return;
+		}
+
+		const SizeType n = permutationSize();
+		os<<n<<"\n";
+		for (SizeType i = 0; i < n; ++i)
+			os<<permutation(i)<<"\n";
+	}
+
 	//! returns the block of sites over which this basis is built
 	const BlockType& block() const { return block_; }
 
+	// bytes held by the vectors of this basis, an estimate, see AsyncWriter
+	SizeType memoryEstimate() const
+	{
+		SizeType n = offsets_.size() + permutationVector_.size() + permInverse_.size();
+		n += leftOffsets_.size() + rightOffsets_.size() + leftPartitionOf_.size();
+		n += rightPartitionOf_.size() + patchOffsets_.size() + patchStarts_.size();
+		n += patchesByOffset_.size() + sectorPermutation_.size();
+		return n*sizeof(SizeType) + qns_.size()*sizeof(QnType) +
+		        (signs_.size() + signsOld_.size())/8;
+	}
+
 	//! returns the size of this basis
 	SizeType size() const
 	{
@@ -507,11 +587,23 @@ public:
 		return symmSu2_.flavorsOld();
 	}
 
-	const VectorBoolType& oldSigns() const { return signsOld_; }
+	const VectorBoolType& oldSigns() const
+	{
+		if (sectorOnly_)
+			err("oldSigns(): sector only basis, use fermionicSign(i, f)\n");
+
+		return signsOld_;
+	}
 
 	//! Returns the fermionic sign for state i
 	int fermionicSign(SizeType i, int f) const
 	{
+		if (sectorOnly_) {
+			const SizeType p = partitionOfState(i);
+			assert(p < signs_.size());
+			return (signs_[p]) ? f : 1;
+		}
+
 		assert(i < signs_.size());
 		return (signs_[i]) ? f : 1;
 	}
@@ -610,7 +702,15 @@ public:
 		}
 
 		io.write(offsets_, label + "PARTITION", mode);
-		io.write(permInverse_, label + "PERMUTATIONINVERSE", mode);
+		if (sectorOnly_) {
+			// the offsets the permutation is computed from, see setToProduct
+			io.write(sectorOnly_, label + "SectorOnly", mode);
+			io.write(leftOffsets_, label + "LeftPartition", mode);
+			io.write(rightOffsets_, label + "RightPartition", mode);
+			io.write(patchOffsets_, label + "PatchOffsets", mode);
+		} else {
+			io.write(permInverse_, label + "PERMUTATIONINVERSE", mode);
+		}
 		if (mode == PsimagLite::IoNgSerializer::ALLOW_OVERWRITE)
 			io.overwrite(qns_, label + "QNShrink");
 		else
@@ -645,7 +745,7 @@ public:
 		os<<"partition\n";
 		os<<x.offsets_;
 		os<<"permutation\n";
-		os<<x.permutationVector_;
+		x.printPermutation(os);
 		os<<"block\n";
 		os<<x.block_;
 		return os;
@@ -676,6 +776,7 @@ protected:
 
 		qns_.clear();
 		offsets_.clear();
+		sectorOnly_ = false;
 		permutationVector_.resize(n);
 		permInverse_.resize(n);
 		assert(0 < basisData2.size());
@@ -724,10 +825,27 @@ private:
 		}
 
 		io.read(offsets_, prefix + "PARTITION");
-		io.read(permInverse_, prefix + "PERMUTATIONINVERSE");
-		permutationVector_.resize(permInverse_.size());
-		for (SizeType i=0;i<permInverse_.size();i++)
-			permutationVector_[permInverse_[i]]=i;
+		sectorOnly_ = false;
+		try {
+			io.read(sectorOnly_, prefix + "SectorOnly");
+		} catch (...) {}
+
+		if (sectorOnly_) {
+			io.read(leftOffsets_, prefix + "LeftPartition");
+			io.read(rightOffsets_, prefix + "RightPartition");
+			VectorSizeType patchOffsets;
+			io.read(patchOffsets, prefix + "PatchOffsets");
+			setUpPatches(patchOffsets);
+			sectorStart_ = sectorEnd_ = 0;
+			sectorPermutation_.clear();
+			VectorSizeType().swap(permInverse_);
+			VectorSizeType().swap(permutationVector_);
+		} else {
+			io.read(permInverse_, prefix + "PERMUTATIONINVERSE");
+			permutationVector_.resize(permInverse_.size());
+			for (SizeType i=0;i<permInverse_.size();i++)
+				permutationVector_[permInverse_[i]]=i;
+		}
 
 		QnType::readVector(qns_, prefix + "QNShrink", io);
 		if (!minimizeRead) checkSigns();
@@ -748,11 +866,17 @@ private:
 		SizeType n = offsets_.size();
 		assert(n > 0);
 		--n;
-		assert(offsets_[n] == signs_.size());
+		assert(offsets_[n] == signs_.size() || (sectorOnly_ && n == signs_.size()));
 		for (SizeType p = 0; p < n; ++p) {
 			SizeType start = offsets_[p];
 			SizeType end = offsets_[p + 1];
 			SizeType expected = (qns_[p].other[0] & 1);
+			if (sectorOnly_) {
+				if (signs_[p] != expected)
+					err("Unexpected sign\n");
+				continue;
+			}
+
 			for (SizeType i = start; i < end; ++i) {
 				if (signs_[i] != expected)
 					err("Unexpected sign\n");
@@ -770,7 +894,7 @@ private:
 		offsets_.resize(sizes.size() + 1);
 		assert(signsPerOffset.size() == total);
 
-		// signs_ has already the right size here
+		// signs_ has already the right size here, one per partition if sectorOnly_
 
 		offsets_[0] = 0;
 		for (SizeType i = 0; i < total; ++i) {
@@ -780,11 +904,122 @@ private:
 			offsets[qn] = offsets_[i];
 			const SizeType offset = offsets_[i];
 			const bool value = signsPerOffset[i];
+			if (sectorOnly_) {
+				signs_[i] = value;
+				continue;
+			}
+
 			for (SizeType k = 0; k < thisSize; ++k)
 				signs_[offset + k] = value;
 		}
 	}
 
+	// Keeps the offsets of the patches, pairs of partitions ps of basis1 and
+	// pe of basis2, at index ps + pe*nps, and the permutation of the sector of pseudoQn
+	void setUpSectorOnly(const ThisType& basis1,
+	                     const ThisType& basis2,
+	                     const VectorSizeType& patchOffsets,
+	                     const QnType* pseudoQn)
+	{
+		leftOffsets_ = basis1.offsets_;
+		rightOffsets_ = basis2.offsets_;
+		setUpPatches(patchOffsets);
+
+		sectorStart_ = sectorEnd_ = 0;
+		if (pseudoQn) {
+			for (SizeType m = 0; m < qns_.size(); ++m) {
+				if (!(qns_[m] == *pseudoQn)) continue;
+				sectorStart_ = offsets_[m];
+				sectorEnd_ = offsets_[m + 1];
+				break;
+			}
+		}
+
+		sectorPermutation_.resize(sectorEnd_ - sectorStart_);
+		if (sectorEnd_ == sectorStart_) return;
+
+		PsimagLite::Parallelizer2<> parallelizer2(PsimagLite::Concurrency::codeSectionParams);
+		parallelizer2.parallelFor(sectorStart_,
+		                          sectorEnd_,
+		                          [this](SizeType i, SizeType) {
+			this->sectorPermutation_[i - this->sectorStart_] = this->permutationFromPatches(i);
+		});
+	}
+
+	// from leftOffsets_ and rightOffsets_, already set
+	void setUpPatches(const VectorSizeType& patchOffsets)
+	{
+		partitionOf(leftPartitionOf_, leftOffsets_);
+		partitionOf(rightPartitionOf_, rightOffsets_);
+		patchOffsets_ = patchOffsets;
+
+		patchStarts_ = patchOffsets;
+		patchesByOffset_.resize(patchStarts_.size());
+		PsimagLite::Sort<VectorSizeType> sort;
+		sort.sort(patchStarts_, patchesByOffset_);
+	}
+
+	// the partition that contains state i, with offsets_ sorted
+	SizeType partitionOfState(SizeType i) const
+	{
+		typename VectorSizeType::const_iterator it = std::upper_bound(offsets_.begin(),
+		                                                              offsets_.end(),
+		                                                              i);
+		assert(it != offsets_.begin() && it != offsets_.end());
+		return (it - offsets_.begin()) - 1;
+	}
+
+	static void partitionOf(VectorSizeType& v, const VectorSizeType& offsets)
+	{
+		assert(offsets.size() > 0);
+		const SizeType n = offsets.size() - 1;
+		v.resize(offsets[n]);
+		for (SizeType p = 0; p < n; ++p)
+			for (SizeType i = offsets[p]; i < offsets[p + 1]; ++i)
+				v[i] = p;
+	}
+
+	SizeType productLeftSize() const
+	{
+		assert(leftOffsets_.size() > 0);
+		return leftOffsets_[leftOffsets_.size() - 1];
+	}
+
+	SizeType permutationInverseFromPatches(SizeType iglobalState) const
+	{
+		const SizeType basisLeftSize = productLeftSize();
+		const SizeType ileftOffset = iglobalState % basisLeftSize;
+		const SizeType irightOffset = iglobalState / basisLeftSize;
+		assert(ileftOffset < leftPartitionOf_.size());
+		assert(irightOffset < rightPartitionOf_.size());
+		const SizeType ps = leftPartitionOf_[ileftOffset];
+		const SizeType pe = rightPartitionOf_[irightOffset];
+		const SizeType nps = leftOffsets_.size() - 1;
+		const SizeType leftSize = leftOffsets_[ps + 1] - leftOffsets_[ps];
+		const SizeType ileft = ileftOffset - leftOffsets_[ps];
+		const SizeType iright = irightOffset - rightOffsets_[pe];
+		return patchOffsets_[ps + pe*nps] + ileft + iright*leftSize;
+	}
+
+	SizeType permutationFromPatches(SizeType ipos) const
+	{
+		// the last patch that starts at or before ipos
+		typename VectorSizeType::const_iterator it = std::upper_bound(patchStarts_.begin(),
+		                                                              patchStarts_.end(),
+		                                                              ipos);
+		assert(it != patchStarts_.begin());
+		const SizeType ind = (it - patchStarts_.begin()) - 1;
+		const SizeType pspe = patchesByOffset_[ind];
+		const SizeType nps = leftOffsets_.size() - 1;
+		const SizeType pe = pspe/nps;
+		const SizeType ps = pspe - pe*nps;
+		const SizeType leftSize = leftOffsets_[ps + 1] - leftOffsets_[ps];
+		const SizeType local = ipos - patchStarts_[ind];
+		const SizeType iright = local/leftSize;
+		const SizeType ileft = local - iright*leftSize;
+		return leftOffsets_[ps] + ileft + (rightOffsets_[pe] + iright)*productLeftSize();
+	}
+
 	void checkPermutation(const VectorSizeType& v) const
 	{
 #ifdef NDEBUG
@@ -957,6 +1192,18 @@ these numbers are
 	BlockType block_;
 	bool dmrgTransformed_;
 	PsimagLite::String name_;
+	// for sector only products, see setToProduct
+	bool sectorOnly_;
+	VectorSizeType leftOffsets_;
+	VectorSizeType rightOffsets_;
+	VectorSizeType leftPartitionOf_;
+	VectorSizeType rightPartitionOf_;
+	VectorSizeType patchOffsets_;
+	VectorSizeType patchStarts_;
+	VectorSizeType patchesByOffset_;
+	SizeType sectorStart_;
+	SizeType sectorEnd_;
+	VectorSizeType sectorPermutation_;
 	static bool useSu2Symmetry_;
 
 }; // class Basis
@@ -261,6 +261,14 @@ public:
 
 	SizeType numberOfLocalOperators() const { return operators_.sizeOfLocal(); }
 
+	// bytes held by the basis and the nonzeros of the operators, an estimate,
+	// see AsyncWriter
+	SizeType memoryEstimate() const
+	{
+		return BasisType::memoryEstimate() +
+		        operators_.nonZeros()*(sizeof(ComplexOrRealType) + sizeof(int));
+	}
+
 	SizeType superOperatorIndices(const VectorSizeType& sites, SizeType sigma) const
 	{
 		return operators_.superIndices(sites, sigma);
@@ -324,6 +332,10 @@ private:
 		                        BaseType::permutationInverse(),
 		                        someSuperOpHelper);
 
+		VectorSizeType partitions(BaseType::partition());
+		for (SizeType i = 0; i < partitions.size(); ++i)
+			partitions[i] = BaseType::partition(i);
+		operators_.toBlocked(partitions);
 
 		//! Calc. hamiltonian
 		operators_.outerProductHamiltonian(basis2.hamiltonian(),
@@ -0,0 +1,290 @@
+#ifndef BLOCKLANCZOSSOLVER_H
+#define BLOCKLANCZOSSOLVER_H
+#include "Vector.h"
+#include "Matrix.h"
+#include "ProgressIndicator.h"
+#include "TypeToString.h"
+#include "Random48.h"
+
+namespace Dmrg {
+
+/* PSIDOC BlockLanczosSolver
+ Block Lanczos with full reorthogonalization and thick restart.
+ All nexcited lowest states are computed together: each step applies
+ the Hamiltonian to a whole block of vectors, and the Ritz pairs
+ are obtained from the projection of H onto the block Krylov space.
+ The residuals of the current Ritz vectors become the next block, which
+ spans the same space as the next block of the block Lanczos recursion.
+ When the basis reaches MAX_BLOCKS_IN_BASIS blocks it is restarted
+ with the current Ritz vectors. LanczosSteps= bounds the number of
+ block steps and LanczosEps= is the tolerance on the squared residuals,
+ which bound the error of the eigenvalues.
+ */
+template<typename ParametersType, typename MatrixType_, typename VectorType_>
+class BlockLanczosSolver {
+
+public:
+
+	typedef MatrixType_ MatrixType;
+	typedef VectorType_ VectorType;
+	typedef typename VectorType::value_type ComplexOrRealType;
+	typedef typename PsimagLite::Real<ComplexOrRealType>::Type RealType;
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
+	typedef typename PsimagLite::Vector<VectorType>::Type VectorVectorType;
+	typedef PsimagLite::Matrix<ComplexOrRealType> DenseMatrixType;
+
+	static const SizeType MAX_BLOCKS_IN_BASIS = 16;
+
+	// the random vectors that fill the block come from seed, so that
+	// solvers running concurrently do not share a generator
+	BlockLanczosSolver(const MatrixType& mat, const ParametersType& params, long int seed)
+	    : progress_("BlockLanczos"),
+	      mat_(mat),
+	      steps_(params.steps),
+	      eps_(params.tolerance),
+	      matrixVectorProducts_(0),
+	      rng_(seed)
+	{}
+
+	void computeAllStatesBelow(VectorRealType& eigs,
+	                           VectorVectorType& z,
+	                           const VectorType& initialVector,
+	                           SizeType nexcited)
+	{
+		const SizeType n = mat_.rows();
+		const SizeType k = nexcited;
+		if (k == 0)
+			err("BlockLanczosSolver: nothing to compute\n");
+
+		// callers read nexcited energies and vectors
+		if (n < k)
+			err("BlockLanczosSolver: matrix rank " + ttos(n) + " smaller than " +
+			    ttos(k) + " excited states\n");
+
+		const SizeType maxBasis = std::min(n, k*MAX_BLOCKS_IN_BASIS);
+
+		VectorVectorType block(k);
+		block[0] = initialVector;
+		if (PsimagLite::norm(block[0]) < 1e-12)
+			fillRandom(block[0], n);
+		for (SizeType i = 1; i < k; ++i)
+			fillRandom(block[i], n);
+
+		VectorVectorType q;
+		VectorVectorType hq;
+		DenseMatrixType t;
+		VectorRealType theta;
+		VectorVectorType ritz(k);
+		VectorVectorType hritz(k);
+		orthonormalizeBlock(block, q);
+
+		matrixVectorProducts_ = 0;
+		RealType maxResidual = 0;
+		SizeType step = 0;
+		const SizeType maxSteps = std::max(steps_, static_cast<SizeType>(1));
+		for (; step < maxSteps; ++step) {
+			if (block.size() == 0) break; // invariant subspace found
+
+			VectorVectorType hblock;
+			applyBlock(hblock, block);
+			appendBlock(q, hq, t, block, hblock);
+
+			DenseMatrixType y = t;
+			theta.resize(y.rows());
+			PsimagLite::diag(y, theta, 'V');
+
+			ritzVectors(ritz, q, y, k);
+			ritzVectors(hritz, hq, y, k);
+
+			maxResidual = 0;
+			block.resize(ritz.size());
+			for (SizeType m = 0; m < ritz.size(); ++m) {
+				block[m] = hritz[m];
+				for (SizeType i = 0; i < n; ++i)
+					block[m][i] -= theta[m]*ritz[m][i];
+				RealType r = PsimagLite::norm(block[m]);
+				if (r > maxResidual) maxResidual = r;
+			}
+
+			if (maxResidual*maxResidual < eps_) break;
+
+			if (q.size() + k > maxBasis && q.size() > ritz.size()) {
+				// thick restart with the current Ritz vectors
+				q = ritz;
+				hq = hritz;
+				t.resize(0, 0);
+				VectorVectorType empty;
+				appendBlock(q, hq, t, empty, empty);
+			}
+
+			orthonormalizeBlock(block, q);
+		}
+
+		if (ritz.size() < k)
+			err("BlockLanczosSolver: found only " + ttos(ritz.size()) + " of " +
+			    ttos(k) + " states\n");
+
+		eigs.resize(ritz.size());
+		for (SizeType m = 0; m < ritz.size(); ++m)
+			eigs[m] = theta[m];
+
+		if (z.size() < ritz.size())
+			z.resize(ritz.size());
+		for (SizeType m = 0; m < ritz.size(); ++m)
+			z[m] = ritz[m];
+
+		PsimagLite::OstringStream msgg(std::cout.precision());
+		PsimagLite::OstringStream::OstringStreamType& msg = msgg();
+		msg<<"Steps="<<step<<" blockSize="<<k<<" basis="<<q.size();
+		msg<<" matrixVectorProducts="<<matrixVectorProducts_;
+		msg<<" maxResidual="<<maxResidual<<" eps="<<eps_;
+		progress_.printline(msgg, std::cout);
+
+		if (maxResidual*maxResidual < eps_ || block.size() == 0) return;
+
+		PsimagLite::OstringStream msgg2(std::cout.precision());
+		PsimagLite::OstringStream::OstringStreamType& msg2 = msgg2();
+		msg2<<"WARNING: not converged after "<<step<<" block steps";
+		progress_.printline(msgg2, std::cout);
+	}
+
+	SizeType matrixVectorProducts() const { return matrixVectorProducts_; }
+
+private:
+
+	// hblock[i] = H*block[i] for all i, with one multi-vector product
+	void applyBlock(VectorVectorType& hblock, const VectorVectorType& block)
+	{
+		const SizeType n = mat_.rows();
+		const SizeType nb = block.size();
+		hblock.resize(nb);
+		for (SizeType i = 0; i < nb; ++i) {
+			hblock[i].resize(n);
+			std::fill(hblock[i].begin(), hblock[i].end(), 0.0);
+		}
+
+		mat_.matrixMultiVectorProduct(hblock, block);
+
+		matrixVectorProducts_ += nb;
+	}
+
+	// Adds block and H*block to q and hq, and extends t = q^dagger hq
+	static void appendBlock(VectorVectorType& q,
+	                        VectorVectorType& hq,
+	                        DenseMatrixType& t,
+	                        const VectorVectorType& block,
+	                        const VectorVectorType& hblock)
+	{
+		const SizeType oldSize = t.rows();
+		for (SizeType i = 0; i < block.size(); ++i) {
+			q.push_back(block[i]);
+			hq.push_back(hblock[i]);
+		}
+
+		const SizeType newSize = q.size();
+		DenseMatrixType tnew(newSize, newSize);
+		for (SizeType j = 0; j < oldSize; ++j)
+			for (SizeType i = 0; i < oldSize; ++i)
+				tnew(i, j) = t(i, j);
+
+		for (SizeType j = oldSize; j < newSize; ++j) {
+			for (SizeType i = 0; i < j; ++i) {
+				tnew(i, j) = scalarProduct(q[i], hq[j]);
+				tnew(j, i) = PsimagLite::conj(tnew(i, j));
+			}
+
+			tnew(j, j) = PsimagLite::real(scalarProduct(q[j], hq[j]));
+		}
+
+		t = tnew;
+	}
+
+	// dest[m] = sum_i src[i]*y(i, m) for the lowest k values of m
+	static void ritzVectors(VectorVectorType& dest,
+	                        const VectorVectorType& src,
+	                        const DenseMatrixType& y,
+	                        SizeType k)
+	{
+		const SizeType nvectors = std::min(k, y.cols());
+		const SizeType n = src[0].size();
+		dest.resize(nvectors);
+		for (SizeType m = 0; m < nvectors; ++m) {
+			dest[m].resize(n);
+			std::fill(dest[m].begin(), dest[m].end(), 0.0);
+			for (SizeType i = 0; i < src.size(); ++i) {
+				const ComplexOrRealType c = y(i, m);
+				for (SizeType x = 0; x < n; ++x)
+					dest[m][x] += src[i][x]*c;
+			}
+		}
+	}
+
+	// Orthonormalizes block against q and itself (Gram-Schmidt twice),
+	// dropping the vectors that become linearly dependent
+	static void orthonormalizeBlock(VectorVectorType& block, const VectorVectorType& q)
+	{
+		VectorVectorType accepted;
+		for (SizeType m = 0; m < block.size(); ++m) {
+			VectorType& v = block[m];
+			const RealType norm0 = PsimagLite::norm(v);
+			if (norm0 < 1e-12) continue;
+
+			for (SizeType pass = 0; pass < 2; ++pass) {
+				removeProjections(v, q);
+				removeProjections(v, accepted);
+			}
+
+			const RealType norm1 = PsimagLite::norm(v);
+			if (norm1 < 1e-8*norm0) continue;
+
+			for (SizeType i = 0; i < v.size(); ++i)
+				v[i] /= norm1;
+			accepted.push_back(v);
+		}
+
+		block.swap(accepted);
+	}
+
+	static void removeProjections(VectorType& v, const VectorVectorType& basis)
+	{
+		for (SizeType j = 0; j < basis.size(); ++j) {
+			const ComplexOrRealType c = scalarProduct(basis[j], v);
+			for (SizeType i = 0; i < v.size(); ++i)
+				v[i] -= c*basis[j][i];
+		}
+	}
+
+	static ComplexOrRealType scalarProduct(const VectorType& v1, const VectorType& v2)
+	{
+		ComplexOrRealType sum = 0;
+		for (SizeType i = 0; i < v1.size(); ++i)
+			sum += PsimagLite::conj(v1[i])*v2[i];
+		return sum;
+	}
+
+	void fillRandom(VectorType& v, SizeType n)
+	{
+		v.resize(n);
+		for (SizeType i = 0; i < n; ++i)
+			myRandomT(v[i]);
+	}
+
+	void myRandomT(std::complex<RealType>& value)
+	{
+		value = std::complex<RealType>(rng_() - 0.5, rng_() - 0.5);
+	}
+
+	void myRandomT(RealType& value)
+	{
+		value = rng_() - 0.5;
+	}
+
+	PsimagLite::ProgressIndicator progress_;
+	const MatrixType& mat_;
+	SizeType steps_;
+	RealType eps_;
+	SizeType matrixVectorProducts_;
+	PsimagLite::Random48<RealType> rng_;
+}; // class BlockLanczosSolver
+} // namespace Dmrg
+#endif // BLOCKLANCZOSSOLVER_H
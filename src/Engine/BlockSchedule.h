@@ -0,0 +1,175 @@
+#ifndef BLOCKSCHEDULE_H
+#define BLOCKSCHEDULE_H
+#include "Vector.h"
+#include "Sort.h"
+#include "Parallelizer.h"
+#include "LoadBalancerWeights.h"
+#include <cmath>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef USE_OPENBLAS_THREADS
+extern "C" void openblas_set_num_threads(int);
+extern "C" int openblas_get_num_threads();
+#endif
+
+namespace Dmrg {
+
+/* PSIDOC BlockSchedule
+ Order in which the dense blocks of a block diagonal matrix are diagonalized
+ or decomposed, given the estimated cost of each block.
+ The blocks are handed to the threads with LoadBalancerWeights, so that the largest
+ ones start first and the small ones fill the gaps.
+ If twoLevel is true, see TwoLevelSvd in SolverOptions, the blocks whose cost exceeds a fair
+ share of the total are first done one after the other by the calling thread, so that
+ a multithreaded BLAS/LAPACK can use all its threads for each of them; the remaining
+ blocks are then done one per thread as above.
+ With more than one thread, BLAS/LAPACK is given all threads for the large blocks and one
+ thread for each small block, and is restored afterwards. This is done with
+ omp_set_num_threads if compiled with OpenMP, and with openblas_set_num_threads if
+ compiled with -DUSE_OPENBLAS_THREADS.
+ Costs are given in double, because n^3 overflows SizeType for large blocks with
+ -DUSE_SHORT, and are scaled down to integer weights for LoadBalancerWeights.
+ */
+class BlockSchedule {
+
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+
+	// the sum of the weights of the small blocks must fit in SizeType
+	static const SizeType MAX_WEIGHT = 65536;
+
+	// sets the number of threads of BLAS/LAPACK in each task of the small blocks
+	template<typename HelperType>
+	class OneBlasThread {
+
+	public:
+
+		OneBlasThread(HelperType& helper) : helper_(helper) {}
+
+		SizeType tasks() const { return helper_.tasks(); }
+
+		void doTask(SizeType taskNumber, SizeType threadNum)
+		{
+			BlockSchedule::setBlasThreads(1);
+			helper_.doTask(taskNumber, threadNum);
+		}
+
+	private:
+
+		HelperType& helper_;
+	};
+
+public:
+
+	typedef PsimagLite::Vector<double>::Type VectorDoubleType;
+
+	BlockSchedule(const VectorDoubleType& costs, SizeType threads, bool twoLevel)
+	    : threads_(std::max(threads, static_cast<SizeType>(1)))
+	{
+		const SizeType n = costs.size();
+		double total = 0;
+		for (SizeType i = 0; i < n; ++i)
+			total += costs[i];
+
+		const double share = total/threads_;
+		double maxSmall = 0;
+		for (SizeType i = 0; i < n; ++i) {
+			if (twoLevel && threads_ > 1 && costs[i] > share) {
+				large_.push_back(i);
+				continue;
+			}
+
+			small_.push_back(i);
+			maxSmall = std::max(maxSmall, costs[i]);
+		}
+
+		// the same scale for all blocks, so that only the proportions are lost
+		const double factor = (maxSmall*small_.size() > MAX_WEIGHT)
+		        ? MAX_WEIGHT/(maxSmall*small_.size()) : 1.0;
+		smallWeights_.resize(small_.size());
+		for (SizeType i = 0; i < small_.size(); ++i) {
+			const SizeType w = static_cast<SizeType>(std::ceil(costs[small_[i]]*factor));
+			smallWeights_[i] = std::max(w, static_cast<SizeType>(1));
+		}
+
+		if (large_.size() < 2) return;
+
+		VectorDoubleType largeCosts(large_.size());
+		for (SizeType i = 0; i < large_.size(); ++i)
+			largeCosts[i] = costs[large_[i]];
+
+		VectorSizeType perm(large_.size());
+		PsimagLite::Sort<VectorDoubleType> sort;
+		sort.sort(largeCosts, perm);
+		VectorSizeType sorted(large_.size());
+		for (SizeType i = 0; i < large_.size(); ++i)
+			sorted[i] = large_[perm[large_.size() - 1 - i]];
+		large_.swap(sorted);
+	}
+
+	// HelperType::doTask(i, thread) must call doBlock(tasks[i]), see setTasks(tasks)
+	template<typename HelperType>
+	void run(HelperType& helper) const
+	{
+		// with one thread there are no large blocks, and BLAS is left as it is
+		if (threads_ == 1) {
+			runSmall(helper, helper);
+			return;
+		}
+
+		const int saved = blasThreads();
+		setBlasThreads(threads_);
+		for (SizeType i = 0; i < large_.size(); ++i)
+			helper.doBlock(large_[i]);
+
+		setBlasThreads(1);
+		OneBlasThread<HelperType> oneBlasThread(helper);
+		runSmall(oneBlasThread, helper);
+		setBlasThreads(saved);
+	}
+
+	SizeType largeBlocks() const { return large_.size(); }
+
+	static int blasThreads()
+	{
+#ifdef USE_OPENBLAS_THREADS
+		return openblas_get_num_threads();
+#elif defined(_OPENMP)
+		return omp_get_max_threads();
+#else
+		return 1;
+#endif
+	}
+
+	static void setBlasThreads(int threads)
+	{
+#ifdef _OPENMP
+		omp_set_num_threads(threads);
+#endif
+#ifdef USE_OPENBLAS_THREADS
+		openblas_set_num_threads(threads);
+#endif
+	}
+
+private:
+
+	template<typename TaskType, typename HelperType>
+	void runSmall(TaskType& task, HelperType& helper) const
+	{
+		if (small_.size() == 0) return;
+
+		helper.setTasks(small_);
+		PsimagLite::CodeSectionParams codeSectionParams(threads_);
+		PsimagLite::Parallelizer<TaskType,
+		        PsimagLite::LoadBalancerWeights> parallelizer(codeSectionParams);
+		parallelizer.loopCreate(task, smallWeights_);
+	}
+
+	SizeType threads_;
+	VectorSizeType large_;
+	VectorSizeType small_;
+	VectorSizeType smallWeights_;
+}; // class BlockSchedule
+} // namespace Dmrg
+#endif // BLOCKSCHEDULE_H
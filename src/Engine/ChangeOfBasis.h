@@ -39,6 +39,7 @@ public:
 	                SizeType threadsForGemmR) const
 	{
 		if (!ProgramGlobals::oldChangeOfBasis) {
+			if (transformBlocks(v, transform_, gemmRnb, threadsForGemmR)) return;
 			BlockOffDiagMatrixType vBlocked(v.getCRS(), transform_.offsetsRows());
 			vBlocked.transform(transform_, gemmRnb, threadsForGemmR);
 			vBlocked.toSparse(v.getCRSNonConst());
@@ -54,10 +55,8 @@ public:
 	                        SizeType gemmRnb,
 	                        SizeType threadsForGemmR)
 	{
-		if (!v.justCRS())
-			err("changeBasis: operatorstorage not justCRS\n");
-
 		if (!ProgramGlobals::oldChangeOfBasis) {
+			if (transformBlocks(v, ftransform1, gemmRnb, threadsForGemmR)) return;
 			BlockOffDiagMatrixType vBlocked(v.getCRS(), ftransform1.offsetsRows());
 			vBlocked.transform(ftransform1, gemmRnb, threadsForGemmR);
 			vBlocked.toSparse(v.getCRSNonConst());
@@ -81,6 +80,24 @@ public:
 
 private:
 
+	// blocked storage, see OperatorStorage, is transformed in place
+	// and stays blocked; returns false if v is CRS, or was blocked
+	// differently and is now CRS
+	static bool transformBlocks(OperatorStorageType& v,
+	                            const BlockDiagonalMatrixType& f,
+	                            SizeType gemmRnb,
+	                            SizeType threadsForGemmR)
+	{
+		if (v.justCRS()) return false;
+		if (v.getBlocks().offsets() != f.offsetsRows()) {
+			v.toCRS();
+			return false;
+		}
+
+		v.getBlocksNonConst().transform(f, gemmRnb, threadsForGemmR);
+		return true;
+	}
+
 	BlockDiagonalMatrixType transform_;
 	SparseMatrixType oldT_;
 	SparseMatrixType oldTtranspose_;
@@ -0,0 +1,258 @@
+#ifndef CHANGEOFBASISBATCHED_H
+#define CHANGEOFBASISBATCHED_H
+#include "Vector.h"
+#include "Matrix.h"
+#include "GemmR.h"
+#include "Concurrency.h"
+#include "Parallelizer.h"
+#include "Parallelizer2.h"
+#include "LoadBalancerWeights.h"
+#include "BlockDiagonalMatrix.h"
+#include "OperatorBlocks.h"
+
+namespace Dmrg {
+
+/* PSIDOC ChangeOfBasisBatched
+ Change of basis of many operators at once, enabled with BatchedChangeOfBasis
+ in SolverOptions. All operators are first split into blocks of symmetry
+ sectors, in parallel over operators. The blocks of all operators that connect the same
+ pair of sectors, and therefore have the same shape and the same transformation, are then
+ transformed together: they are stacked, multiplied by the block of the transform on the right
+ with a single GEMM, restacked, and multiplied by the adjoint of the block on the left with
+ another GEMM. These pairs of sectors are distributed among threads, with weights equal to
+ their flops. Finally each operator is converted back to CRS, unless its storage
+ was already blocked, see OperatorStorage, in which case its blocks are transformed
+ in place and no conversion is done at all.
+ All operators are held in blocked form at the same time, which takes more memory than
+ the default, which blocks one operator per thread at a time.
+ */
+template<typename OperatorStorageType, typename MatrixType>
+class ChangeOfBasisBatched {
+
+	typedef BlockDiagonalMatrix<MatrixType> BlockDiagonalMatrixType;
+	typedef typename MatrixType::value_type ComplexOrRealType;
+	typedef OperatorBlocks<ComplexOrRealType> OperatorBlocksType;
+	typedef typename OperatorBlocksType::SparseMatrixType SparseMatrixType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef typename PsimagLite::Vector<OperatorBlocksType*>::Type VectorOperatorBlocksType;
+
+	struct Group {
+
+		Group(SizeType i, SizeType j) : ipatch(i), jpatch(j) {}
+
+		SizeType ipatch;
+		SizeType jpatch;
+		VectorSizeType ops;
+	};
+
+	typedef typename PsimagLite::Vector<Group>::Type VectorGroupType;
+
+public:
+
+	typedef typename PsimagLite::Vector<OperatorStorageType*>::Type VectorOperatorStoragePtrType;
+
+	ChangeOfBasisBatched(const BlockDiagonalMatrixType& f,
+	                     SizeType gemmRnb,
+	                     SizeType threadsForGemmR)
+	    : f_(f), gemmRnb_(gemmRnb), threadsForGemmR_(threadsForGemmR)
+	{}
+
+	void operator()(const VectorOperatorStoragePtrType& v)
+	{
+		const SizeType n = v.size();
+		if (n == 0) return;
+
+		blocked_.resize(n, 0);
+		owned_.resize(n, 0);
+		PsimagLite::Parallelizer2<> parallelizer2(PsimagLite::Concurrency::codeSectionParams);
+		parallelizer2.parallelFor(0, n, [this, &v](SizeType i, SizeType) {
+			const bool inPlace = (!v[i]->justCRS() &&
+			                      v[i]->getBlocks().offsets() == this->f_.offsetsRows());
+			if (inPlace) {
+				this->blocked_[i] = &(v[i]->getBlocksNonConst());
+				return;
+			}
+
+			// all blocks dense, as they will be after the transformation
+			v[i]->toCRS();
+			this->owned_[i] = 1;
+			this->blocked_[i] = new OperatorBlocksType(v[i]->getCRS(),
+			                                           this->f_.offsetsRows(),
+			                                           0.0);
+		});
+
+		makeGroups();
+
+		PsimagLite::Parallelizer<ChangeOfBasisBatched,
+		        PsimagLite::LoadBalancerWeights> parallelizer(PsimagLite::Concurrency::
+		                                                      codeSectionParams);
+		parallelizer.loopCreate(*this, weights_);
+
+		parallelizer2.parallelFor(0, n, [this, &v](SizeType i, SizeType) {
+			this->blocked_[i]->transformOffsets(this->f_);
+			if (this->owned_[i]) {
+				this->blocked_[i]->toSparse(v[i]->getCRSNonConst());
+				delete this->blocked_[i];
+			}
+
+			this->blocked_[i] = 0;
+		});
+
+		owned_.clear();
+		groups_.clear();
+		weights_.clear();
+	}
+
+	SizeType tasks() const { return groups_.size(); }
+
+	void doTask(SizeType taskNumber, SizeType)
+	{
+		assert(taskNumber < groups_.size());
+		const Group& g = groups_[taskNumber];
+		const MatrixType& mLeft = f_(g.ipatch);
+		const MatrixType& mRight = f_(g.jpatch);
+		const SizeType k = g.ops.size();
+
+		if (mLeft.rows() == 0 || mRight.rows() == 0) {
+			for (SizeType p = 0; p < k; ++p)
+				block(g, p).clear();
+			return;
+		}
+
+		const SizeType r = mLeft.rows();
+		const SizeType c = mRight.rows();
+		const SizeType rNew = mLeft.cols();
+		const SizeType cNew = mRight.cols();
+
+		if (rNew == 0 || cNew == 0) {
+			for (SizeType p = 0; p < k; ++p) {
+				block(g, p).clear();
+				block(g, p).resize(rNew, cNew);
+			}
+
+			return;
+		}
+
+		static const bool needsPrinting = false;
+		PsimagLite::GemmR<ComplexOrRealType> gemmR(needsPrinting, gemmRnb_, threadsForGemmR_);
+
+		// the k blocks one below the other
+		MatrixType a(k*r, c);
+		for (SizeType p = 0; p < k; ++p) {
+			const OperatorBlocksType& blocks = *blocked_[g.ops[p]];
+			if (!blocks.isDense(g.ipatch, g.jpatch)) {
+				const SparseMatrixType& m = blocks.sparse(g.ipatch, g.jpatch);
+				assert(m.rows() == r && m.cols() == c);
+				for (SizeType i = 0; i < r; ++i)
+					for (int kk = m.getRowPtr(i); kk < m.getRowPtr(i + 1); ++kk)
+						a(i + p*r, m.getCol(kk)) = m.getValue(kk);
+				continue;
+			}
+
+			const MatrixType& m = blocks.dense(g.ipatch, g.jpatch);
+			assert(m.rows() == r && m.cols() == c);
+			for (SizeType j = 0; j < c; ++j)
+				for (SizeType i = 0; i < r; ++i)
+					a(i + p*r, j) = m(i, j);
+		}
+
+		// tmp = a * mRight
+		MatrixType tmp(k*r, cNew);
+		gemmR('N',
+		      'N',
+		      k*r,
+		      cNew,
+		      c,
+		      1.0,
+		      &(a(0, 0)),
+		      a.rows(),
+		      &(mRight(0, 0)),
+		      mRight.rows(),
+		      0.0,
+		      &(tmp(0, 0)),
+		      tmp.rows());
+
+		// the k blocks of tmp one next to the other
+		MatrixType b(r, k*cNew);
+		for (SizeType p = 0; p < k; ++p)
+			for (SizeType j = 0; j < cNew; ++j)
+				for (SizeType i = 0; i < r; ++i)
+					b(i, j + p*cNew) = tmp(i + p*r, j);
+
+		// result = transposeConjugate(mLeft) * b
+		MatrixType result(rNew, k*cNew);
+		gemmR('C',
+		      'N',
+		      rNew,
+		      k*cNew,
+		      r,
+		      1.0,
+		      &(mLeft(0, 0)),
+		      mLeft.rows(),
+		      &(b(0, 0)),
+		      b.rows(),
+		      0.0,
+		      &(result(0, 0)),
+		      result.rows());
+
+		for (SizeType p = 0; p < k; ++p) {
+			MatrixType& m = block(g, p);
+			m.clear();
+			m.resize(rNew, cNew);
+			for (SizeType j = 0; j < cNew; ++j)
+				for (SizeType i = 0; i < rNew; ++i)
+					m(i, j) = result(i, j + p*cNew);
+		}
+	}
+
+private:
+
+	// groups the blocks of all operators by pair of patches
+	void makeGroups()
+	{
+		assert(blocked_.size() > 0);
+		const SizeType np = blocked_[0]->patches();
+		PsimagLite::Matrix<int> index(np, np);
+		index.setTo(-1);
+		for (SizeType o = 0; o < blocked_.size(); ++o) {
+			assert(blocked_[o]->patches() == np);
+			for (SizeType jpatch = 0; jpatch < np; ++jpatch) {
+				for (SizeType ipatch = 0; ipatch < np; ++ipatch) {
+					if (!blocked_[o]->hasBlock(ipatch, jpatch)) continue;
+					if (index(ipatch, jpatch) < 0) {
+						index(ipatch, jpatch) = groups_.size();
+						groups_.push_back(Group(ipatch, jpatch));
+					}
+
+					groups_[index(ipatch, jpatch)].ops.push_back(o);
+				}
+			}
+		}
+
+		weights_.resize(groups_.size());
+		for (SizeType i = 0; i < groups_.size(); ++i) {
+			const Group& g = groups_[i];
+			const MatrixType& mLeft = f_(g.ipatch);
+			const MatrixType& mRight = f_(g.jpatch);
+			weights_[i] = 1 + g.ops.size()*mLeft.rows()*mRight.cols()*
+			        (mRight.rows() + mLeft.cols());
+		}
+	}
+
+	// the block as a dense matrix, see OperatorBlocks::dense()
+	MatrixType& block(const Group& g, SizeType p)
+	{
+		assert(p < g.ops.size());
+		return blocked_[g.ops[p]]->dense(g.ipatch, g.jpatch);
+	}
+
+	const BlockDiagonalMatrixType& f_;
+	SizeType gemmRnb_;
+	SizeType threadsForGemmR_;
+	VectorOperatorBlocksType blocked_;
+	VectorSizeType owned_;
+	VectorGroupType groups_;
+	VectorSizeType weights_;
+}; // class ChangeOfBasisBatched
+} // namespace Dmrg
+#endif // CHANGEOFBASISBATCHED_H
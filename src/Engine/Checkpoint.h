@@ -87,6 +87,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "ProgramGlobals.h"
 #include "Io/IoSelector.h"
 #include "DiskOrMemoryStack.h"
+#include "Hdf5ThreadSafe.h"
 
 namespace Dmrg {
 
@@ -122,6 +123,7 @@ public:
 	    parameters_(parameters),
 	    isObserveCode_(isObserveCode),
 	    isRestart_(parameters_.options.isSet("restart")),
+	    prefetchStacks_(parameters_.options.isSet("PrefetchStacksOnDisk")),
 	    systemStack_(parameters_.options.isSet("shrinkStacksOnDisk"),
 	                 parameters_.filename,
 	                 "system",
@@ -139,6 +141,10 @@ public:
 
 		if (parameters_.autoRestart) isRestart_ = true;
 
+#ifdef USE_PTHREADS
+		if (prefetchStacks_) checkHdf5ThreadSafe("PrefetchStacksOnDisk");
+#endif
+
 		SizeType site = 0; // FIXME for Immm model, find max of hilbert(site) over site
 		SizeType hilbertOneSite = model.hilbertSize(site);
 		if (parameters_.keptStatesInfinite > 0 &&
@@ -312,6 +318,13 @@ public:
 		else systemStack_.push(pSorE);
 	}
 
+	// stacks on disk push with asyncWriter, see AsyncWrite in SolverOptions
+	void setAsyncWriter(AsyncWriter* asyncWriter)
+	{
+		systemStack_.setAsyncWriter(asyncWriter);
+		envStack_.setAsyncWriter(asyncWriter);
+	}
+
 	BasisWithOperatorsType& shrink(typename ProgramGlobals::SysOrEnvEnum what)
 	{
 		return (what == ProgramGlobals::SysOrEnvEnum::ENVIRON) ? shrinkInternal(envStack_) :
@@ -480,6 +493,7 @@ private:
 		thisStack.pop();
 		assert(thisStack.size() > 0);
 		dummyBwo_ =  thisStack.top();
+		if (prefetchStacks_) thisStack.prefetch();
 		return dummyBwo_;
 	}
 
@@ -536,6 +550,7 @@ private:
 	const ParametersType& parameters_;
 	bool isObserveCode_;
 	bool isRestart_;
+	bool prefetchStacks_;
 	DiskOrMemoryStackType systemStack_;
 	DiskOrMemoryStackType envStack_;
 	PsimagLite::ProgressIndicator progress_;
@@ -20,8 +20,9 @@ public:
 
 	CorrectionVectorActionBase(const TargetParamsType& tstStruct,
 	                           RealType E0,
-	                           const VectorRealType& eigs)
-	    : tstStruct_(tstStruct),E0_(E0),eigs_(eigs)
+	                           const VectorRealType& eigs,
+	                           RealType omega)
+	    : tstStruct_(tstStruct),E0_(E0),eigs_(eigs),omega_(omega)
 	{
 		if (tstStruct_.omega().first == PsimagLite::FREQ_REAL)
 			return; // <--- EARLY EXIT
@@ -44,7 +45,7 @@ protected:
 	RealType actionWhenMatsubara(SizeType k) const
 	{
 		RealType sign = (tstStruct_.type() == 0) ? -1.0 : 1.0;
-		RealType wn = tstStruct_.omega().second;
+		RealType wn = omega_;
 		RealType part1 =  (eigs_[k] - E0_)*sign;
 		RealType denom = part1*part1 + wn*wn;
 		return (action_ == ACTION_IMAG) ? wn/denom : -part1 / denom;
@@ -53,6 +54,7 @@ protected:
 	const TargetParamsType& tstStruct_;
 	RealType E0_;
 	const VectorRealType& eigs_;
+	RealType omega_;
 	mutable ActionEnum action_;
 };
 
@@ -72,8 +74,9 @@ public:
 
 	CorrectionVectorAction(const TargetParamsType& tstStruct,
 	                       RealType E0,
-	                       const typename BaseType::VectorRealType& eigs)
-	    : BaseType(tstStruct, E0, eigs) {}
+	                       const typename BaseType::VectorRealType& eigs,
+	                       RealType omega)
+	    : BaseType(tstStruct, E0, eigs, omega) {}
 
 	ComplexOrRealType operator()(SizeType k) const
 	{
@@ -91,7 +94,7 @@ private:
 	ComplexOrRealType actionWhenFreqReal(SizeType k) const
 	{
 		RealType sign = (BaseType::tstStruct_.type() == 0) ? -1.0 : 1.0;
-		RealType part1 =  (BaseType::eigs_[k] - BaseType::E0_)*sign + BaseType::tstStruct_.omega().second;
+		RealType part1 =  (BaseType::eigs_[k] - BaseType::E0_)*sign + BaseType::omega_;
 		RealType denom = part1*part1 + BaseType::tstStruct_.eta()*BaseType::tstStruct_.eta();
 		return (BaseType::action_ == BaseType::ACTION_IMAG) ? BaseType::tstStruct_.eta()/denom :
 		                                                      -part1/denom;
@@ -110,8 +113,9 @@ public:
 
 	CorrectionVectorAction(const TargetParamsType& tstStruct,
 	                       RealType E0,
-	                       const typename BaseType::VectorRealType& eigs)
-	    : BaseType(tstStruct, E0, eigs)
+	                       const typename BaseType::VectorRealType& eigs,
+	                       RealType omega)
+	    : BaseType(tstStruct, E0, eigs, omega)
 	{
 		std::cout<<PsimagLite::AnsiColor::red;
 		std::cerr<<PsimagLite::AnsiColor::red;
@@ -138,7 +142,7 @@ private:
 	{
 		RealType sign = (BaseType::tstStruct_.type() == 0) ? -1.0 : 1.0;
 		RealType part1 =  (BaseType::eigs_[k] - BaseType::E0_)*sign +
-		        BaseType::tstStruct_.omega().second;
+		        BaseType::omega_;
 		RealType denom = part1*part1 + BaseType::tstStruct_.eta()*BaseType::tstStruct_.eta();
 
 		return ComplexOrRealType(part1/denom, -BaseType::tstStruct_.eta()/denom);
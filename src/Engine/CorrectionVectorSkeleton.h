@@ -87,7 +87,6 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "ParametersForSolver.h"
 #include "ParallelTriDiag.h"
 #include "FreqEnum.h"
-#include "NoPthreadsNg.h"
 #include "TridiagRixsStatic.h"
 #include "KrylovHelper.h"
 #include "CorrectionVectorAction.h"
@@ -142,6 +141,8 @@ public:
 	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
 	typedef typename PsimagLite::Vector<VectorRealType>::Type VectorVectorRealType;
 	typedef typename ModelType::InputValidatorType InputValidatorType;
+	typedef typename PsimagLite::Vector<VectorWithOffsetType*>::Type
+	VectorVectorWithOffsetPointerType;
 
 	class CalcR {
 
@@ -149,8 +150,11 @@ public:
 
 		typedef CorrectionVectorAction<ComplexOrRealType, TargetParamsType> ActionType;
 
-		CalcR(const TargetParamsType& tstStruct, RealType E0, const VectorRealType& eigs)
-		    : action_(tstStruct,E0,eigs)
+		CalcR(const TargetParamsType& tstStruct,
+		      RealType E0,
+		      const VectorRealType& eigs,
+		      RealType omega)
+		    : action_(tstStruct,E0,eigs,omega)
 		{}
 
 		const ActionType& imag() const
@@ -197,44 +201,38 @@ public:
 	                    VectorWithOffsetType& tv1,
 	                    VectorWithOffsetType& tv2)
 	{
-		const VectorWithOffsetType& phi = tv0;
-		tv1 = tv2 = phi;
+		const VectorRealType omegas(1, tstStruct_.omega().second);
+		const VectorVectorWithOffsetPointerType xis(1, &tv1);
+		const VectorVectorWithOffsetPointerType xrs(1, &tv2);
+		calcDynVectors(tv0, omegas, xis, xrs);
+	}
 
+	// The correction vectors of phi for each of the omegas, with the
+	// tridiagonalization of each sector done only once, because it does not
+	// depend on omega; xi and xr of omegas[w] go to xis[w] and xrs[w]
+	void calcDynVectors(const VectorWithOffsetType& phi,
+	                    const VectorRealType& omegas,
+	                    const VectorVectorWithOffsetPointerType& xis,
+	                    const VectorVectorWithOffsetPointerType& xrs)
+	{
 		VectorMatrixFieldType V(phi.sectors());
 		VectorMatrixFieldType T(phi.sectors());
-
 		VectorSizeType steps(phi.sectors());
 
-		triDiag(phi,T,V,steps);
-
-		VectorVectorRealType eigs(phi.sectors());
-
-		for (SizeType ii = 0;ii < phi.sectors(); ++ii)
-			PsimagLite::diag(T[ii],eigs[ii],'V');
-
-		for (SizeType i=0;i<phi.sectors();i++) {
-			VectorType sv;
-			SizeType i0 = phi.sector(i);
-			tv0.extract(sv,i0);
-			// g.s. is included separately
-			// set Aq
-			//tv0.setDataInSector(sv,i0);
-			// set xi
-			SizeType p = lrs_.super().findPartitionNumber(phi.offset(i0));
-			VectorType xi(sv.size(),0),xr(sv.size(),0);
-
-			if (tstStruct_.algorithm() == TargetParamsType::BaseType::AlgorithmEnum::KRYLOV) {
-				computeXiAndXrKrylov(xi,xr,phi,i0,V[i],T[i],eigs[i],steps[i]);
-			} else {
-				computeXiAndXrIndirect(xi,xr,sv,p);
-			}
-
-			tv1.setDataInSector(xi,i0);
-			//set xr
-			tv2.setDataInSector(xr,i0);
+		if (isKrylov()) {
+			const RealType fakeTime = 0;
+			ParallelTriDiagType helperTriDiag(phi,
+			                                  T,
+			                                  V,
+			                                  steps,
+			                                  lrs_,
+			                                  fakeTime,
+			                                  model_,
+			                                  ioIn_);
+			helperTriDiag.run();
 		}
 
-		weightForContinuedFraction_ = PsimagLite::real(phi*phi);
+		calcDynVectors(phi, omegas, xis, xrs, T, V, steps);
 	}
 
 	void calcDynVectors(const VectorWithOffsetType& tv0,
@@ -243,15 +241,106 @@ public:
 	                    VectorWithOffsetType& tv3)
 	{
 		VectorWithOffsetType tv4;
-		calcDynVectors(tv0,tv4,tv2);
 		VectorWithOffsetType tv5;
-		calcDynVectors(tv1,tv5,tv3);
+
+		if (!isKrylov()) {
+			calcDynVectors(tv0,tv4,tv2);
+			calcDynVectors(tv1,tv5,tv3);
+			tv2 += tv5;
+			tv3 += (-1.0)*tv4;
+			return;
+		}
+
+		// the Lanczos processes of tv0 and of tv1 are independent,
+		// and can run concurrently, see ParallelTriDiag
+		VectorMatrixFieldType V0(tv0.sectors());
+		VectorMatrixFieldType T0(tv0.sectors());
+		VectorSizeType steps0(tv0.sectors());
+		VectorMatrixFieldType V1(tv1.sectors());
+		VectorMatrixFieldType T1(tv1.sectors());
+		VectorSizeType steps1(tv1.sectors());
+
+		const RealType fakeTime = 0;
+		ParallelTriDiagType helperTriDiag(lrs_, fakeTime, model_, ioIn_);
+		helperTriDiag.add(tv0, T0, V0, steps0);
+		helperTriDiag.add(tv1, T1, V1, steps1);
+		helperTriDiag.run();
+
+		const VectorRealType omegas(1, tstStruct_.omega().second);
+		calcDynVectors(tv0,
+		               omegas,
+		               VectorVectorWithOffsetPointerType(1, &tv4),
+		               VectorVectorWithOffsetPointerType(1, &tv2),
+		               T0,
+		               V0,
+		               steps0);
+		calcDynVectors(tv1,
+		               omegas,
+		               VectorVectorWithOffsetPointerType(1, &tv5),
+		               VectorVectorWithOffsetPointerType(1, &tv3),
+		               T1,
+		               V1,
+		               steps1);
 		tv2 += tv5;
 		tv3 += (-1.0)*tv4;
 	}
 
 private:
 
+	bool isKrylov() const
+	{
+		return (tstStruct_.algorithm() == TargetParamsType::BaseType::AlgorithmEnum::KRYLOV);
+	}
+
+	// T, V, and steps are the tridiagonalization of phi if isKrylov(),
+	// and are unused otherwise; T is overwritten by its eigenvectors
+	void calcDynVectors(const VectorWithOffsetType& phi,
+	                    const VectorRealType& omegas,
+	                    const VectorVectorWithOffsetPointerType& xis,
+	                    const VectorVectorWithOffsetPointerType& xrs,
+	                    VectorMatrixFieldType& T,
+	                    const VectorMatrixFieldType& V,
+	                    const VectorSizeType& steps)
+	{
+		const SizeType nomegas = omegas.size();
+		assert(xis.size() == nomegas && xrs.size() == nomegas);
+		for (SizeType w = 0; w < nomegas; ++w)
+			*(xis[w]) = *(xrs[w]) = phi;
+
+		const bool isKrylov = this->isKrylov();
+		if (!isKrylov && nomegas != 1)
+			err("CorrectionVectorSkeleton: many omegas only with KRYLOV\n");
+
+		VectorVectorRealType eigs(phi.sectors());
+
+		if (isKrylov) {
+			for (SizeType ii = 0;ii < phi.sectors(); ++ii)
+				PsimagLite::diag(T[ii],eigs[ii],'V');
+		}
+
+		for (SizeType i=0;i<phi.sectors();i++) {
+			VectorType sv;
+			SizeType i0 = phi.sector(i);
+			phi.extract(sv,i0);
+			// g.s. is included separately
+			SizeType p = lrs_.super().findPartitionNumber(phi.offset(i0));
+			VectorType xi(sv.size(),0),xr(sv.size(),0);
+
+			for (SizeType w = 0; w < nomegas; ++w) {
+				if (isKrylov) {
+					computeXiAndXrKrylov(xi,xr,phi,i0,V[i],T[i],eigs[i],steps[i],omegas[w]);
+				} else {
+					computeXiAndXrIndirect(xi,xr,sv,p);
+				}
+
+				xis[w]->setDataInSector(xi,i0);
+				xrs[w]->setDataInSector(xr,i0);
+			}
+		}
+
+		weightForContinuedFraction_ = PsimagLite::real(phi*phi);
+	}
+
 	void computeXiAndXrIndirect(VectorType& xi,
 	                            VectorType& xr,
 	                            const VectorType& sv,
@@ -285,7 +374,8 @@ private:
 	                          const MatrixComplexOrRealType& V,
 	                          const MatrixComplexOrRealType& T,
 	                          const VectorRealType& eigs,
-	                          SizeType steps)
+	                          SizeType steps,
+	                          RealType omega)
 	{
 		SizeType n2 = steps;
 		SizeType n = V.n_row();
@@ -297,7 +387,7 @@ private:
 
 		TargetVectorType tmp(n2);
 		VectorType r(n2);
-		CalcR what(tstStruct_, energy_, eigs);
+		CalcR what(tstStruct_, energy_, eigs, omega);
 
 		krylovHelper_.calcR(r, what.imag(), T, V, phi, n2, i0);
 
@@ -316,27 +406,6 @@ private:
 		psimag::BLAS::GEMV('N',n,n2,zone,&(V(0,0)),n,&(tmp[0]),1,zzero,&(xr[0]),1);
 	}
 
-	void triDiag(const VectorWithOffsetType& phi,
-	             VectorMatrixFieldType& T,
-	             VectorMatrixFieldType& V,
-	             VectorSizeType& steps)
-	{
-		RealType fakeTime = 0;
-		typedef PsimagLite::NoPthreadsNg<ParallelTriDiagType> ParallelizerType;
-		ParallelizerType threadedTriDiag(PsimagLite::CodeSectionParams(1));
-
-		ParallelTriDiagType helperTriDiag(phi,
-		                                  T,
-		                                  V,
-		                                  steps,
-		                                  lrs_,
-		                                  fakeTime,
-		                                  model_,
-		                                  ioIn_);
-
-		threadedTriDiag.loopCreate(helperTriDiag);
-	}
-
 	RealType dynWeightOf(VectorType& v,const VectorType& w) const
 	{
 		RealType sum = 0;
@@ -129,21 +129,35 @@ public:
 	{
 		Odest =Osrc;
 		// from 0 --> i
-		int nt=i-1;
-		if (nt<0) nt=0;
+		for (SizeType s = growStart(i); s < ns; ++s)
+			growByOneSite(Odest, i, fermionicSign, s, (transform || s + 1 < ns));
+	}
 
-		for (SizeType s = nt; s < ns; ++s) {
-			const GrowDirection growOption = growthDirection(s, nt, i, s);
-			SparseMatrixType Onew(helper_.cols(s),helper_.cols(s));
+	// the first s of growDirectly(..., i, ...)
+	static SizeType growStart(SizeType i)
+	{
+		return (i == 0) ? 0 : i - 1;
+	}
 
-			fluffUp(Onew, Odest, fermionicSign, growOption, false, s);
-			if (!transform && s == ns - 1) {
-				Odest = Onew;
-				continue;
-			}
+	// one step s of growDirectly(Odest, Osrc, i, ...), so that the grown
+	// operator can be carried from one ns to the next, see TwoPointCorrelations
+	void growByOneSite(SparseMatrixType& Odest,
+	                   SizeType i,
+	                   ProgramGlobals::FermionOrBosonEnum fermionicSign,
+	                   SizeType s,
+	                   bool transform) const
+	{
+		const int nt = growStart(i);
+		const GrowDirection growOption = growthDirection(s, nt, i, s);
+		SparseMatrixType Onew(helper_.cols(s),helper_.cols(s));
 
-			helper_.transform(Odest, Onew, s);
+		fluffUp(Onew, Odest, fermionicSign, growOption, false, s);
+		if (!transform) {
+			Odest = Onew;
+			return;
 		}
+
+		helper_.transform(Odest, Onew, s);
 	}
 
 	GrowDirection growthDirection(SizeType s,
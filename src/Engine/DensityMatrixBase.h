@@ -104,12 +104,18 @@ public:
 		       ProgramGlobals::DirectionEnum d,
 		       bool de,
 		       bool enablePersistentSvd_,
-		       bool serialSvd_)
+		       bool serialSvd_,
+		       bool truncatedSvd_ = false,
+		       SizeType keptStates_ = 0,
+		       bool twoLevelSvd_ = false)
 		    : useSvd(u),
 		      direction(d),
 		      debug(de),
 		      enablePersistentSvd(enablePersistentSvd_),
-		      serialSvd(serialSvd_)
+		      serialSvd(serialSvd_),
+		      truncatedSvd(truncatedSvd_),
+		      keptStates(keptStates_),
+		      twoLevelSvd(twoLevelSvd_)
 		{}
 
 		bool useSvd;
@@ -117,6 +123,9 @@ public:
 		bool debug;
 		bool enablePersistentSvd;
 		bool serialSvd;
+		bool truncatedSvd;
+		SizeType keptStates;
+		bool twoLevelSvd;
 	};
 
 	typedef typename BlockDiagonalMatrixType::BuildingBlockType BuildingBlockType;
@@ -118,7 +118,8 @@ public:
 	      data_((p.direction == ProgramGlobals::DirectionEnum::EXPAND_SYSTEM) ? lrs.left() :
 	                                                                            lrs.right()),
 	      direction_(p.direction),
-	      debug_(p.debug)
+	      debug_(p.debug),
+	      twoLevel_(p.twoLevelSvd && !p.serialSvd)
 	{
 		{
 			PsimagLite::OstringStream msgg(std::cout.precision());
@@ -203,7 +204,13 @@ public:
 
 	void diag(typename PsimagLite::Vector<RealType>::Type& eigs,char jobz)
 	{
-		DiagBlockDiagMatrix<BlockDiagonalMatrixType>::diagonalise(data_,eigs,jobz);
+		// in parallel only if asked for, see TwoLevelSvd
+		SizeType threads = (twoLevel_) ? ConcurrencyType::codeSectionParams.npthreads : 1;
+		DiagBlockDiagMatrix<BlockDiagonalMatrixType>::diagonalise(data_,
+		                                                          eigs,
+		                                                          jobz,
+		                                                          threads,
+		                                                          twoLevel_);
 	}
 
 	friend std::ostream& operator<<(std::ostream& os,
@@ -246,6 +253,7 @@ private:
 	BlockDiagonalMatrixType data_;
 	ProgramGlobals::DirectionEnum direction_;
 	bool debug_;
+	bool twoLevel_;
 }; // class DensityMatrixLocal
 
 } // namespace Dmrg
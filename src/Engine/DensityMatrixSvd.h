@@ -78,6 +78,11 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "MatrixVectorKron/GenIjPatch.h"
 #include "PersistentSvd.h"
 #include "Svd.h"
+#include "TruncatedSvd.h"
+#include "BlockSchedule.h"
+#include <numeric>
+#include <functional>
+#include <cmath>
 
 namespace Dmrg {
 
@@ -324,9 +329,9 @@ class DensityMatrixSvd : public DensityMatrixBase<TargetingType> {
 					assert(!expandSys || (i < nl && j < lrs_.right().size()));
 					assert(expandSys || (j < nl && i < lrs_.right().size()));
 
-					assert(ij < lrs_.super().permutationInverse().size());
+					assert(ij < lrs_.super().permutationSize());
 
-					SizeType r = lrs_.super().permutationInverse()[ij];
+					SizeType r = lrs_.super().permutationInverse(ij);
 					if (r < offset || r >= offset + v_.effectiveSize(m))
 						continue;
 
@@ -353,6 +358,8 @@ class DensityMatrixSvd : public DensityMatrixBase<TargetingType> {
 
 	class ParallelSvd {
 
+		static const SizeType RANK_MARGIN = 2;
+
 	public:
 
 		typedef PersistentSvd<typename PsimagLite::Vector<MatrixType>::Type,
@@ -362,18 +369,34 @@ class DensityMatrixSvd : public DensityMatrixBase<TargetingType> {
 		ParallelSvd(BlockDiagonalMatrixType& blockDiagonalMatrix,
 		            GroupsStructType& allTargets,
 		            VectorRealType& eigs,
-		            PersistentSvdType& additionalStorage)
+		            PersistentSvdType& additionalStorage,
+		            SizeType truncatedStates)
 		    : blockDiagonalMatrix_(blockDiagonalMatrix),
 		      allTargets_(allTargets),
 		      eigs_(eigs),
-		      persistentSvd_(additionalStorage)
+		      persistentSvd_(additionalStorage),
+		      truncatedStates_(truncatedStates),
+		      truncated_(allTargets.size(), 0),
+		      ranks_(allTargets.size(), 0),
+		      smallest_(allTargets.size(), 0.0),
+		      tasks_(allTargets.size())
 		{
 			SizeType oneSide = allTargets.basis().size();
 			eigs_.resize(oneSide);
 			std::fill(eigs_.begin(), eigs_.end(), 0.0);
+			for (SizeType i = 0; i < tasks_.size(); ++i)
+				tasks_[i] = i;
+
+			distributeRanks();
 		}
 
-		void doTask(SizeType ipatch, SizeType)
+		void doTask(SizeType taskNumber, SizeType)
+		{
+			assert(taskNumber < tasks_.size());
+			doBlock(tasks_[taskNumber]);
+		}
+
+		void doBlock(SizeType ipatch)
 		{
 			SizeType igroup = allTargets_.groupFromIndex(ipatch);
 			MatrixType& m = allTargets_.matrix(igroup);
@@ -381,8 +404,16 @@ class DensityMatrixSvd : public DensityMatrixBase<TargetingType> {
 			MatrixType& vt = persistentSvd_.vts(igroup);
 			VectorRealType& eigsOnePatch = persistentSvd_.s(igroup);
 
-			PsimagLite::Svd<ComplexOrRealType> svd;
-			svd('A', m, eigsOnePatch, vt);
+			const SizeType k = ranks_[ipatch];
+			TruncatedSvd<ComplexOrRealType> truncatedSvd(1234 + igroup);
+			truncated_[ipatch] = (truncatedSvd(m, eigsOnePatch, vt, k)) ? 1 : 0;
+			if (truncated_[ipatch]) {
+				assert(k > 0 && k <= eigsOnePatch.size());
+				smallest_[ipatch] = eigsOnePatch[k - 1]*eigsOnePatch[k - 1];
+			} else {
+				PsimagLite::Svd<ComplexOrRealType> svd;
+				svd('A', m, eigsOnePatch, vt);
+			}
 
 			persistentSvd_.qns(igroup) = allTargets_.basis().qnEx(igroup);
 			const BasisType& basis = allTargets_.basis();
@@ -400,18 +431,97 @@ class DensityMatrixSvd : public DensityMatrixBase<TargetingType> {
 
 		SizeType tasks() const
 		{
-			return allTargets_.size();
+			return tasks_.size();
+		}
+
+		void setTasks(const VectorSizeType& tasks) { tasks_ = tasks; }
+
+		// flops of the svd of each group, up to a constant, see BlockSchedule
+		BlockSchedule::VectorDoubleType costs() const
+		{
+			BlockSchedule::VectorDoubleType c(allTargets_.size());
+			for (SizeType ipatch = 0; ipatch < c.size(); ++ipatch) {
+				const MatrixType& m = allTargets_.matrix(allTargets_.groupFromIndex(ipatch));
+				c[ipatch] = static_cast<double>(m.rows())*m.cols()*std::min(m.rows(), m.cols());
+			}
+
+			return c;
 		}
 
 		// needed for WFT
 		const PersistentSvdType& additionalStorage() const { return persistentSvd_; }
 
+		SizeType truncatedGroups() const
+		{
+			return std::accumulate(truncated_.begin(), truncated_.end(), 0);
+		}
+
+		// A truncated group whose smallest computed eigenvalue would still be kept
+		// may have more states above the cut, so it is decomposed again in full.
+		// Returns the number of such groups
+		SizeType redoTruncatedAboveCut()
+		{
+			if (truncatedStates_ == 0 || truncatedStates_ >= eigs_.size()) return 0;
+
+			VectorRealType sorted = eigs_;
+			std::nth_element(sorted.begin(),
+			                 sorted.begin() + truncatedStates_ - 1,
+			                 sorted.end(),
+			                 std::greater<RealType>());
+			const RealType cut = sorted[truncatedStates_ - 1];
+
+			SizeType redone = 0;
+			for (SizeType ipatch = 0; ipatch < truncated_.size(); ++ipatch) {
+				if (!truncated_[ipatch] || smallest_[ipatch] < cut) continue;
+				ranks_[ipatch] = 0;
+				doBlock(ipatch);
+				++redone;
+			}
+
+			return redone;
+		}
+
 	private:
 
+		// The states kept in total are shared among the groups in proportion to
+		// min(rows, cols) of each, with a margin of RANK_MARGIN, so that the rank
+		// of each truncated SVD is a fraction of its group, not keptStates
+		void distributeRanks()
+		{
+			if (truncatedStates_ == 0) return;
+
+			const SizeType n = ranks_.size();
+			double total = 0;
+			for (SizeType ipatch = 0; ipatch < n; ++ipatch)
+				total += fullRank(ipatch);
+
+			if (total == 0) return;
+
+			for (SizeType ipatch = 0; ipatch < n; ++ipatch) {
+				const SizeType full = fullRank(ipatch);
+				const double share = RANK_MARGIN*truncatedStates_*full/total;
+				SizeType k = static_cast<SizeType>(std::ceil(share));
+				if (k > full) k = full;
+				if (k > truncatedStates_) k = truncatedStates_;
+				ranks_[ipatch] = k;
+			}
+		}
+
+		SizeType fullRank(SizeType ipatch) const
+		{
+			const MatrixType& m = allTargets_.matrix(allTargets_.groupFromIndex(ipatch));
+			return std::min(m.rows(), m.cols());
+		}
+
 		BlockDiagonalMatrixType& blockDiagonalMatrix_;
 		GroupsStructType& allTargets_;
 		VectorRealType& eigs_;
 		PersistentSvdType persistentSvd_;
+		SizeType truncatedStates_;
+		VectorSizeType truncated_;
+		VectorSizeType ranks_;
+		VectorRealType smallest_;
+		VectorSizeType tasks_;
 	};
 
 public:
@@ -488,23 +598,32 @@ public:
 	{
 		PsimagLite::Profiling profiling("DensityMatrixSvdDiag", std::cout);
 
-		typedef PsimagLite::Parallelizer<ParallelSvd> ParallelizerType;
-
-		PsimagLite::CodeSectionParams csp = PsimagLite::Concurrency::codeSectionParams;
+		SizeType threads = PsimagLite::Concurrency::codeSectionParams.npthreads;
 
 		if (params_.serialSvd) {
-			csp.npthreads = 1;
+			threads = 1;
 			std::cout<<"DensityMatrixSvd: SerialSvd in force\n";
 		}
 
-		ParallelizerType threaded(csp);
+		// the WFT needs all of vt, so TruncatedSvd is ignored with EnablePersistentSvd
+		const SizeType truncatedStates = (params_.truncatedSvd && !params_.enablePersistentSvd)
+		        ? params_.keptStates : 0;
 
 		ParallelSvd parallelSvd(data_,
 		                        allTargets_,
 		                        eigs,
-		                        persistentSvd_);
-
-		threaded.loopCreate(parallelSvd);
+		                        persistentSvd_,
+		                        truncatedStates);
+
+		BlockSchedule blockSchedule(parallelSvd.costs(), threads, params_.twoLevelSvd);
+		blockSchedule.run(parallelSvd);
+		const SizeType redone = parallelSvd.redoTruncatedAboveCut();
+		if (truncatedStates > 0) {
+			++svdCalls_;
+			svdGroups_ += allTargets_.size();
+			svdTruncated_ += parallelSvd.truncatedGroups();
+			svdRedone_ += redone;
+		}
 
 		for (SizeType i = 0; i < data_.blocks(); ++i) {
 			SizeType n = data_(i).rows();
@@ -521,6 +640,20 @@ public:
 		data_.enforcePhase();
 		if (!params_.enablePersistentSvd)
 			persistentSvd_.clear();
+
+		if (truncatedStates == 0 && blockSchedule.largeBlocks() == 0) return;
+
+		PsimagLite::OstringStream msgg(std::cout.precision());
+		PsimagLite::OstringStream::OstringStreamType& msg = msgg();
+		msg<<allTargets_.size()<<" groups, "<<blockSchedule.largeBlocks()<<" done first";
+		if (truncatedStates > 0) {
+			msg<<"; TruncatedSvd for "<<parallelSvd.truncatedGroups();
+			msg<<", redone in full "<<redone<<", keeping at most "<<truncatedStates;
+			msg<<"; so far TruncatedSvd for "<<svdTruncated_<<" of "<<svdGroups_;
+			msg<<" groups in "<<svdCalls_<<" decompositions, redone "<<svdRedone_;
+		}
+
+		profiling.end(msg.str());
 	}
 
 	// needed for WFT
@@ -603,8 +736,25 @@ private:
 	GroupsStructType allTargets_;
 	BlockDiagonalMatrixType data_;
 	typename ParallelSvd::PersistentSvdType persistentSvd_;
+	// TruncatedSvd counts over the whole run, printed by diag
+	static SizeType svdCalls_;
+	static SizeType svdGroups_;
+	static SizeType svdTruncated_;
+	static SizeType svdRedone_;
 }; // class DensityMatrixSvd
 
+template<typename TargetingType>
+SizeType DensityMatrixSvd<TargetingType>::svdCalls_ = 0;
+
+template<typename TargetingType>
+SizeType DensityMatrixSvd<TargetingType>::svdGroups_ = 0;
+
+template<typename TargetingType>
+SizeType DensityMatrixSvd<TargetingType>::svdTruncated_ = 0;
+
+template<typename TargetingType>
+SizeType DensityMatrixSvd<TargetingType>::svdRedone_ = 0;
+
 } // namespace Dmrg
 
 #endif
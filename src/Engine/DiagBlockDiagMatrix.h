@@ -1,6 +1,7 @@
 #ifndef DIAGBLOCKDIAGMATRIX_H
 #define DIAGBLOCKDIAGMATRIX_H
 #include "EnforcePhase.h"
+#include "BlockSchedule.h"
 
 namespace Dmrg {
 
@@ -14,6 +15,7 @@ class DiagBlockDiagMatrix {
 	class LoopForDiag {
 
 		typedef PsimagLite::Concurrency ConcurrencyType;
+		typedef typename PsimagLite::Vector<SizeType>::Type VectorSizeType;
 
 	public:
 
@@ -24,24 +26,34 @@ class DiagBlockDiagMatrix {
 		      eigs(eigs1),
 		      option(option1),
 		      eigsForGather(C.blocks()),
-		      weights(C.blocks())
+		      weights(C.blocks()),
+		      tasks_(C.blocks())
 		{
 
 			for (SizeType m=0;m<C.blocks();m++) {
-				eigsForGather[m].resize(C.offsetsRows(m+1)-C.offsetsRows(m));
-				weights[m] =  C.offsetsRows(m+1)-C.offsetsRows(m);
+				SizeType n = C.offsetsRows(m+1)-C.offsetsRows(m);
+				eigsForGather[m].resize(n);
+				weights[m] = static_cast<double>(n)*n*n;
+				tasks_[m] = m;
 			}
 
 			assert(C.rows() == C.cols());
 			eigs.resize(C.rows());
 		}
 
-		SizeType tasks() const { return C.blocks(); }
+		SizeType tasks() const { return tasks_.size(); }
+
+		void setTasks(const VectorSizeType& tasks) { tasks_ = tasks; }
 
 		void doTask(SizeType taskNumber, SizeType)
+		{
+			assert(taskNumber < tasks_.size());
+			doBlock(tasks_[taskNumber]);
+		}
+
+		void doBlock(SizeType m)
 		{
 			assert(C.rows() == C.cols());
-			SizeType m = taskNumber;
 			VectorRealType eigsTmp;
 			C.diagAndEnforcePhase(m, eigsTmp, option);
 			for (SizeType j = C.offsetsRows(m); j < C.offsetsRows(m+1); ++j)
@@ -58,34 +70,40 @@ class DiagBlockDiagMatrix {
 			}
 		}
 
+		// cost of the diagonalization of each block, up to a constant
+		const BlockSchedule::VectorDoubleType& costs() const { return weights; }
+
 	private:
 
 		BlockDiagonalMatrixType& C;
 		VectorRealType& eigs;
 		char option;
 		typename PsimagLite::Vector<VectorRealType>::Type eigsForGather;
-		typename PsimagLite::Vector<SizeType>::Type weights;
+		BlockSchedule::VectorDoubleType weights;
+		VectorSizeType tasks_;
 	};
 
 public:
 
 	// Parallel version of the diagonalization of a block diagonal matrix
-	// Note: In reality, Parallelization is disabled here because a LAPACK call
+	// Note: threads is 1 by default because a LAPACK call
 	//        is needed and LAPACK is not necessarily thread safe.
+	// The largest blocks are started first, see BlockSchedule
 	// This function is NOT called by useSvd
 	static void diagonalise(BlockDiagonalMatrixType& C,
 	                        VectorRealType& eigs,
-	                        char option)
+	                        char option,
+	                        SizeType threads = 1,
+	                        bool twoLevel = false)
 	{
-		typedef PsimagLite::NoPthreadsNg<LoopForDiag> ParallelizerType;
 		typedef PsimagLite::Concurrency ConcurrencyType;
 		SizeType savedNpthreads = ConcurrencyType::codeSectionParams.npthreads;
 		ConcurrencyType::codeSectionParams.npthreads = 1;
-		ParallelizerType threadObject(ConcurrencyType::codeSectionParams);
 
 		LoopForDiag helper(C,eigs,option);
 
-		threadObject.loopCreate(helper); // FIXME: needs weights
+		BlockSchedule blockSchedule(helper.costs(), threads, twoLevel);
+		blockSchedule.run(helper);
 
 		helper.gather();
 
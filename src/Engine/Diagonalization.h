@@ -83,9 +83,15 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "ProgramGlobals.h"
 #include "LanczosSolver.h"
 #include "DavidsonSolver.h"
+#include "BlockLanczosSolver.h"
 #include "ParametersForSolver.h"
 #include "Concurrency.h"
+#include "Parallelizer.h"
+#include "LoadBalancerWeights.h"
+#include "NestedThreads.h"
 #include "Profiling.h"
+#include "Random48.h"
+#include <limits>
 
 namespace Dmrg {
 
@@ -126,8 +132,130 @@ public:
 	typedef PsimagLite::LanczosSolver<ParametersForSolverType,
 	MatrixVectorType,
 	TargetVectorType> LanczosSolverType;
+	typedef BlockLanczosSolver<ParametersForSolverType,
+	MatrixVectorType,
+	TargetVectorType> BlockLanczosSolverType;
 	typedef typename PsimagLite::Vector<TargetVectorType>::Type VectorVectorType;
 	typedef typename PsimagLite::Vector<VectorVectorType>::Type VectorVectorVectorType;
+	typedef PsimagLite::Concurrency ConcurrencyType;
+	typedef PsimagLite::Random48<RealType> RngType;
+
+private:
+
+	static const long int RANDOM_SEED = 1117323;
+	// mixed precision: a single precision solve is converged once its residuals are
+	// below FLOAT_RESIDUAL_FACTOR float epsilons of the energy scale, and is then
+	// refined in full precision with 1/REFINE_STEPS_DIVISOR of the steps
+	static const SizeType FLOAT_RESIDUAL_FACTOR = 100;
+	static const SizeType REFINE_STEPS_DIVISOR = 4;
+	static const SizeType MIN_REFINE_STEPS = 10;
+
+	// what one sector solve owns, so that sectors can be solved concurrently:
+	// the solver parameters, read once from the input before any solve, a
+	// random number generator seeded by sector, and the stream to print to
+	struct SolverContext {
+
+		SolverContext(const ParametersForSolverType& params_,
+		              SizeType sectorIndex,
+		              std::ostream& os_)
+		    : params(params_),
+		      seed(RANDOM_SEED + sectorIndex),
+		      rng(seed),
+		      os(os_)
+		{}
+
+		const ParametersForSolverType& params;
+		long int seed;
+		RngType rng;
+		std::ostream& os;
+	};
+
+	// Diagonalizes independent symmetry sectors concurrently;
+	// each solve uses ThreadsLevelTwo= threads, see NestedThreads
+	class ParallelSectors {
+
+	public:
+
+		ParallelSectors(Diagonalization& diag,
+		                const VectorSizeType& sectors,
+		                const LeftRightSuperType& lrs,
+		                RealType targetTime,
+		                const VectorVectorType& initialVectors,
+		                VectorVectorVectorType& vecSaved,
+		                const ParametersForSolverType& params,
+		                SizeType loopIndex)
+		    : diag_(diag),
+		      sectors_(sectors),
+		      lrs_(lrs),
+		      targetTime_(targetTime),
+		      initialVectors_(initialVectors),
+		      vecSaved_(vecSaved),
+		      params_(params),
+		      loopIndex_(loopIndex),
+		      energies_(sectors.size()),
+		      millis_(sectors.size(), 0),
+		      outputs_(sectors.size())
+		{}
+
+		SizeType tasks() const { return sectors_.size(); }
+
+		void doTask(SizeType j, SizeType)
+		{
+			const PsimagLite::MemoryUsage::TimeHandle time1 =
+			        PsimagLite::ProgressIndicator::time();
+
+			// printed by the calling thread after the loop, in sector order
+			PsimagLite::OstringStream out(std::cout.precision());
+			SolverContext context(params_, j, out());
+			diag_.diagonaliseOneBlock(energies_[j],
+			                          vecSaved_[j],
+			                          sectors_[j],
+			                          lrs_,
+			                          targetTime_,
+			                          initialVectors_[j],
+			                          loopIndex_,
+			                          context);
+
+			const PsimagLite::MemoryUsage::TimeHandle time2 =
+			        PsimagLite::ProgressIndicator::time();
+			millis_[j] = (time2 - time1).millis();
+			outputs_[j] = out().str();
+		}
+
+		const VectorRealType& energies(SizeType j) const
+		{
+			assert(j < energies_.size());
+			return energies_[j];
+		}
+
+		double millis(SizeType j) const
+		{
+			assert(j < millis_.size());
+			return millis_[j];
+		}
+
+		const PsimagLite::String& output(SizeType j) const
+		{
+			assert(j < outputs_.size());
+			return outputs_[j];
+		}
+
+	private:
+
+		Diagonalization& diag_;
+		const VectorSizeType& sectors_;
+		const LeftRightSuperType& lrs_;
+		RealType targetTime_;
+		const VectorVectorType& initialVectors_;
+		VectorVectorVectorType& vecSaved_;
+		const ParametersForSolverType& params_;
+		SizeType loopIndex_;
+		VectorVectorRealType energies_;
+		PsimagLite::Vector<double>::Type millis_;
+		PsimagLite::Vector<PsimagLite::String>::Type outputs_;
+	};
+
+public:
 
 	Diagonalization(const ParametersType& parameters,
 	                const ModelType& model,
@@ -313,22 +441,64 @@ private:
 			                    sectors,
 			                    lrs.super());
 
-		for (SizeType j = 0; j < totalSectors; ++j) {
+		const bool sectorsInParallel = (options.isSet("DiagonalizeSectorsInParallel") &&
+		                                !onlyWft &&
+		                                totalSectors > 1);
+
+		if (sectorsInParallel) {
+			diagonaliseSectorsInParallel(energySaved,
+			                             vecSaved,
+			                             target,
+			                             onlyForVwoS,
+			                             block,
+			                             noguess,
+			                             compactedWeights,
+			                             sectors,
+			                             loopIndex);
+		} else {
+			const ParametersForSolverType params(io_, "Lanczos", loopIndex);
+			for (SizeType j = 0; j < totalSectors; ++j) {
 
-			SizeType i = sectors[j];
+				SizeType i = sectors[j];
 
-			PsimagLite::OstringStream msgg(std::cout.precision());
-			PsimagLite::OstringStream::OstringStreamType& msg = msgg();
-			msg<<"About to diag. sector with";
-			msg<<" quantumSector="<<lrs.super().qnEx(i);
-			msg<<" and numberOfExcited="<<parameters_.numberOfExcited;
-			progress_.printline(msgg, std::cout);
-
-			TargetVectorType* initialBySector = (isVwoS) ? &onlyForVwoS[j]
-			                                               : new TargetVectorType;
+				PsimagLite::OstringStream msgg(std::cout.precision());
+				PsimagLite::OstringStream::OstringStreamType& msg = msgg();
+				msg<<"About to diag. sector with";
+				msg<<" quantumSector="<<lrs.super().qnEx(i);
+				msg<<" and numberOfExcited="<<parameters_.numberOfExcited;
+				progress_.printline(msgg, std::cout);
 
-			if (onlyWft) {
-				for (SizeType excitedIndex = 0; excitedIndex < numberOfExcited; ++excitedIndex) {
+				TargetVectorType* initialBySector = (isVwoS) ? &onlyForVwoS[j]
+				                                               : new TargetVectorType;
+
+				if (onlyWft) {
+					for (SizeType excitedIndex = 0; excitedIndex < numberOfExcited; ++excitedIndex) {
+						if (!isVwoS)
+							target.initialGuess(*initialBySector,
+							                    block,
+							                    noguess,
+							                    compactedWeights,
+							                    sectors,
+							                    j,
+							                    excitedIndex,
+							                    lrs.super());
+						RealType norma = PsimagLite::norm(*initialBySector);
+
+						if (fabs(norma) < 1e-12) {
+							err("FATAL Norm of initial vector is zero\n");
+						} else {
+							*initialBySector /= norma;
+						}
+
+						vecSaved[j][excitedIndex] = *initialBySector;
+						energySaved[j][excitedIndex] = oldEnergy_[j][excitedIndex];
+						PsimagLite::OstringStream msgg(std::cout.precision());
+						PsimagLite::OstringStream::OstringStreamType& msg = msgg();
+						msg<<"Early exit due to user requesting (fast) WFT only, ";
+						msg<<"(non updated) energy= "<<energySaved[j][excitedIndex];
+						progress_.printline(msgg, std::cout);
+					}
+				} else {
 					if (!isVwoS)
 						target.initialGuess(*initialBySector,
 						                    block,
@@ -336,63 +506,48 @@ private:
 						                    compactedWeights,
 						                    sectors,
 						                    j,
-						                    excitedIndex,
+						                    numberOfExcited, // sum all excited
 						                    lrs.super());
 					RealType norma = PsimagLite::norm(*initialBySector);
 
-					if (fabs(norma) < 1e-12) {
-						err("FATAL Norm of initial vector is zero\n");
-					} else {
+					if (fabs(norma) >= 1e-12)
 						*initialBySector /= norma;
+
+					for (SizeType excitedIndex = 0; excitedIndex < numberOfExcited; ++excitedIndex)
+						vecSaved[j][excitedIndex].resize(initialBySector->size());
+
+					const PsimagLite::MemoryUsage::TimeHandle time1 =
+					        PsimagLite::ProgressIndicator::time();
+
+					VectorRealType myEnergy;
+					SolverContext context(params, j, std::cout);
+					diagonaliseOneBlock(myEnergy,
+					                    vecSaved[j],
+					                    i,
+					                    lrs,
+					                    target.time(),
+					                    *initialBySector,
+					                    loopIndex,
+					                    context);
+
+					const PsimagLite::MemoryUsage::TimeHandle time2 =
+					        PsimagLite::ProgressIndicator::time();
+
+					for (SizeType excitedIndex = 0; excitedIndex < numberOfExcited; ++excitedIndex) {
+						energySaved[j][excitedIndex] = myEnergy[excitedIndex];
+						oldEnergy_[j][excitedIndex] = myEnergy[excitedIndex];
 					}
 
-					vecSaved[j][excitedIndex] = *initialBySector;
-					energySaved[j][excitedIndex] = oldEnergy_[j][excitedIndex];
-					PsimagLite::OstringStream msgg(std::cout.precision());
-					PsimagLite::OstringStream::OstringStreamType& msg = msgg();
-					msg<<"Early exit due to user requesting (fast) WFT only, ";
-					msg<<"(non updated) energy= "<<energySaved[j][excitedIndex];
-					progress_.printline(msgg, std::cout);
-				}
-			} else {
-				if (!isVwoS)
-					target.initialGuess(*initialBySector,
-					                    block,
-					                    noguess,
-					                    compactedWeights,
-					                    sectors,
-					                    j,
-					                    numberOfExcited, // sum all excited
-					                    lrs.super());
-				RealType norma = PsimagLite::norm(*initialBySector);
-
-				if (fabs(norma) >= 1e-12)
-					*initialBySector /= norma;
-
-				for (SizeType excitedIndex = 0; excitedIndex < numberOfExcited; ++excitedIndex)
-					vecSaved[j][excitedIndex].resize(initialBySector->size());
-
-				VectorRealType myEnergy;
-				diagonaliseOneBlock(myEnergy,
-				                    vecSaved[j],
-				                    i,
-				                    lrs,
-				                    target.time(),
-				                    *initialBySector,
-				                    loopIndex);
-
-				for (SizeType excitedIndex = 0; excitedIndex < numberOfExcited; ++excitedIndex) {
-					energySaved[j][excitedIndex] = myEnergy[excitedIndex];
-					oldEnergy_[j][excitedIndex] = myEnergy[excitedIndex];
-				}
-			} // end if
+					printSectorTime(j, compactedWeights[j], (time2 - time1).millis());
+				} // end if
 
-			if (!isVwoS) {
-				delete initialBySector;
-				initialBySector = 0;
-			}
+				if (!isVwoS) {
+					delete initialBySector;
+					initialBySector = 0;
+				}
 
-		} // end sectors
+			} // end sectors
+		}
 
 		// calc gs energy
 		if (verbose_ && PsimagLite::Concurrency::root())
@@ -446,6 +601,96 @@ private:
 		energies = energySaved;
 	}
 
+	// Diagonalizes all targeted sectors concurrently, balanced by sector size.
+	// The npthreads of the run are split into an outer budget over sectors
+	// and an inner budget for each Lanczos or Davidson solve
+	void diagonaliseSectorsInParallel(VectorVectorRealType& energySaved,
+	                                  VectorVectorVectorType& vecSaved,
+	                                  TargetingType& target,
+	                                  const VectorVectorType& onlyForVwoS,
+	                                  const VectorSizeType& block,
+	                                  bool noguess,
+	                                  const VectorSizeType& compactedWeights,
+	                                  const VectorSizeType& sectors,
+	                                  SizeType loopIndex)
+	{
+		const LeftRightSuperType& lrs = target.lrs();
+		const SizeType numberOfExcited = parameters_.numberOfExcited;
+		const SizeType totalSectors = sectors.size();
+		const bool isVwoS = (VectorWithOffsetType::name() == "vectorwithoffsets");
+
+		// initial guesses are computed serially, the targeting is not thread safe
+		VectorVectorType initialVectors(totalSectors);
+		for (SizeType j = 0; j < totalSectors; ++j) {
+			if (isVwoS)
+				initialVectors[j] = onlyForVwoS[j];
+			else
+				target.initialGuess(initialVectors[j],
+				                    block,
+				                    noguess,
+				                    compactedWeights,
+				                    sectors,
+				                    j,
+				                    numberOfExcited, // sum all excited
+				                    lrs.super());
+
+			RealType norma = PsimagLite::norm(initialVectors[j]);
+			if (fabs(norma) >= 1e-12)
+				initialVectors[j] /= norma;
+
+			for (SizeType excitedIndex = 0; excitedIndex < numberOfExcited; ++excitedIndex)
+				vecSaved[j][excitedIndex].resize(initialVectors[j].size());
+		}
+
+		// read once here, the input object is not thread safe
+		const ParametersForSolverType params(io_, "Lanczos", loopIndex);
+
+		ParallelSectors helper(*this,
+		                       sectors,
+		                       lrs,
+		                       target.time(),
+		                       initialVectors,
+		                       vecSaved,
+		                       params,
+		                       loopIndex);
+
+		{
+			NestedThreads nestedThreads(totalSectors);
+
+			PsimagLite::OstringStream msgg(std::cout.precision());
+			PsimagLite::OstringStream::OstringStreamType& msg = msgg();
+			msg<<"Diagonalizing "<<totalSectors<<" sectors in parallel with ";
+			msg<<nestedThreads.outer()<<" x "<<nestedThreads.inner()<<" threads";
+			msg<<" (Threads x ThreadsLevelTwo)";
+			progress_.printline(msgg, std::cout);
+
+			PsimagLite::CodeSectionParams codeSectionParams(nestedThreads.outer());
+			PsimagLite::Parallelizer<ParallelSectors,
+			        PsimagLite::LoadBalancerWeights> threadedSectors(codeSectionParams);
+			threadedSectors.loopCreate(helper, compactedWeights);
+		}
+
+		for (SizeType j = 0; j < totalSectors; ++j) {
+			std::cout<<helper.output(j);
+			const VectorRealType& myEnergy = helper.energies(j);
+			for (SizeType excitedIndex = 0; excitedIndex < numberOfExcited; ++excitedIndex) {
+				energySaved[j][excitedIndex] = myEnergy[excitedIndex];
+				oldEnergy_[j][excitedIndex] = myEnergy[excitedIndex];
+			}
+
+			printSectorTime(j, compactedWeights[j], helper.millis(j));
+		}
+	}
+
+	void printSectorTime(SizeType j, SizeType sectorSize, double millis) const
+	{
+		PsimagLite::OstringStream msgg(std::cout.precision());
+		PsimagLite::OstringStream::OstringStreamType& msg = msgg();
+		msg<<"Sector["<<j<<"] of size="<<sectorSize;
+		msg<<" diagonalized in "<<millis<<" ms";
+		progress_.printline(msgg, std::cout);
+	}
+
 	/** Diagonalise the i-th block of the matrix, return its eigenvectors
 			in tmpVec and its eigenvalues in energyTmp
 		!PTEX_LABEL{diagonaliseOneBlock} */
@@ -455,7 +700,8 @@ private:
 	                         const LeftRightSuperType& lrs,
 	                         RealType targetTime,
 	                         const TargetVectorType& initialVector,
-	                         SizeType loopIndex)
+	                         SizeType loopIndex,
+	                         SolverContext& context)
 	{
 		const OptionsType& options = parameters_.options;
 
@@ -497,7 +743,7 @@ private:
 					PsimagLite::OstringStream::OstringStreamType& msg = msgg();
 					msg<<"Uses exact due to user request. ";
 					msg<<"Found lowest eigenvalue= "<<energyTmp[0];
-					progress_.printline(msgg, std::cout);
+					progress_.printline(msgg, context.os);
 				}
 				return;
 			}
@@ -506,13 +752,14 @@ private:
 		PsimagLite::OstringStream msgg(std::cout.precision());
 		PsimagLite::OstringStream::OstringStreamType& msg = msgg();
 		msg<<"I will now diagonalize a matrix of size="<<hc.modelHelper().size(partitionIndex);
-		progress_.printline(msgg, std::cout);
+		progress_.printline(msgg, context.os);
 		diagonaliseOneBlock(energyTmp,
 		                    tmpVec,
 		                    hc,
 		                    initialVector,
 		                    loopIndex,
-		                    aux);
+		                    aux,
+		                    context);
 	}
 
 	void diagonaliseOneBlock(VectorRealType& energyTmp,
@@ -520,7 +767,8 @@ private:
 	                         HamiltonianConnectionType& hc,
 	                         const TargetVectorType& initialVector,
 	                         SizeType loopIndex,
-	                         const typename ModelHelperType::Aux& aux)
+	                         const typename ModelHelperType::Aux& aux,
+	                         SolverContext& context)
 	{
 		const SizeType nexcited = energyTmp.size();
 		typename LanczosOrDavidsonBaseType::MatrixType lanczosHelper(model_,
@@ -536,20 +784,18 @@ private:
 			msg<<"Early exit due to user requesting (slow) WFT, energy= ";
 			for (SizeType i = 0; i < nexcited; ++i)
 				msg<<energyTmp[i]<<" ";
-			progress_.printline(msgg, std::cout);
+			progress_.printline(msgg, context.os);
 			return;
 		}
 
-		ParametersForSolverType params(io_, "Lanczos", loopIndex);
 		LanczosOrDavidsonBaseType* lanczosOrDavidson = 0;
-
-		const bool useDavidson = parameters_.options.isSet("useDavidson");
-
-		if (useDavidson) {
-			lanczosOrDavidson = new DavidsonSolverType(lanczosHelper, params);
-		} else {
-			lanczosOrDavidson = new LanczosSolverType(lanczosHelper, params);
-		}
+		BlockLanczosSolverType* blockLanczos = 0;
+		newSolver(blockLanczos,
+		          lanczosOrDavidson,
+		          lanczosHelper,
+		          context.params,
+		          tmpVec.size(),
+		          context);
 
 		if (lanczosHelper.rows()==0) {
 			static const RealType val = 10000;
@@ -558,20 +804,31 @@ private:
 			PsimagLite::OstringStream::OstringStreamType& msg = msgg();
 			msg<<"Early exit due to matrix rank being zero.";
 			msg<<" BOGUS energy= "<<val;
-			progress_.printline(msgg, std::cout);
+			progress_.printline(msgg, context.os);
 			if (lanczosOrDavidson) delete lanczosOrDavidson;
+			if (blockLanczos) delete blockLanczos;
 			return;
 		}
 
+		const bool mixedPrecision = (parameters_.options.isSet("KronMixedPrecision") ||
+		                             (saveOption & 32) > 0);
+		const bool lowPrecision = lanczosHelper.lowPrecision(mixedPrecision);
+
 		try {
-			computeAllLevelsBelow(energyTmp, tmpVec, *lanczosOrDavidson, initialVector);
+			solve(energyTmp, tmpVec, blockLanczos, lanczosOrDavidson, initialVector, context);
+
+			if (lowPrecision) {
+				lanczosHelper.lowPrecision(false);
+				refineInFullPrecision(energyTmp, tmpVec, lanczosHelper, context);
+			}
 		} catch (std::exception& e) {
+			lanczosHelper.lowPrecision(false);
 			PsimagLite::OstringStream msgg0(std::cout.precision());
 			PsimagLite::OstringStream::OstringStreamType& msg0 = msgg0();
 			msg0<<e.what()<<"\n";
-			msg0<<"Lanczos or Davidson solver failed, ";
+			msg0<<"Lanczos, Davidson, or BlockLanczos solver failed, ";
 			msg0<<"trying with exact diagonalization...";
-			progress_.printline(msgg0, std::cout);
+			progress_.printline(msgg0, context.os);
 			progress_.printline(msgg0, std::cerr);
 
 			VectorRealType eigs(lanczosHelper.rows());
@@ -585,22 +842,138 @@ private:
 				PsimagLite::OstringStream msgg2(std::cout.precision());
 				PsimagLite::OstringStream::OstringStreamType& msg2 = msgg2();
 				msg2<<"Found eigenvalue["<<excited<<"]= "<<energyTmp[excited];
-				progress_.printline(msgg2, std::cout);
+				progress_.printline(msgg2, context.os);
 			}
 		}
 
 		PsimagLite::OstringStream msgg1(std::cout.precision());
 		PsimagLite::OstringStream::OstringStreamType& msg1 = msgg1();
 		msg1<<"Found lowest eigenvalue= "<<energyTmp[0];
-		progress_.printline(msgg1, std::cout);
+		progress_.printline(msgg1, context.os);
 
 		if (lanczosOrDavidson) delete lanczosOrDavidson;
+		if (blockLanczos) delete blockLanczos;
+	}
+
+	void solve(VectorRealType& energyTmp,
+	           VectorVectorType& tmpVec,
+	           BlockLanczosSolverType* blockLanczos,
+	           LanczosOrDavidsonBaseType* lanczosOrDavidson,
+	           const TargetVectorType& initialVector,
+	           SolverContext& context) const
+	{
+		if (blockLanczos)
+			blockLanczos->computeAllStatesBelow(energyTmp,
+			                                    tmpVec,
+			                                    initialVector,
+			                                    tmpVec.size());
+		else
+			computeAllLevelsBelow(energyTmp,
+			                      tmpVec,
+			                      *lanczosOrDavidson,
+			                      initialVector,
+			                      context);
+	}
+
+	void newSolver(BlockLanczosSolverType*& blockLanczos,
+	               LanczosOrDavidsonBaseType*& lanczosOrDavidson,
+	               typename LanczosOrDavidsonBaseType::MatrixType& lanczosHelper,
+	               const ParametersForSolverType& params,
+	               SizeType nexcited,
+	               SolverContext& context) const
+	{
+		const bool useDavidson = parameters_.options.isSet("useDavidson");
+		const bool useBlockLanczos = (parameters_.options.isSet("BlockLanczos") &&
+		                              nexcited > 1);
+
+		if (useBlockLanczos) {
+			blockLanczos = new BlockLanczosSolverType(lanczosHelper, params, context.seed);
+		} else if (useDavidson) {
+			lanczosOrDavidson = new DavidsonSolverType(lanczosHelper, params);
+		} else {
+			lanczosOrDavidson = new LanczosSolverType(lanczosHelper, params);
+		}
+	}
+
+	// A mixed precision solve is accepted if its residuals, computed in full
+	// precision, are below LanczosEps. Otherwise, it is refined in full precision
+	// starting from the sum of all its Ritz vectors, with a reduced number of steps
+	// if the residuals are at the level of the single precision epsilon, and with
+	// all steps if the single precision solve did not converge.
+	void refineInFullPrecision(VectorRealType& energyTmp,
+	                           VectorVectorType& tmpVec,
+	                           typename LanczosOrDavidsonBaseType::MatrixType& lanczosHelper,
+	                           SolverContext& context) const
+	{
+		const ParametersForSolverType& params = context.params;
+		RealType maxResidual = 0;
+		RealType scale = 1;
+		for (SizeType i = 0; i < energyTmp.size(); ++i) {
+			const TargetVectorType& v = tmpVec[i];
+			TargetVectorType hv(v.size(), 0.0);
+			lanczosHelper.matrixVectorProduct(hv, v);
+			for (SizeType j = 0; j < v.size(); ++j)
+				hv[j] -= energyTmp[i]*v[j];
+			const RealType r = PsimagLite::norm(hv);
+			if (r > maxResidual) maxResidual = r;
+			if (fabs(energyTmp[i]) > scale) scale = fabs(energyTmp[i]);
+		}
+
+		const RealType floatLevel = FLOAT_RESIDUAL_FACTOR*scale*
+		        std::numeric_limits<float>::epsilon();
+		const bool accepted = (maxResidual*maxResidual < params.tolerance);
+		const bool converged = (maxResidual <= floatLevel);
+
+		ParametersForSolverType refine(params);
+		if (converged) {
+			SizeType steps = params.steps/REFINE_STEPS_DIVISOR;
+			if (steps < MIN_REFINE_STEPS) steps = MIN_REFINE_STEPS;
+			if (steps < refine.steps) refine.steps = steps;
+		}
+
+		PsimagLite::OstringStream msgg(std::cout.precision());
+		PsimagLite::OstringStream::OstringStreamType& msg = msgg();
+		msg<<"Mixed precision: maxResidual="<<maxResidual<<" eps="<<params.tolerance;
+		msg<<" floatLevel="<<floatLevel;
+		if (accepted)
+			msg<<" accepted";
+		else
+			msg<<" refining in full precision with "<<refine.steps<<" steps";
+		progress_.printline(msgg, context.os);
+
+		if (accepted) return;
+
+		TargetVectorType guess = tmpVec[0];
+		for (SizeType i = 1; i < tmpVec.size(); ++i)
+			for (SizeType j = 0; j < guess.size(); ++j)
+				guess[j] += tmpVec[i][j];
+
+		LanczosOrDavidsonBaseType* lanczosOrDavidson = 0;
+		BlockLanczosSolverType* blockLanczos = 0;
+		newSolver(blockLanczos,
+		          lanczosOrDavidson,
+		          lanczosHelper,
+		          refine,
+		          tmpVec.size(),
+		          context);
+
+		try {
+			solve(energyTmp, tmpVec, blockLanczos, lanczosOrDavidson, guess, context);
+		} catch (std::exception&) {
+			delete lanczosOrDavidson;
+			delete blockLanczos;
+			throw;
+		}
+
+		delete lanczosOrDavidson;
+		delete blockLanczos;
 	}
 
 	void computeAllLevelsBelow(VectorRealType& energyTmp,
 	                           VectorVectorType& gsVector,
 	                           LanczosOrDavidsonBaseType& object,
-	                           const TargetVectorType& initialVector) const
+	                           const TargetVectorType& initialVector,
+	                           SolverContext& context) const
 	{
 		const SizeType nexcited = gsVector.size();
 		RealType norma = PsimagLite::norm(initialVector);
@@ -609,15 +982,26 @@ private:
 			PsimagLite::OstringStream::OstringStreamType& msg = msgg();
 			msg<<"WARNING: diagonaliseOneBlock: Norm of guess vector is zero, ";
 			msg<<"ignoring guess\n";
-			progress_.printline(msgg, std::cout);
+			progress_.printline(msgg, context.os);
 			TargetVectorType init(initialVector.size());
-			PsimagLite::fillRandom(init);
+			for (SizeType i = 0; i < init.size(); ++i)
+				myRandomT(init[i], context.rng);
 			object.computeAllStatesBelow(energyTmp, gsVector,init, nexcited);
 		} else {
 			object.computeAllStatesBelow(energyTmp, gsVector, initialVector, nexcited);
 		}
 	}
 
+	static void myRandomT(std::complex<RealType>& value, RngType& rng)
+	{
+		value = std::complex<RealType>(rng() - 0.5, rng() - 0.5);
+	}
+
+	static void myRandomT(RealType& value, RngType& rng)
+	{
+		value = rng() - 0.5;
+	}
+
 	void slowWft(VectorRealType& energyTmp,
 	             VectorVectorType& gsVector,
 	             const typename LanczosOrDavidsonBaseType::MatrixType& object,
@@ -3,6 +3,8 @@
 #include "Stack.h"
 #include "DiskStackNg.h"
 #include "Io/IoNg.h"
+#include "AsyncWriter.h"
+#include <memory>
 
 namespace Dmrg {
 
@@ -18,7 +20,7 @@ public:
 	                  const PsimagLite::String filename,
 	                  PsimagLite::String label,
 	                  bool isObserveCode)
-	    : diskW_(0), diskR_(0)
+	    : diskW_(0), diskR_(0), asyncWriter_(0), ticket_(0)
 	{
 		if (!onDisk) return;
 
@@ -37,15 +39,24 @@ public:
 
 	~DiskOrMemoryStack()
 	{
+		waitForWriter();
 		delete diskR_;
 		diskR_ = 0;
 		delete diskW_;
 		diskW_ = 0;
 	}
 
+	// pushes to disk are then done by the writer, see AsyncWrite in SolverOptions
+	void setAsyncWriter(AsyncWriter* asyncWriter)
+	{
+		asyncWriter_ = asyncWriter;
+	}
+
 	void push(const BasisWithOperatorsType& b)
 	{
-		if (diskW_) {
+		if (diskW_ && asyncWriter_) {
+			pushAsync(b);
+		} else if (diskW_) {
 			diskW_->push(b);
 			diskW_->flush();
 			diskR_->restore(diskW_->size());
@@ -57,6 +68,7 @@ public:
 	void pop()
 	{
 		if (diskW_) {
+			waitForWriter();
 			diskW_->pop();
 			diskW_->flush();
 			diskR_->restore(diskW_->size());
@@ -74,12 +86,22 @@ public:
 
 	const BasisWithOperatorsType& top() const
 	{
+		waitForWriter();
 		return (diskR_) ? diskR_->top() : memory_.top();
 	}
 
+	// the element below the top, which the next pop() and top() need
+	void prefetch() const
+	{
+		if (!diskR_ || diskR_->size() < 2) return;
+		waitForWriter();
+		diskR_->prefetch(diskR_->size() - 2);
+	}
+
 	void toDisk(DiskStackType& disk) const
 	{
 		if (diskR_) {
+			waitForWriter();
 			SizeType total = diskR_->size();
 			DiskStackType& diskNonConst = const_cast<DiskStackType&>(*diskR_);
 			loadStack(disk, diskNonConst);
@@ -103,6 +125,27 @@ public:
 
 private:
 
+	// the writer owns a copy of b, and diskR_ counts it now, so that size()
+	// is right at once; top() and pop() wait for the write
+	void pushAsync(const BasisWithOperatorsType& b)
+	{
+		std::shared_ptr<BasisWithOperatorsType> copy(new BasisWithOperatorsType(b));
+		DiskStackType* diskW = diskW_;
+		const SizeType bytes = b.memoryEstimate();
+		ticket_ = asyncWriter_->push([diskW, copy]() {
+			diskW->push(*copy);
+			diskW->flush();
+		}, bytes);
+
+		diskR_->restore(diskR_->size() + 1);
+	}
+
+	void waitForWriter() const
+	{
+		if (!asyncWriter_ || ticket_ == 0) return;
+		asyncWriter_->waitFor(ticket_);
+	}
+
 	DiskOrMemoryStack(const DiskOrMemoryStack&);
 
 	DiskOrMemoryStack& operator=(const DiskOrMemoryStack&);
@@ -111,6 +154,8 @@ private:
 	MemoryStackType memory_;
 	DiskStackType *diskW_;
 	DiskStackType *diskR_;
+	AsyncWriter* asyncWriter_;
+	SizeType ticket_;
 };
 
 template<typename BasisWithOperatorsType>
@@ -76,15 +76,33 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Stack.h"
 #include "Io/IoNg.h"
 #include "ProgressIndicator.h"
+#include "Concurrency.h"
 #include <exception>
 
 // A disk stack, similar to std::stack but stores in disk not in memory
 namespace Dmrg {
+
+/* PSIDOC DiskStackPrefetch
+ A DiskStack that reads can load one element in the background, see prefetch(index)
+ and PrefetchStacksOnDisk in SolverOptions. The element is decoded by a separate thread
+ into a cache of at most MAX\_PREFETCHED elements, and top() takes it from there
+ instead of reading it from the file. All reads and writes of DiskStacks take the same
+ lock, but other parts of DMRG++ write to their own files while the prefetch is running,
+ so that the HDF5 library must be built thread safe, see checkHdf5ThreadSafe.
+ Without USE\_PTHREADS prefetch(index) does nothing.
+ On destruction, the number of hits, stalls (top() had to wait for the prefetch
+ of its element), and misses (top() had to read from the file) is printed.
+ */
 template<typename DataType>
 class DiskStack {
 
+	typedef PsimagLite::Concurrency ConcurrencyType;
 	typedef typename PsimagLite::IoNg::In IoInType;
 	typedef typename PsimagLite::IoNg::Out IoOutType;
+	typedef std::pair<SizeType, DataType*> PairSizeDataType;
+	typedef typename PsimagLite::Vector<PairSizeDataType>::Type VectorPairSizeDataType;
+
+	static const SizeType MAX_PREFETCHED = 2;
 
 public:
 
@@ -98,8 +116,16 @@ public:
 	      isObserveCode_(isObserveCode),
 	      total_(0),
 	      progress_("DiskStack"),
-	      dt_(0)
+	      dt_(0),
+	      hasWorker_(false),
+	      prefetching_(0),
+	      prefetchDone_(true),
+	      hits_(0),
+	      stalls_(0),
+	      misses_(0)
 	{
+		ConcurrencyType::mutexInit(&stateMutex_);
+
 		if (!needsToRead) {
 			ioOut_->createGroup(label_);
 			ioOut_->write(total_, label_ + "/Size");
@@ -115,17 +141,32 @@ public:
 
 	~DiskStack()
 	{
+		joinWorker();
+		for (SizeType i = 0; i < prefetched_.size(); ++i)
+			delete prefetched_[i].second;
+		prefetched_.clear();
+
+		if (hits_ + stalls_ > 0) {
+			PsimagLite::OstringStream msgg(std::cout.precision());
+			PsimagLite::OstringStream::OstringStreamType& msg = msgg();
+			msg<<label_<<" prefetch hits="<<hits_<<" stalls="<<stalls_;
+			msg<<" misses="<<misses_;
+			progress_.printline(msgg, std::cout);
+		}
+
 		delete dt_;
 		dt_ = 0;
 		delete ioIn_;
 		ioIn_ = 0;
 		delete ioOut_;
 		ioOut_ = 0;
+		ConcurrencyType::mutexDestroy(&stateMutex_);
 	}
 
 	void flush()
 	{
 		assert(ioOut_);
+		IoLock lock;
 		ioOut_->flush();
 	}
 
@@ -135,6 +176,7 @@ public:
 	{
 		assert(ioOut_);
 
+		IoLock lock;
 		try {
 			d.write(*ioOut_,
 			        label_ + "/" + ttos(total_),
@@ -164,6 +206,7 @@ public:
 
 		if (!ioOut_) return;
 
+		IoLock lock;
 		ioOut_->write(total_,
 		              label_ + "/Size",
 		              IoOutType::Serializer::ALLOW_OVERWRITE);
@@ -171,9 +214,13 @@ public:
 
 	void restore(SizeType total)
 	{
+		if (static_cast<int>(total) > total_)
+			dropPrefetchedFrom(total_);
+
 		total_ = total;
 		if (!ioOut_) return;
 
+		IoLock lock;
 		ioOut_->write(total_,
 		              label_ + "/Size",
 		              IoOutType::Serializer::ALLOW_OVERWRITE);
@@ -185,18 +232,159 @@ public:
 			err("DiskStack::top() called with ioIn_ as nullptr\n");
 
 		assert(total_ > 0);
+		const SizeType index = total_ - 1;
+		if (hasWorker_ && prefetching_ == index) {
+			if (isPrefetchDone()) ++hits_;
+			else ++stalls_;
+		}
+
+		joinWorker();
 		delete dt_;
-		dt_ = 0;
+		dt_ = takePrefetched(index);
+		if (dt_) return *dt_;
+
+		if (hits_ + stalls_ > 0) ++misses_;
+		IoLock lock;
 		dt_ = new DataType(*ioIn_,
-		                   label_ + "/" + ttos(total_ - 1),
+		                   label_ + "/" + ttos(index),
 		                   isObserveCode_);
 		return *dt_;
 	}
 
+	// starts loading element index in the background, see top()
+	void prefetch(SizeType index) const
+	{
+#ifdef USE_PTHREADS
+		if (!ioIn_ || static_cast<int>(index) >= total_) return;
+
+		joinWorker();
+		for (SizeType i = 0; i < prefetched_.size(); ++i)
+			if (prefetched_[i].first == index) return;
+
+		if (prefetched_.size() >= MAX_PREFETCHED) {
+			delete prefetched_[0].second;
+			prefetched_.erase(prefetched_.begin());
+		}
+
+		prefetching_ = index;
+		setPrefetchDone(false);
+		if (pthread_create(&worker_, 0, prefetchThread, const_cast<DiskStack*>(this)) != 0) {
+			setPrefetchDone(true);
+			return; // top() will read it
+		}
+
+		hasWorker_ = true;
+#endif
+	}
+
 	SizeType size() const { return total_; }
 
 private:
 
+	// one for all DiskStacks, because they may share a file
+	class IoLock {
+
+	public:
+
+		IoLock() { ConcurrencyType::mutexLock(&ioMutex().mutex); }
+
+		~IoLock() { ConcurrencyType::mutexUnlock(&ioMutex().mutex); }
+
+	private:
+
+		struct IoMutex {
+
+			IoMutex() { ConcurrencyType::mutexInit(&mutex); }
+
+			~IoMutex() { ConcurrencyType::mutexDestroy(&mutex); }
+
+			ConcurrencyType::MutexType mutex;
+		};
+
+		static IoMutex& ioMutex()
+		{
+			static IoMutex ioMutex;
+			return ioMutex;
+		}
+
+		IoLock(const IoLock&);
+
+		IoLock& operator=(const IoLock&);
+	};
+
+#ifdef USE_PTHREADS
+	// reads element prefetching_; runs on worker_
+	static void* prefetchThread(void* arg)
+	{
+		DiskStack* stack = static_cast<DiskStack*>(arg);
+		const SizeType index = stack->prefetching_;
+		DataType* data = 0;
+		try {
+			IoLock lock;
+			data = new DataType(*(stack->ioIn_),
+			                    stack->label_ + "/" + ttos(index),
+			                    stack->isObserveCode_);
+		} catch (...) {
+			data = 0; // top() will read it again, and throw then
+		}
+
+		if (data) stack->prefetched_.push_back(PairSizeDataType(index, data));
+		stack->setPrefetchDone(true);
+		return 0;
+	}
+#endif
+
+	void joinWorker() const
+	{
+#ifdef USE_PTHREADS
+		if (!hasWorker_) return;
+		pthread_join(worker_, 0);
+		hasWorker_ = false;
+#endif
+	}
+
+	bool isPrefetchDone() const
+	{
+		ConcurrencyType::mutexLock(&stateMutex_);
+		const bool done = prefetchDone_;
+		ConcurrencyType::mutexUnlock(&stateMutex_);
+		return done;
+	}
+
+	void setPrefetchDone(bool done) const
+	{
+		ConcurrencyType::mutexLock(&stateMutex_);
+		prefetchDone_ = done;
+		ConcurrencyType::mutexUnlock(&stateMutex_);
+	}
+
+	DataType* takePrefetched(SizeType index) const
+	{
+		for (SizeType i = 0; i < prefetched_.size(); ++i) {
+			if (prefetched_[i].first != index) continue;
+			DataType* data = prefetched_[i].second;
+			prefetched_.erase(prefetched_.begin() + i);
+			return data;
+		}
+
+		return 0;
+	}
+
+	// elements at or above index are about to be overwritten
+	void dropPrefetchedFrom(SizeType index)
+	{
+		joinWorker();
+		for (SizeType i = 0; i < prefetched_.size();) {
+			if (prefetched_[i].first < index) {
+				++i;
+				continue;
+			}
+
+			delete prefetched_[i].second;
+			prefetched_.erase(prefetched_.begin() + i);
+		}
+	}
+
 	DiskStack(const DiskStack&);
 
 	DiskStack& operator=(const DiskStack&);
@@ -208,6 +396,18 @@ private:
 	int total_;
 	PsimagLite::ProgressIndicator progress_;
 	mutable DataType* dt_;
+#ifdef USE_PTHREADS
+	mutable pthread_t worker_;
+#endif
+	mutable bool hasWorker_;
+	mutable SizeType prefetching_;
+	// prefetched_ is only touched by worker_ while hasWorker_
+	mutable ConcurrencyType::MutexType stateMutex_;
+	mutable bool prefetchDone_;
+	mutable VectorPairSizeDataType prefetched_;
+	mutable SizeType hits_;
+	mutable SizeType stalls_;
+	mutable SizeType misses_;
 }; // class DiskStack
 
 } // namespace Dmrg
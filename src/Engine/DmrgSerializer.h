@@ -174,6 +174,47 @@ public:
 		}
 	}
 
+	// copies the blocks and vectors this object points to, so that it can
+	// outlive them, as when written by a thread, see AsyncWriter
+	void ownData()
+	{
+		if (ownWf_) return;
+
+		lrs_.deepCopy();
+		const SizeType nsectors = wavefunction_.size();
+		for (SizeType i = 0; i < nsectors; ++i) {
+			const SizeType nexcited = wavefunction_[i].size();
+			for (SizeType j = 0; j < nexcited; ++j) {
+				const VectorWithOffsetType* ptr = wavefunction_[i][j];
+				wavefunction_[i][j] = (ptr) ? new VectorWithOffsetType(*ptr) : nullptr;
+			}
+		}
+
+		ownWf_ = true;
+	}
+
+	// bytes, an estimate
+	SizeType memoryEstimate() const
+	{
+		SizeType sum = lrs_.left().memoryEstimate() + lrs_.right().memoryEstimate() +
+		        lrs_.super().memoryEstimate();
+		const SizeType nsectors = wavefunction_.size();
+		for (SizeType i = 0; i < nsectors; ++i) {
+			const SizeType nexcited = wavefunction_[i].size();
+			for (SizeType j = 0; j < nexcited; ++j) {
+				const VectorWithOffsetType* ptr = wavefunction_[i][j];
+				if (!ptr) continue;
+				for (SizeType ii = 0; ii < ptr->sectors(); ++ii)
+					sum += ptr->effectiveSize(ptr->sector(ii))*sizeof(ComplexOrRealType);
+			}
+		}
+
+		for (SizeType i = 0; i < transform_.blocks(); ++i)
+			sum += transform_(i).rows()*transform_(i).cols()*sizeof(ComplexOrRealType);
+
+		return sum;
+	}
+
 	template<typename SomeIoOutType>
 	void write(SomeIoOutType& io,
 	           PsimagLite::String prefix,
@@ -93,6 +93,9 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "PrinterInDetail.h"
 #include "Io/IoSelector.h"
 #include "TargetingBase.h"
+#include "AsyncWriter.h"
+#include "Hdf5ThreadSafe.h"
+#include <memory>
 
 namespace Dmrg {
 
@@ -168,7 +171,8 @@ public:
 	                parameters_,
 	                model.superGeometry(),
 	                ioOut_),
-	      saveData_(!parameters_.options.isSet("noSaveData"))
+	      saveData_(!parameters_.options.isSet("noSaveData")),
+	      asyncWriter_(0)
 	{
 		std::cout<<appInfo_;
 		PsimagLite::OstringStream msgg(std::cout.precision());
@@ -192,10 +196,30 @@ public:
 			const SizeType saveOption = parameters_.finiteLoop[loopIndex].saveOption;
 			DiagonalizationType::checkSaveOption(saveOption);
 		}
+
+		if (parameters_.options.isSet("AsyncWrite")) {
+#ifdef USE_PTHREADS
+			checkHdf5ThreadSafe("AsyncWrite");
+#endif
+
+			SizeType maxBytes = 1<<30;
+			try {
+				ioIn.readline(maxBytes, "AsyncWriteMaxMemory=");
+			} catch (std::exception&) {}
+
+			asyncWriter_ = new AsyncWriter(maxBytes);
+			checkpoint_.setAsyncWriter(asyncWriter_);
+		}
 	}
 
 	~DmrgSolver()
 	{
+		if (asyncWriter_) {
+			checkpoint_.setAsyncWriter(0);
+			delete asyncWriter_; // finishes all writes first
+			asyncWriter_ = 0;
+		}
+
 		SizeType site = 0; // FIXME FOR IMMM
 		typename BasisWithOperatorsType::VectorBoolType oddElectrons;
 		model_.findOddElectronsOfOneSite(oddElectrons, site);
@@ -358,7 +382,9 @@ obtain ordered
 			                                           parameters_.adjustQuantumNumbers);
 
 			assert(0 < quantumSector_.size()); // used only for SU(2)
-			lrs_.setToProduct(quantumSector_[0], initialSizeOfHashTable);
+			lrs_.setToProduct(quantumSector_[0],
+			                  initialSizeOfHashTable,
+			                  parameters_.options.isSet("SectorOnlySuperBasis"));
 
 			const BlockType& ystep = findRightBlock(Y,step,E);
 
@@ -450,12 +476,15 @@ obtain ordered
 
 			if (psi.end()) break;
 
-			if (recovery.byLoop(i))
+			if (recovery.byLoop(i)) {
+				waitForWriter();
 				recovery.write(psi, i + 1, stepCurrent_, lastSign, ioOut_);
+			}
 		}
 
 		if (!saveData_) return;
 
+		waitForWriter();
 		checkpoint_.write(pS, pE, ioOut_);
 
 		ioOut_.createGroup("FinalPsi");
@@ -546,7 +575,9 @@ obtain ordered
 			                                           parameters_.adjustQuantumNumbers);
 
 			assert(0 < quantumSector_.size()); // used only for SU(2)
-			lrs_.setToProduct(quantumSector_[0], initialSizeOfHashTable);
+			lrs_.setToProduct(quantumSector_[0],
+			                  initialSizeOfHashTable,
+			                  parameters_.options.isSet("SectorOnlySuperBasis"));
 
 			diagonalization_(target,
 			                 energies,
@@ -636,13 +667,41 @@ obtain ordered
 		        ? BasisWithOperatorsType::SaveEnum::ALL
 		        : BasisWithOperatorsType::SaveEnum::PARTIAL;
 		SizeType numberOfSites = model_.superGeometry().numberOfSites();
-		PsimagLite::String prefix("Serializer");
-		ds->write(ioOut_, prefix, saveOption2, numberOfSites, counter);
 		PsimagLite::String prefixForTarget = TargetingType::buildPrefix(ioOut_, counter);
 		target.write(sitesIndices_[stepCurrent_], ioOut_, prefixForTarget);
-		++counter;
-		delete ds;
+
+		PsimagLite::String prefix("Serializer");
+		if (asyncWriter_) {
+			writeAsync(ds, prefix, saveOption2, numberOfSites, counter);
+		} else {
+			ds->write(ioOut_, prefix, saveOption2, numberOfSites, counter);
+			delete ds;
+		}
+
 		ds = 0;
+		++counter;
+	}
+
+	// the writer owns ds, and a copy of the blocks and vectors it points to;
+	// the main loop does not write to ioOut_ until waitForWriter()
+	void writeAsync(DmrgSerializerType* ds,
+	                PsimagLite::String prefix,
+	                typename BasisWithOperatorsType::SaveEnum saveOption2,
+	                SizeType numberOfSites,
+	                SizeType counter)
+	{
+		ds->ownData();
+		const SizeType bytes = ds->memoryEstimate();
+		std::shared_ptr<DmrgSerializerType> dsShared(ds);
+		PsimagLite::IoSelector::Out* ioOut = &ioOut_;
+		asyncWriter_->push([dsShared, ioOut, prefix, saveOption2, numberOfSites, counter]() {
+			dsShared->write(*ioOut, prefix, saveOption2, numberOfSites, counter);
+		}, bytes);
+	}
+
+	void waitForWriter()
+	{
+		if (asyncWriter_) asyncWriter_->wait();
 	}
 
 	bool finalStep(int stepLength,int stepFinal)
@@ -666,6 +725,8 @@ obtain ordered
 
 	void printEnergies(const VectorVectorRealType& energies)
 	{
+		waitForWriter();
+
 		if (!saveData_) return;
 
 		static bool firstCall = true;
@@ -701,6 +762,7 @@ obtain ordered
 	TruncationType truncate_;
 	ObservablesInSituType inSitu_;
 	bool saveData_;
+	AsyncWriter* asyncWriter_;
 }; //class DmrgSolver
 } // namespace Dmrg
 
@@ -51,6 +51,7 @@ Bit & What Happens if Set\\
 1       & WFTs the ground state in a fast way instead of computing it\\
 2       & WFTs the ground state slowly  instead of computing it\\
 3       & Forces random guess for ground state\\
+5       & Single precision Kronecker products in Lanczos, see KronMixedPrecision\\
 \end{tabular}
 \caption{Meaning of each bit of the third number in the
 finite loop triplet. It is a fatal error to have both bits 1 and 2 set.}
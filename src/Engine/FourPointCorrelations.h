@@ -81,6 +81,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #ifndef FOURPOINT_C_H
 #define FOURPOINT_C_H
 
+#include <algorithm>
 #include "CrsMatrix.h"
 #include "Braket.h"
 #include "AnsiColors.h"
@@ -104,6 +105,7 @@ public:
 	typedef PsimagLite::Vector<char>::Type VectorCharType;
 	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
 	typedef typename PsimagLite::Vector<SparseMatrixType>::Type VectorSparseMatrixType;
+	typedef typename PsimagLite::Vector<FieldType>::Type VectorFieldType;
 	typedef typename CorrelationsSkeletonType::BraketType BraketType;
 
 	FourPointCorrelations(const CorrelationsSkeletonType& skeleton) : skeleton_(skeleton)
@@ -155,6 +157,146 @@ public:
 		return secondStage(O2gt,i2,'N',i3,braket,2);
 	}
 
+	//! threePoint(i1, i2, i3) for all i2 < i3 < end, appended to values in order of i3;
+	//! firstStage is done once, and its result is grown from each i3 to the next
+	void threePoint(VectorFieldType& values,
+	                SizeType i1,
+	                SizeType i2,
+	                SizeType end,
+	                const BraketType& braket) const
+	{
+		if (i1>i2)
+			err("calcCorrelation: FourPoint needs ordered points\n");
+		if (i1==i2)
+			err("calcCorrelation: FourPoint needs distinct points\n");
+
+		const SizeType last = skeleton_.numberOfSites() - 1;
+		SparseMatrixType O2gt;
+		const bool finalTransform = true;
+		firstStage(O2gt, 'N', i1, 'N', i2, braket, 0, 1, finalTransform);
+
+		SparseMatrixType O3m;
+		skeleton_.createWithModification(O3m,braket.op(2).getCRS(),'N');
+		const ProgramGlobals::FermionOrBosonEnum fermionS2 = braket.op(1).fermionOrBoson();
+		const ProgramGlobals::FermionOrBosonEnum fermionS3 = braket.op(2).fermionOrBoson();
+
+		// Otmp is O2gt grown from i2 + 1 up to i3 - 1, see secondStage
+		SparseMatrixType Otmp = O2gt;
+		SizeType s = i2;
+		for (SizeType i3 = i2 + 1; i3 < end; ++i3) {
+			if (i3 == last && i2 + 1 == i3) {
+				// firstStage without final transform
+				values.push_back(threePoint(i1, i2, i3, braket));
+				continue;
+			}
+
+			const SizeType ns = i3 - 1;
+			for (; s < ns; ++s)
+				growOneSite4p(Otmp, fermionS2, s);
+
+			if (i3 == last) {
+				values.push_back(skeleton_.bracketRightCorner(Otmp,
+				                                              O3m,
+				                                              fermionS3,
+				                                              i3 - 2, // <---- this is the pointer
+				                                              braket.bra(),
+				                                              braket.ket()));
+				continue;
+			}
+
+			SparseMatrixType O3g;
+			skeleton_.dmrgMultiply(O3g,Otmp,O3m,fermionS3,ns);
+			values.push_back(skeleton_.bracket(O3g,
+			                                   fermionS3,
+			                                   ns, // <---- this is the pointer
+			                                   braket.bra(),
+			                                   braket.ket()));
+		}
+	}
+
+	//! secondStage(O2gt, i2, mod3, i3, mod4, i4, ...) for i3Begin <= i3 < i3End and
+	//! i3 < i4 < i4End, when pred(i3, i4), appended to values in order of i3 and then i4;
+	//! O2gt is grown from each i3 to the next, and O3gt from each i4 to the next
+	template<typename SomePredicateType>
+	void secondStage(VectorFieldType& values,
+	                 const SparseMatrixType& O2gt,
+	                 SizeType i2,
+	                 char mod3,
+	                 char mod4,
+	                 SizeType i3Begin,
+	                 SizeType i3End,
+	                 SizeType i4End,
+	                 const BraketType& braket,
+	                 SizeType index0,
+	                 SizeType index1,
+	                 const SomePredicateType& pred) const
+	{
+		SparseMatrixType O3m,O4m;
+		skeleton_.createWithModification(O3m,braket.op(index0).getCRS(),mod3);
+		skeleton_.createWithModification(O4m,braket.op(index1).getCRS(),mod4);
+
+		if (index0 == 0) err("secondStage\n");
+
+		const ObserverHelperType& helper = skeleton_.helper();
+		const SizeType last = skeleton_.numberOfSites() - 1;
+		const ProgramGlobals::FermionOrBosonEnum fermionS2 = braket.op(index0 - 1).fermionOrBoson();
+		const ProgramGlobals::FermionOrBosonEnum fermionS3 = braket.op(index0).fermionOrBoson();
+		const ProgramGlobals::FermionOrBosonEnum fermionS4 = braket.op(index1).fermionOrBoson();
+
+		SparseMatrixType Otmp = O2gt;
+		SizeType s = i2;
+		for (SizeType i3 = std::max(i3Begin, i2 + 1); i3 < i3End; ++i3) {
+			SparseMatrixType O3gt;
+			SparseMatrixType Otmp4;
+			bool hasO3gt = false;
+			SizeType s4 = i3;
+			for (SizeType i4 = i3 + 1; i4 < i4End; ++i4) {
+				if (!pred(i3, i4)) continue;
+
+				if (i4 == last) {
+					values.push_back(secondStage(O2gt,
+					                             i2,
+					                             mod3,
+					                             i3,
+					                             mod4,
+					                             i4,
+					                             braket,
+					                             index0,
+					                             index1));
+					continue;
+				}
+
+				if (!hasO3gt) {
+					const SizeType ns = i3 - 1;
+					for (; s < ns; ++s)
+						growOneSite4p(Otmp, fermionS2, s);
+
+					SparseMatrixType O3g;
+					skeleton_.dmrgMultiply(O3g,Otmp,O3m,fermionS3,ns);
+					helper.transform(O3gt, O3g, ns);
+					Otmp4 = O3gt;
+					hasO3gt = true;
+				}
+
+				const SizeType ns = i4 - 1;
+				for (; s4 < ns; ++s4)
+					growOneSite4p(Otmp4, fermionS3, s4);
+
+				SparseMatrixType O4g;
+				const SizeType ptr = skeleton_.dmrgMultiply(O4g,
+				                                            Otmp4,
+				                                            O4m,
+				                                            fermionS4,
+				                                            ns);
+				values.push_back(skeleton_.bracket(O4g,
+				                                   fermionS4,
+				                                   ptr,
+				                                   braket.bra(),
+				                                   braket.ket()));
+			}
+		}
+	}
+
 	//! 4-points or more: these are expensive and uncached!!!
 	//! requires i0<i1<i2<i3<...<i_{n-1}
 	FieldType anyPoint(const BraketType& braket) const
@@ -403,19 +545,25 @@ private:
 		int nt=i-1;
 		if (nt<0) nt=0;
 
+		for (SizeType s = nt; s < ns; ++s)
+			growOneSite4p(Odest, fermionicSign, s);
+	}
+
+	// one step s of growDirectly4p
+	void growOneSite4p(SparseMatrixType& Odest,
+	                   ProgramGlobals::FermionOrBosonEnum fermionicSign,
+	                   SizeType s) const
+	{
 		const ObserverHelperType& helper = skeleton_.helper();
 		const SizeType totalSites = skeleton_.numberOfSites();
-
-		for (SizeType s = nt; s < ns; ++s) {
-			SparseMatrixType Onew(helper.cols(s), helper.cols(s));
-			skeleton_.fluffUp(Onew,
-			                  Odest,
-			                  fermionicSign,
-			                  CorrelationsSkeletonType::GrowDirection::RIGHT,
-			                  (s < totalSites - 3),
-			                  s);
-			Odest = Onew;
-		}
+		SparseMatrixType Onew(helper.cols(s), helper.cols(s));
+		skeleton_.fluffUp(Onew,
+		                  Odest,
+		                  fermionicSign,
+		                  CorrelationsSkeletonType::GrowDirection::RIGHT,
+		                  (s < totalSites - 3),
+		                  s);
+		Odest = Onew;
 	}
 
 	void checkIndicesForStrictOrdering(const BraketType& braket) const
@@ -149,6 +149,8 @@ public:
 		for (SizeType x = 0; x < nitems; ++x)
 			totalOnes_[x] = cacheConnections(x);
 
+		if (!ModelHelperType::isSu2()) prepareConjugates();
+
 		SizeType last = lrs.super().block().size();
 		assert(last > 0);
 		--last;
@@ -207,7 +209,14 @@ public:
 				OperatorStorageType const* A = 0;
 				OperatorStorageType const* B = 0;
 				const LinkType& link2 = getKron(&A, &B, x++);
-				modelHelper_.fastOpProdInter(A->getCRS(), B->getCRS(), mBlock, link2, aux);
+				// with BlockedOperatorStorage, A and B are converted here
+				SparseMatrixType tmpA;
+				SparseMatrixType tmpB;
+				modelHelper_.fastOpProdInter(A->getCRS(tmpA),
+				                             B->getCRS(tmpB),
+				                             mBlock,
+				                             link2,
+				                             aux);
 
 				matrixBlock += mBlock;
 			}
@@ -256,13 +265,25 @@ public:
 
 	SizeType tasks() const {return lps_.size(); }
 
-	void clearThreadSelves() const
+private:
+
+	// one transpose conjugate per operator, shared by the threads of getKron
+	void prepareConjugates()
 	{
-		operatorsCached_.clearThreadSelves();
+		for (SizeType x = 0; x < lps_.size(); ++x) {
+			const LinkType& link2 = lps_[x];
+			const ProgramGlobals::SysOrEnvEnum sysOrEnv =
+			        (link2.type == ProgramGlobals::ConnectionEnum::SYSTEM_ENVIRON) ?
+			            ProgramGlobals::SysOrEnvEnum::SYSTEM : ProgramGlobals::SysOrEnvEnum::ENVIRON;
+			const ProgramGlobals::SysOrEnvEnum envOrSys =
+			        (link2.type == ProgramGlobals::ConnectionEnum::SYSTEM_ENVIRON) ?
+			            ProgramGlobals::SysOrEnvEnum::ENVIRON : ProgramGlobals::SysOrEnvEnum::SYSTEM;
+
+			operatorsCached_.prepare(link2.mods.first, link2.finalIndices.first, sysOrEnv);
+			operatorsCached_.prepare(link2.mods.second, link2.finalIndices.second, envOrSys);
+		}
 	}
 
-private:
-
 	SizeType cacheConnections(SizeType x)
 	{
 		const VectorSizeType& hItems = hamAbstract_.item(x);
@@ -123,6 +123,7 @@ public:
 		knownLabels_.push_back("TSPAdvanceEach");
 		knownLabels_.push_back("ChebyshevTransform");
 		knownLabels_.push_back("TSPAlgorithm");
+		knownLabels_.push_back("TSPKrylovTolerance");
 		knownLabels_.push_back("TSPSites");
 		knownLabels_.push_back("TSPLoops");
 		knownLabels_.push_back("TSPProductOrSum");
@@ -177,6 +178,8 @@ public:
 		knownLabels_.push_back("DynamicDmrgEps");
 		knownLabels_.push_back("DynamicDmrgAdvanceEach");
 		knownLabels_.push_back("CorrectionVectorOmega");
+		knownLabels_.push_back("CorrectionVectorOmegas");
+		knownLabels_.push_back("CorrectionVectorOmegasTargeted");
 		knownLabels_.push_back("CorrectionVectorEta");
 		knownLabels_.push_back("CorrectionVectorAlgorithm");
 		knownLabels_.push_back("CorrelationsType");
@@ -208,6 +211,9 @@ public:
 		knownLabels_.push_back("Intent");
 		knownLabels_.push_back("PrintHamiltonianAverage");
 		knownLabels_.push_back("SaveDensityMatrixEigenvalues");
+		knownLabels_.push_back("KronCostModelFile");
+		knownLabels_.push_back("AsyncWriteMaxMemory");
+		knownLabels_.push_back("ObserveMemory");
 
 		for (SizeType i = 0; i < 10; ++i)
 			knownLabels_.push_back("Term" + ttos(i));
@@ -348,7 +354,9 @@ public:
 			\item [wftAccelPatches] Force WFT acceleration with patches, even
 			in twositedmrg
 			\item [BatchedGemm] Only meaningful with MatrixVectorKron. Enables
-								batched gemm and might need plugin sc
+								batched gemm, with plugin sc if compiled with -DPLUGIN_SC.
+								Without the plugin only the lower part is stored,
+								unless KronNoUseLowerPart is also given
 			\item [KrylovNoAbridge] TBW
 			\item [fixLegacyBugs] TBW
 			\item [KronNoUseLowerPart] Don't Use lower part of Kron matrix but
@@ -359,6 +367,80 @@ public:
 			to target expressions.
 			\item [calcAndPrintEntropies] Calculate entropies and print to cout file
 			\item [blasNotThreadSafe] TBW
+			\item [DiagonalizeSectorsInParallel] Diagonalize the targeted symmetry
+			sectors concurrently, balanced by sector size, with up to Threads= sectors
+			at a time and ThreadsLevelTwo= threads for each Lanczos or Davidson solve.
+			Only meaningful with findSymmetrySector or more than one targeted sector.
+			\item [BlockLanczos] Compute all NumberOfExcited states together with
+			block Lanczos, applying the Hamiltonian to a block of vectors at a time,
+			instead of one excited state after the other. Only meaningful with
+			NumberOfExcited greater than one.
+			\item [KronAutoTune] Only meaningful with MatrixVectorKron. Replaces
+			DenseSparseThreshold by the ratio of dense to sparse Kronecker cost
+			measured on this machine at startup, and cached in the file given
+			by KronCostModelFile=, KronCostModel.txt by default, for each host,
+			number of threads and scalar type. Ignored if DenseSparseThreshold=
+			is given in the input.
+			\item [KronWorkStealing] Only meaningful with MatrixVectorKron.
+			Schedule the Kronecker products dynamically, splitting the costliest
+			output patches, instead of assigning patches to threads beforehand.
+			Overrides KronLoadBalance, and prints the idle time of each thread.
+			\item [KronMixedPrecision] Only meaningful with MatrixVectorKron.
+			The matrix vector products of Lanczos or Davidson use single precision
+			copies of the Kronecker operators, while the vectors stay in double precision.
+			The residuals are then computed in double precision; if they are above LanczosEps
+			the solve is refined in double precision starting from the sum of all single
+			precision eigenvectors, with a quarter of the steps if the residuals are at the
+			level of the single precision epsilon, and with all steps otherwise.
+			The single precision products honor KronLoadBalance, but not
+			KronWorkStealing or BatchedGemm.
+			To use this in some finite loops only, set bit 5 of their third number instead.
+			\item [SectorOnlySuperBasis] The superblock basis does not store its
+			permutation, whose size is the product of the sizes of the left and right blocks,
+			but only the offsets of each pair of symmetry sectors of left and right, and the
+			permutation of the target sector. Saves memory for large m, at the cost of
+			computing the other entries of the permutation when they are needed.
+			\item [TruncatedSvd] The SVD of each symmetry block of the reduced wave function
+			computes only its share of the states kept, twice its fraction of the total size,
+			plus a few, using a randomized range finder, when the block is large enough for
+			this to pay. The other singular values are taken to be zero; a block whose smallest
+			computed singular value would still be kept is decomposed again in full.
+			The truncation error printed may be slightly underestimated.
+			The number of blocks that took the truncated path, so far in the run, is printed.
+			Ignored with EnablePersistentSvd.
+			\item [TwoLevelSvd] The symmetry blocks of the density matrix or of the reduced
+			wave function that are larger than a fair share of the work are decomposed first, one
+			at a time, so that a multithreaded LAPACK can use all its threads on each;
+			the other blocks are then decomposed one per thread, the largest first.
+			Without this option the blocks are still handed out largest first.
+			The number of LAPACK threads is set for each phase if compiled with OpenMP
+			or with -DUSE_OPENBLAS_THREADS.
+			With truncationNoSvd, this option is needed for the blocks to be diagonalized
+			in parallel at all.
+			\item [BatchedChangeOfBasis] The change of basis of the operators at each step
+			groups the symmetry blocks of all operators by shape and transforms each group
+			with two GEMMs, instead of transforming each operator on its own.
+			Needs more memory, because all operators are in blocked form at the same time.
+			\item [BlockedOperatorStorage] Only with MatrixVectorKron. The local operators
+			of the enlarged system and environment are stored as blocks of symmetry sectors
+			instead of CRS, each block dense or sparse according to denseSparseThreshold.
+			The Kron matrix vector product then takes its patches from these blocks,
+			and the change of basis transforms them in place with no conversion.
+			\item [PrefetchStacksOnDisk] With shrinkStacksOnDisk, the basis that the next
+			finite step takes from the stack is read from disk in the background, while the
+			current step runs. Needs pthreads, and an HDF5 library built thread safe,
+			which is checked at startup.
+			\item [AsyncWrite] The serializer data of each finite step, and the
+			pushes of shrinkStacksOnDisk, are written to disk by a thread, while the next
+			step runs. The main loop waits for the writes only after each diagonalization,
+			before it writes to the output file, and at checkpoints and exit.
+			The data queued may take up to AsyncWriteMaxMemory= bytes, 1 GiB by default,
+			pushes wait otherwise. Needs an HDF5 library built thread safe, which is
+			checked at startup; without pthreads the writes are done right away.
+			\item [TridiagInParallel] The Krylov tridiagonalizations of the symmetry
+			sectors of the vectors of time evolution and correction vector targetings
+			run concurrently, balanced by sector size, with up to Threads= of them
+			at a time and ThreadsLevelTwo= threads for the matrix vector product of each one.
 		\end{itemize}
 		*/
 	void check(const PsimagLite::String& label,
@@ -425,6 +507,19 @@ public:
 		registerOpts.push_back("OperatorsChangeAll");
 		registerOpts.push_back("calcAndPrintEntropies");
 		registerOpts.push_back("blasNotThreadSafe");
+		registerOpts.push_back("DiagonalizeSectorsInParallel");
+		registerOpts.push_back("BlockLanczos");
+		registerOpts.push_back("KronAutoTune");
+		registerOpts.push_back("KronWorkStealing");
+		registerOpts.push_back("KronMixedPrecision");
+		registerOpts.push_back("SectorOnlySuperBasis");
+		registerOpts.push_back("TruncatedSvd");
+		registerOpts.push_back("TwoLevelSvd");
+		registerOpts.push_back("BatchedChangeOfBasis");
+		registerOpts.push_back("BlockedOperatorStorage");
+		registerOpts.push_back("PrefetchStacksOnDisk");
+		registerOpts.push_back("AsyncWrite");
+		registerOpts.push_back("TridiagInParallel");
 
 		PsimagLite::Options::Writeable optWriteable(registerOpts,
 		                                            PsimagLite::Options::Writeable::PERMISSIVE);
@@ -436,9 +531,11 @@ public:
 		if (val.find("BatchedGemm") != PsimagLite::String::npos) {
 			if (notMvk)
 				err("FATAL: BatchedGemm only with MatrixVectorKron\n");
-#ifndef PLUGIN_SC
-			err("BatchedGemm needs -DPLUGIN_SC in Config.make\n");
-#endif
+		}
+
+		if (val.find("BlockedOperatorStorage") != PsimagLite::String::npos) {
+			if (notMvk)
+				err("FATAL: BlockedOperatorStorage only with MatrixVectorKron\n");
 		}
 	}
 
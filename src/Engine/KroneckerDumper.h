@@ -82,7 +82,7 @@ public:
 		printOneBasis("Right",lrs.right(),p.nOfQns);
 
 		fout_<<"SuperBasisPermutation\n";
-		fout_<<lrs.super().permutationVector();
+		lrs.super().printPermutation(fout_);
 		//QnType qtarget = lrs.super().qnEx(m);
 		//fout_<<qtarget<<"\n";
 
@@ -181,6 +181,19 @@ public:
 		if (refCounter_ > 0) --refCounter_;
 	}
 
+	// makes this object the owner of copies of the blocks it points to
+	void deepCopy()
+	{
+		if (refCounter_ == 0)
+			err("LeftRightSuper::deepCopy(): already the owner\n");
+
+		assert(left_ && right_ && super_);
+		left_ = new BasisWithOperatorsType(*left_);
+		right_ = new BasisWithOperatorsType(*right_);
+		super_ = new SuperBlockType(*super_);
+		refCounter_ = 0;
+	}
+
 	template<typename SomeModelType>
 	void growLeftBlock(const SomeModelType& model,
 	                   BasisWithOperatorsType &pS,
@@ -233,12 +246,18 @@ public:
 	}
 
 	/*!PTEX_LABEL{setToProductLrs} */
-	void setToProduct(QnType quantumSector, SizeType initialSizeOfHashTable)
+	void setToProduct(QnType quantumSector,
+	                  SizeType initialSizeOfHashTable,
+	                  bool sectorOnly = false)
 	{
 		assert(left_);
 		assert(right_);
 		assert(super_);
-		super_->setToProduct(*left_, *right_, &quantumSector, initialSizeOfHashTable);
+		super_->setToProduct(*left_,
+		                     *right_,
+		                     &quantumSector,
+		                     initialSizeOfHashTable,
+		                     sectorOnly);
 	}
 
 	void write(PsimagLite::IoNg::Out& io,
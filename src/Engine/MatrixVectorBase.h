@@ -101,6 +101,9 @@ public:
 
 	void reflectionSector(SizeType) {  }
 
+	// single precision products are only available for the Kron matrix
+	bool lowPrecision(bool) { return false; }
+
 	void fullDiag(VectorRealType& eigs,FullMatrixType& fm) const;
 
 	static void fullDiag(VectorRealType& eigs,
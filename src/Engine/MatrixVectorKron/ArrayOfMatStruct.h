@@ -111,11 +111,24 @@ public:
 	                 bool useLowerPart)
 	    : data_(patchNew(leftOrRight).size(), patchOld(leftOrRight).size())
 	{
-		const SparseMatrixType& sparse = sparse1.getCRS();
 		const BasisType& basisOld = (leftOrRight == GenIjPatchType::LEFT) ?
 		            patchOld.lrs().left() : patchOld.lrs().right();
 		const BasisType& basisNew = (leftOrRight == GenIjPatchType::LEFT) ?
 		            patchNew.lrs().left() : patchNew.lrs().right();
+
+		if (!sparse1.justCRS() &&
+		        sameOffsets(sparse1.getBlocks().offsets(), basisOld) &&
+		        sameOffsets(sparse1.getBlocks().offsets(), basisNew)) {
+			fromBlocks(sparse1.getBlocks(),
+			           patchOld(leftOrRight),
+			           patchNew(leftOrRight),
+			           threshold,
+			           useLowerPart);
+			return;
+		}
+
+		SparseMatrixType crsFromBlocks;
+		const SparseMatrixType& sparse = sparse1.getCRS(crsFromBlocks);
 		const SizeType npatchOld = patchOld(leftOrRight).size();
 		const SizeType npatchNew = patchNew(leftOrRight).size();
 
@@ -466,6 +479,74 @@ public:
 
 private:
 
+	static bool sameOffsets(const VectorSizeType& offsets, const BasisType& basis)
+	{
+		const SizeType n = basis.partition();
+		if (offsets.size() != n) return false;
+		for (SizeType i = 0; i < n; ++i)
+			if (offsets[i] != basis.partition(i)) return false;
+		return true;
+	}
+
+	// patches copied from the blocks of the operator, see OperatorStorage;
+	// the groups of the patches are the partitions of the blocks
+	void fromBlocks(const typename OperatorStorageType::OperatorBlocksType& blocks,
+	                const VectorSizeType& groupsOld,
+	                const VectorSizeType& groupsNew,
+	                RealType threshold,
+	                bool useLowerPart)
+	{
+		const SizeType npatchNew = groupsNew.size();
+		const SizeType npatchOld = groupsOld.size();
+		for (SizeType jpatch = 0; jpatch < npatchOld; ++jpatch) {
+			for (SizeType ipatch = 0; ipatch < npatchNew; ++ipatch) {
+				data_(ipatch, jpatch) = 0;
+				if (useLowerPart && (ipatch < jpatch)) continue;
+
+				const SizeType igroup = groupsNew[ipatch];
+				const SizeType jgroup = groupsOld[jpatch];
+				if (!blocks.hasBlock(igroup, jgroup)) continue;
+
+				if (!blocks.isDense(igroup, jgroup)) {
+					const SparseMatrixType& m = blocks.sparse(igroup, jgroup);
+					const SizeType nnz = m.nonZeros();
+					if (nnz == 0) continue;
+
+					const bool isDense = (nnz >= threshold*m.rows()*m.cols());
+					data_(ipatch, jpatch) = new MatrixDenseOrSparseType(m.rows(),
+					                                                    m.cols(),
+					                                                    isDense,
+					                                                    nnz);
+					if (isDense)
+						crsMatrixToFullMatrix(data_(ipatch, jpatch)->getDense(), m);
+					else
+						data_(ipatch, jpatch)->getSparse() = m;
+					continue;
+				}
+
+				const MatrixType& m = blocks.dense(igroup, jgroup);
+				const SizeType lnrows = m.rows();
+				const SizeType lncols = m.cols();
+				SizeType nnz = 0;
+				for (SizeType j = 0; j < lncols; ++j)
+					for (SizeType i = 0; i < lnrows; ++i)
+						if (m(i, j) != static_cast<ComplexOrRealType>(0.0)) ++nnz;
+
+				if (nnz == 0) continue;
+
+				const bool isDense = (nnz >= threshold*lnrows*lncols);
+				data_(ipatch, jpatch) = new MatrixDenseOrSparseType(lnrows,
+				                                                    lncols,
+				                                                    isDense,
+				                                                    nnz);
+				if (isDense)
+					data_(ipatch, jpatch)->getDense() = m;
+				else
+					fullMatrixToCrsMatrix(data_(ipatch, jpatch)->getSparse(), m);
+			}
+		}
+	}
+
 	ArrayOfMatStruct(const ArrayOfMatStruct&) = delete;
 
 	ArrayOfMatStruct& operator=(const ArrayOfMatStruct&) = delete;
@@ -22,6 +22,10 @@ class BatchedGemm2 {
 	typedef PsimagLite::Vector<char>::Type VectorCharType;
 	typedef typename PsimagLite::Vector<ComplexOrRealType*>::Type VectorStarType;
 	typedef typename PsimagLite::Vector<const ComplexOrRealType*>::Type VectorConstStarType;
+	typedef typename PsimagLite::Vector<MatrixType>::Type VectorMatrixType;
+	typedef PsimagLite::Vector<bool>::Type VectorBoolType;
+	typedef typename InitKronType::SparseMatrixType SparseMatrixType;
+	typedef typename GenIjPatchType::BasisType BasisType;
 
 	static const int ialign_ = 32;
 	static const int idebug_ = 0; // set to 0 until it gives correct results
@@ -40,6 +44,11 @@ public:
 			progress_.printline(msgg, std::cout);
 		}
 
+		if (initKron_.useLowerPart()) {
+			constructLowerPart();
+			return;
+		}
+
 		SizeType npatches = initKron_.numberOfPatches(InitKronType::OLD);
 		SizeType noperator = initKron_.connections();
 
@@ -75,7 +84,6 @@ public:
 
 					if (!AsrcPtr) continue;
 
-					const MatrixType& Asrc =  AsrcPtr->dense();
 					SizeType igroup = initKron_.patch(InitKronType::NEW,
 					                                  GenIjPatchType::LEFT)[ipatch];
 					SizeType jgroup = initKron_.patch(InitKronType::NEW,
@@ -83,7 +91,7 @@ public:
 					int ia = initKron_.lrs(InitKronType::NEW).left().partition(igroup);
 					int ja = initKron_.lrs(InitKronType::NEW).left().partition(jgroup);
 
-					mylacpy(Asrc, Abatch_, ia, ja + ioperator*leftMaxState);
+					copyBlock(Abatch_, *AsrcPtr, ia, ja + ioperator*leftMaxState);
 				}
 			}
 		}
@@ -96,7 +104,6 @@ public:
 
 					if (!BsrcPtr) continue;
 
-					const MatrixType& Bsrc =  BsrcPtr->dense();
 					SizeType igroup = initKron_.patch(InitKronType::NEW,
 					                                  GenIjPatchType::RIGHT)[ipatch];
 					SizeType jgroup = initKron_.patch(InitKronType::NEW,
@@ -104,7 +111,7 @@ public:
 					int ib = initKron_.lrs(InitKronType::NEW).right().partition(igroup);
 					int jb = initKron_.lrs(InitKronType::NEW).right().partition(jgroup);
 
-					mylacpy(Bsrc, Bbatch_, ib, jb + ioperator*rightMaxState);
+					copyBlock(Bbatch_, *BsrcPtr, ib, jb + ioperator*rightMaxState);
 				}
 			}
 		}
@@ -154,6 +161,11 @@ public:
 		if (!enabled())
 			err("BatchedGemm::matrixVector called but BatchedGemm not enabled\n");
 
+		if (initKron_.useLowerPart()) {
+			matrixVectorLowerPart(vout, vin);
+			return;
+		}
+
 		/*
  ------------------
  compute  Y = H * X
@@ -283,6 +295,259 @@ public:
 
 private:
 
+	/*
+ ----------------------------------------------------------------------
+ Only the patch pairs (ipatch, jpatch) with ipatch >= jpatch are stored,
+ see ArrayOfMatStruct. For each operator k and input patch jpatch the
+ columns of jpatch are kept as a panel holding only the rows of the
+ patches ipatch >= jpatch, so that the panels take about half the memory
+ of Abatch and Bbatch. Because H is hermitian, the pairs with
+ ipatch < jpatch are applied as conjugate transposes of the stored ones.
+ ----------------------------------------------------------------------
+*/
+	void constructLowerPart()
+	{
+		SizeType npatches = initKron_.numberOfPatches(InitKronType::OLD);
+		SizeType noperator = initKron_.connections();
+
+		leftPatchStart_.resize(npatches, 0);
+		rightPatchStart_.resize(npatches, 0);
+		leftPatchSize_.resize(npatches, 0);
+		rightPatchSize_.resize(npatches, 0);
+
+		SizeType maxLeft = 0;
+		SizeType maxRight = 0;
+		for (SizeType ipatch = 0; ipatch < npatches; ++ipatch) {
+			SizeType igroup = initKron_.patch(InitKronType::NEW,
+			                                  GenIjPatchType::LEFT)[ipatch];
+			SizeType jgroup = initKron_.patch(InitKronType::NEW,
+			                                  GenIjPatchType::RIGHT)[ipatch];
+			const BasisType& left = initKron_.lrs(InitKronType::NEW).left();
+			const BasisType& right = initKron_.lrs(InitKronType::NEW).right();
+			leftPatchStart_[ipatch] = left.partition(igroup);
+			leftPatchSize_[ipatch] = left.partition(igroup + 1) - left.partition(igroup);
+			rightPatchStart_[ipatch] = right.partition(jgroup);
+			rightPatchSize_[ipatch] = right.partition(jgroup + 1) - right.partition(jgroup);
+			maxLeft = std::max(maxLeft, leftPatchSize_[ipatch]);
+			maxRight = std::max(maxRight, rightPatchSize_[ipatch]);
+		}
+
+		// rows of panel jpatch cover the patches ipatch >= jpatch
+		panelLeftStart_.resize(npatches, 0);
+		panelRightStart_.resize(npatches, 0);
+		VectorSizeType panelLeftEnd(npatches, 0);
+		VectorSizeType panelRightEnd(npatches, 0);
+		for (SizeType jpatch = 0; jpatch < npatches; ++jpatch) {
+			panelLeftStart_[jpatch] = leftPatchStart_[jpatch];
+			panelRightStart_[jpatch] = rightPatchStart_[jpatch];
+			for (SizeType ipatch = jpatch; ipatch < npatches; ++ipatch) {
+				panelLeftStart_[jpatch] = std::min(panelLeftStart_[jpatch],
+				                                   leftPatchStart_[ipatch]);
+				panelRightStart_[jpatch] = std::min(panelRightStart_[jpatch],
+				                                    rightPatchStart_[ipatch]);
+				panelLeftEnd[jpatch] = std::max(panelLeftEnd[jpatch],
+				                                leftPatchStart_[ipatch] + leftPatchSize_[ipatch]);
+				panelRightEnd[jpatch] = std::max(panelRightEnd[jpatch],
+				                                 rightPatchStart_[ipatch] + rightPatchSize_[ipatch]);
+			}
+		}
+
+		panelA_.resize(noperator*npatches);
+		panelB_.resize(noperator*npatches);
+		hasPair_.resize(noperator*npatches*npatches, false);
+		SizeType elements = 0;
+		for (SizeType ioperator = 0; ioperator < noperator; ++ioperator) {
+			const ArrayOfMatStructType& xiStruct = initKron_.xc(ioperator);
+			const ArrayOfMatStructType& yiStruct = initKron_.yc(ioperator);
+			for (SizeType jpatch = 0; jpatch < npatches; ++jpatch) {
+				MatrixType& pa = panelA_[jpatch + ioperator*npatches];
+				MatrixType& pb = panelB_[jpatch + ioperator*npatches];
+				pa.resize(panelLeftEnd[jpatch] - panelLeftStart_[jpatch],
+				          leftPatchSize_[jpatch]);
+				pb.resize(panelRightEnd[jpatch] - panelRightStart_[jpatch],
+				          rightPatchSize_[jpatch]);
+				pa.setTo(0.0);
+				pb.setTo(0.0);
+				elements += pa.rows()*pa.cols() + pb.rows()*pb.cols();
+
+				for (SizeType ipatch = jpatch; ipatch < npatches; ++ipatch) {
+					const MatrixDenseOrSparseType* aPtr = xiStruct(ipatch, jpatch);
+					const MatrixDenseOrSparseType* bPtr = yiStruct(ipatch, jpatch);
+					if (!aPtr || !bPtr) continue;
+
+					hasPair_[ipatch + jpatch*npatches + ioperator*npatches*npatches] = true;
+					copyBlock(pa, *aPtr, leftPatchStart_[ipatch] - panelLeftStart_[jpatch], 0);
+					copyBlock(pb, *bPtr, rightPatchStart_[ipatch] - panelRightStart_[jpatch], 0);
+				}
+			}
+		}
+
+		SizeType leftMaxStates  = initKron_.lrs(InitKronType::NEW).left().size();
+		SizeType rightMaxStates = initKron_.lrs(InitKronType::NEW).right().size();
+		SizeType ldBX = ialign_ * iceil(rightMaxStates, ialign_);
+		BX_.resize(ldBX, leftMaxStates*noperator);
+		tmp_.resize(maxLeft*maxRight);
+
+		PsimagLite::OstringStream msgg(std::cout.precision());
+		PsimagLite::OstringStream::OstringStreamType& msg = msgg();
+		msg<<"Construction done, lower part only, panel elements="<<elements;
+		msg<<" instead of "<<(leftMaxStates*leftMaxStates + rightMaxStates*rightMaxStates)*noperator;
+		progress_.printline(msgg, std::cout);
+	}
+
+	// vout = H*vin using the stored pairs and their conjugate transposes
+	void matrixVectorLowerPart(VectorType& vout, const VectorType& vin) const
+	{
+		SizeType npatches = initKron_.numberOfPatches(InitKronType::OLD);
+		SizeType noperator = initKron_.connections();
+		SizeType ncolA = initKron_.lrs(InitKronType::NEW).left().size();
+		const ComplexOrRealType one = 1.0;
+		const ComplexOrRealType zero = 0.0;
+
+		BX_.setTo(0.0);
+		std::fill(vout.begin(), vout.end(), 0.0);
+
+		/*
+ ----------------------------------------------------------------
+ BX(panel rows, k*ncolA + Lj) = panelB(k, jpatch) * XJ
+ ----------------------------------------------------------------
+*/
+		for (SizeType jpatch = 0; jpatch < npatches; ++jpatch) {
+			long j1 = initKron_.offsetForPatches(InitKronType::NEW, jpatch);
+			int nrowX = rightPatchSize_[jpatch];
+			int ncolX = leftPatchSize_[jpatch];
+			for (SizeType k = 0; k < noperator; ++k) {
+				const MatrixType& pb = panelB_[jpatch + k*npatches];
+				if (pb.rows() == 0 || nrowX == 0 || ncolX == 0) continue;
+				psimag::BLAS::GEMM('N',
+				                   'N',
+				                   pb.rows(),
+				                   ncolX,
+				                   nrowX,
+				                   one,
+				                   &(pb(0, 0)),
+				                   pb.rows(),
+				                   &(vin[j1]),
+				                   nrowX,
+				                   zero,
+				                   &(BX_(panelRightStart_[jpatch],
+				                         k*ncolA + leftPatchStart_[jpatch])),
+				                   BX_.rows());
+			}
+		}
+
+		/*
+ ----------------------------------------------------------------
+ YI += BX(Ri, k*ncolA + Lj) * transpose(A(ipatch, jpatch)), jpatch <= ipatch
+ ----------------------------------------------------------------
+*/
+		for (SizeType ipatch = 0; ipatch < npatches; ++ipatch) {
+			long i1 = initKron_.offsetForPatches(InitKronType::NEW, ipatch);
+			int nrowYI = rightPatchSize_[ipatch];
+			int ncolYI = leftPatchSize_[ipatch];
+			for (SizeType jpatch = 0; jpatch <= ipatch; ++jpatch) {
+				for (SizeType k = 0; k < noperator; ++k) {
+					if (!hasPair_[ipatch + jpatch*npatches + k*npatches*npatches]) continue;
+					const MatrixType& pa = panelA_[jpatch + k*npatches];
+					psimag::BLAS::GEMM('N',
+					                   'T',
+					                   nrowYI,
+					                   ncolYI,
+					                   leftPatchSize_[jpatch],
+					                   one,
+					                   &(BX_(rightPatchStart_[ipatch],
+					                         k*ncolA + leftPatchStart_[jpatch])),
+					                   BX_.rows(),
+					                   &(pa(leftPatchStart_[ipatch] - panelLeftStart_[jpatch], 0)),
+					                   pa.rows(),
+					                   one,
+					                   &(vout[i1]),
+					                   nrowYI);
+				}
+			}
+		}
+
+		/*
+ ----------------------------------------------------------------
+ pairs jpatch < ipatch applied as conjugate transposes
+ YJ += conj( transpose(B(ipatch, jpatch)) * conj(XI) * A(ipatch, jpatch) )
+ ----------------------------------------------------------------
+*/
+		const bool isComplex = PsimagLite::IsComplexNumber<ComplexOrRealType>::True;
+		xconj_.resize(vin.size());
+		zconj_.resize(vin.size());
+		for (SizeType i = 0; i < vin.size(); ++i)
+			xconj_[i] = PsimagLite::conj(vin[i]);
+		std::fill(zconj_.begin(), zconj_.end(), 0.0);
+
+		for (SizeType jpatch = 0; jpatch < npatches; ++jpatch) {
+			long j1 = initKron_.offsetForPatches(InitKronType::NEW, jpatch);
+			int nrowZ = rightPatchSize_[jpatch];
+			int ncolZ = leftPatchSize_[jpatch];
+			for (SizeType ipatch = jpatch + 1; ipatch < npatches; ++ipatch) {
+				long i1 = initKron_.offsetForPatches(InitKronType::NEW, ipatch);
+				int nrowX = rightPatchSize_[ipatch];
+				int ncolX = leftPatchSize_[ipatch];
+				for (SizeType k = 0; k < noperator; ++k) {
+					if (!hasPair_[ipatch + jpatch*npatches + k*npatches*npatches]) continue;
+					const MatrixType& pa = panelA_[jpatch + k*npatches];
+					const MatrixType& pb = panelB_[jpatch + k*npatches];
+
+					// tmp = transpose(B(ipatch, jpatch)) * conj(XI)
+					psimag::BLAS::GEMM('T',
+					                   'N',
+					                   nrowZ,
+					                   ncolX,
+					                   nrowX,
+					                   one,
+					                   &(pb(rightPatchStart_[ipatch] - panelRightStart_[jpatch], 0)),
+					                   pb.rows(),
+					                   &(xconj_[i1]),
+					                   nrowX,
+					                   zero,
+					                   &(tmp_[0]),
+					                   nrowZ);
+
+					// ZJ += tmp * A(ipatch, jpatch)
+					psimag::BLAS::GEMM('N',
+					                   'N',
+					                   nrowZ,
+					                   ncolZ,
+					                   ncolX,
+					                   one,
+					                   &(tmp_[0]),
+					                   nrowZ,
+					                   &(pa(leftPatchStart_[ipatch] - panelLeftStart_[jpatch], 0)),
+					                   pa.rows(),
+					                   one,
+					                   &(zconj_[j1]),
+					                   nrowZ);
+				}
+			}
+		}
+
+		for (SizeType i = 0; i < vout.size(); ++i)
+			vout[i] += (isComplex) ? PsimagLite::conj(zconj_[i]) : zconj_[i];
+	}
+
+	// src, dense or sparse, goes to rows rowOffset, ... and
+	// columns colOffset, ... of dest
+	static void copyBlock(MatrixType& dest,
+	                      const MatrixDenseOrSparseType& src,
+	                      SizeType rowOffset,
+	                      SizeType colOffset)
+	{
+		if (src.isDense()) {
+			mylacpy(src.dense(), dest, rowOffset, colOffset);
+			return;
+		}
+
+		const SparseMatrixType& sparse = src.sparse();
+		for (SizeType i = 0; i < sparse.rows(); ++i)
+			for (int k = sparse.getRowPtr(i); k < sparse.getRowPtr(i + 1); ++k)
+				dest(i + rowOffset, sparse.getCol(k) + colOffset) = sparse.getValue(k);
+	}
+
 	static int iceil(int x, int n)
 	{
 		return (x + n - 1)/n;
@@ -307,6 +572,16 @@ private:
 	mutable MatrixType BX_;
 	VectorSizeType leftPatchSize_;
 	VectorSizeType rightPatchSize_;
+	VectorSizeType leftPatchStart_;
+	VectorSizeType rightPatchStart_;
+	VectorSizeType panelLeftStart_;
+	VectorSizeType panelRightStart_;
+	VectorMatrixType panelA_;
+	VectorMatrixType panelB_;
+	VectorBoolType hasPair_;
+	mutable VectorType tmp_;
+	mutable VectorType xconj_;
+	mutable VectorType zconj_;
 };
 }
 #endif // BATCHEDGEMM_H
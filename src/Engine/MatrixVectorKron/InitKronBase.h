@@ -81,6 +81,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "ArrayOfMatStruct.h"
 #include "Vector.h"
 #include "ProgressIndicator.h"
+#include "Parallelizer2.h"
 
 namespace Dmrg {
 
@@ -103,6 +104,7 @@ public:
 	typedef typename ArrayOfMatStructType::GenIjPatchType GenIjPatchType;
 	typedef typename PsimagLite::Vector<ArrayOfMatStructType*>::Type VectorArrayOfMatStructType;
 	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
+	typedef typename PsimagLite::Vector<VectorType>::Type VectorVectorType;
 	typedef typename ArrayOfMatStructType::VectorSizeType VectorSizeType;
 
 	enum WhatBasisEnum {OLD,  NEW};
@@ -254,7 +256,13 @@ protected:
 	                      const ProgramGlobals::FermionOrBosonEnum fermionOrBoson)
 	{
 		OperatorStorageType Ahat;
-		calculateAhat(Ahat.getCRSNonConst(), A.getCRS(), value, fermionOrBoson);
+		if (A.justCRS()) {
+			calculateAhat(Ahat.getCRSNonConst(), A.getCRS(), value, fermionOrBoson);
+		} else {
+			Ahat = A;
+			calculateAhat(Ahat.getBlocksNonConst(), value, fermionOrBoson);
+		}
+
 		ArrayOfMatStructType* x1 = new ArrayOfMatStructType(Ahat,
 		                                                    ijpatchesOld_,
 		                                                    *ijpatchesNew_,
@@ -311,21 +319,27 @@ protected:
 			setAndFixWeights(weights);
 	}
 
-	// -------------------
-	// copy xout(:) to vout(:)
-	// -------------------
-	void copyOut(VectorType& vout,
-	             const VectorType& xout,
-	             const VectorSizeType& vstart) const
+	// -------------------------------------------------------------
+	// precompute the copies between superblock order and patch order
+	// in superblock order a patch is a sizeLeft x sizeRight column-major
+	// block, in patch order it is its sizeRight x sizeLeft transpose
+	// -------------------------------------------------------------
+	void setUpCopyMaps(const VectorSizeType& vstart)
 	{
-		const VectorSizeType& permInverse = lrs(NEW).super().permutationInverse();
+		const BasisType& super = lrs(NEW).super();
 		SizeType offset1 = offset(NEW);
 		SizeType nl = lrs(NEW).left().hamiltonian().rows();
 		SizeType npatches = patch(NEW, GenIjPatchType::LEFT).size();
 		const BasisType& left = lrs(NEW).left();
 		const BasisType& right = lrs(NEW).right();
 
-		for( SizeType ipatch=0; ipatch < npatches; ++ipatch) {
+		patchSizeLeft_.resize(npatches);
+		patchSizeRight_.resize(npatches);
+		patchStart_.resize(npatches);
+		patchIsBlock_.resize(npatches);
+		gather_.resize(vstart[npatches]);
+
+		for (SizeType ipatch=0; ipatch < npatches; ++ipatch) {
 
 			SizeType igroup = patch(NEW, GenIjPatchType::LEFT)[ipatch];
 			SizeType jgroup = patch(NEW, GenIjPatchType::RIGHT)[ipatch];
@@ -339,6 +353,15 @@ protected:
 			SizeType left_offset = left.partition(igroup);
 			SizeType right_offset = right.partition(jgroup);
 
+			patchSizeLeft_[ipatch] = sizeLeft;
+			patchSizeRight_[ipatch] = sizeRight;
+
+			assert(left_offset + right_offset*nl < super.permutationSize());
+			const SizeType start = super.permutationInverse(left_offset +
+			                                                right_offset*nl) - offset1;
+			patchStart_[ipatch] = start;
+			bool isBlock = true;
+
 			for (SizeType ileft=0; ileft < sizeLeft; ++ileft) {
 				for (SizeType iright=0; iright < sizeRight; ++iright) {
 
@@ -346,23 +369,117 @@ protected:
 					SizeType j = iright + right_offset;
 
 					assert(i < nl);
-					assert(j < lrs(NEW).right().hamiltonian().rows());
+					assert(i + j*nl < super.permutationSize());
 
-					assert(i + j*nl < permInverse.size());
-
-					SizeType r = permInverse[i + j*nl];
-					assert( !(  (r < offset1) || (r >= (offset1 + size(NEW))) ) );
+					SizeType r = super.permutationInverse(i + j*nl);
+					assert(r >= offset1 && r - offset1 < size(NEW));
 
 					SizeType ip = vstart[ipatch] + (iright + ileft * sizeRight);
-					assert(ip < xout.size());
+					assert(ip < gather_.size());
 
-					assert(r >= offset1 && ((r - offset1) < vout.size()) );
-					vout[r-offset1] = xout[ip];
+					gather_[ip] = r - offset1;
+					if (r - offset1 != start + ileft + iright*sizeLeft)
+						isBlock = false;
 				}
 			}
+
+			patchIsBlock_[ipatch] = isBlock;
 		}
 	}
 
+	// -------------------
+	// copy full(:) to vector v of patchVector(:), full in superblock order
+	// -------------------
+	void copyToPatches(VectorType& patchVector,
+	                   const VectorType& full,
+	                   const VectorSizeType& vstart,
+	                   SizeType nvectors,
+	                   SizeType v) const
+	{
+		const SizeType npatches = patchStart_.size();
+		PsimagLite::CodeSectionParams codeParams = PsimagLite::Concurrency::codeSectionParams;
+		codeParams.npthreads = std::min(npatches,
+		                                PsimagLite::Concurrency::codeSectionParams.npthreads);
+		PsimagLite::Parallelizer2<> parallelizer2(codeParams);
+		parallelizer2.parallelFor(0,
+		                          npatches,
+		                          [&patchVector, &full, &vstart, nvectors, v, this]
+		                          (SizeType ipatch, SizeType) {
+			const SizeType sizeLeft = patchSizeLeft_[ipatch];
+			const SizeType sizeRight = patchSizeRight_[ipatch];
+			const SizeType patchSize = sizeLeft*sizeRight;
+			const SizeType ip = vstart[ipatch]*nvectors + v*patchSize;
+			assert(ip + patchSize <= patchVector.size());
+
+			if (patchIsBlock_[ipatch]) {
+				blockTranspose(patchVector, ip, full, patchStart_[ipatch], sizeLeft, sizeRight);
+				return;
+			}
+
+			const SizeType ip0 = vstart[ipatch];
+			for (SizeType k = 0; k < patchSize; ++k)
+				patchVector[ip + k] = full[gather_[ip0 + k]];
+		});
+	}
+
+	// -------------------
+	// copy vector v of patchVector(:) to full(:), full in superblock order
+	// -------------------
+	void copyFromPatches(VectorType& full,
+	                     const VectorType& patchVector,
+	                     const VectorSizeType& vstart,
+	                     SizeType nvectors,
+	                     SizeType v) const
+	{
+		const SizeType npatches = patchStart_.size();
+		PsimagLite::CodeSectionParams codeParams = PsimagLite::Concurrency::codeSectionParams;
+		codeParams.npthreads = std::min(npatches,
+		                                PsimagLite::Concurrency::codeSectionParams.npthreads);
+		PsimagLite::Parallelizer2<> parallelizer2(codeParams);
+		parallelizer2.parallelFor(0,
+		                          npatches,
+		                          [&full, &patchVector, &vstart, nvectors, v, this]
+		                          (SizeType ipatch, SizeType) {
+			const SizeType sizeLeft = patchSizeLeft_[ipatch];
+			const SizeType sizeRight = patchSizeRight_[ipatch];
+			const SizeType patchSize = sizeLeft*sizeRight;
+			const SizeType ip = vstart[ipatch]*nvectors + v*patchSize;
+			assert(ip + patchSize <= patchVector.size());
+
+			if (patchIsBlock_[ipatch]) {
+				blockTranspose(full, patchStart_[ipatch], patchVector, ip, sizeRight, sizeLeft);
+				return;
+			}
+
+			const SizeType ip0 = vstart[ipatch];
+			for (SizeType k = 0; k < patchSize; ++k)
+				full[gather_[ip0 + k]] = patchVector[ip + k];
+		});
+	}
+
+	// -------------------
+	// copy xout(:) to vout(:)
+	// -------------------
+	void copyOut(VectorType& vout,
+	             const VectorType& xout,
+	             const VectorSizeType& vstart) const
+	{
+		copyFromPatches(vout, xout, vstart, 1, 0);
+	}
+
+	// -------------------
+	// copy xout(:) to vout[v](:) for all v, xout in the layout of
+	// InitKronHamiltonian::copyIn for blocks
+	// -------------------
+	void copyOut(VectorVectorType& vout,
+	             const VectorType& xout,
+	             const VectorSizeType& vstart) const
+	{
+		const SizeType nvectors = vout.size();
+		for (SizeType v = 0; v < nvectors; ++v)
+			copyFromPatches(vout[v], xout, vstart, nvectors, v);
+	}
+
 private:
 
 	void setAndFixWeights(const VectorSizeType& weights)
@@ -378,6 +495,30 @@ private:
 		}
 	}
 
+	// dest(j + i*cols) = src(i + j*rows) for the rows x cols column-major
+	// matrix at src[srcOffset], in tiles that stay in cache
+	static void blockTranspose(VectorType& dest,
+	                           SizeType destOffset,
+	                           const VectorType& src,
+	                           SizeType srcOffset,
+	                           SizeType rows,
+	                           SizeType cols)
+	{
+		static const SizeType tile = 32;
+		for (SizeType j0 = 0; j0 < cols; j0 += tile) {
+			const SizeType j1 = std::min(j0 + tile, cols);
+			for (SizeType i0 = 0; i0 < rows; i0 += tile) {
+				const SizeType i1 = std::min(i0 + tile, rows);
+				for (SizeType i = i0; i < i1; ++i) {
+					ComplexOrRealType* d = &dest[destOffset + i*cols];
+					const ComplexOrRealType* s = &src[srcOffset + i];
+					for (SizeType j = j0; j < j1; ++j)
+						d[j] = s[j*rows];
+				}
+			}
+		}
+	}
+
 	static SizeType sizeInternal(const GenIjPatchType& ijpatches,
 	                             SizeType m)
 	{
@@ -414,6 +555,45 @@ private:
 		}
 	}
 
+	// the same for blocked storage, see OperatorStorage
+	void calculateAhat(typename OperatorStorageType::OperatorBlocksType& Ahat,
+	                   ComplexOrRealType val,
+	                   ProgramGlobals::FermionOrBosonEnum bosonOrFermion) const
+	{
+		typedef typename OperatorStorageType::MatrixType MatrixType;
+		typedef typename OperatorStorageType::OperatorBlocksType::SparseMatrixType
+		        BlockSparseMatrixType;
+
+		const VectorSizeType& offsets = Ahat.offsets();
+		const SizeType n = Ahat.patches();
+		assert(signsNew_.size() >= Ahat.rows());
+		for (SizeType ipatch = 0; ipatch < n; ++ipatch) {
+			for (SizeType jpatch = 0; jpatch < n; ++jpatch) {
+				if (!Ahat.hasBlock(ipatch, jpatch)) continue;
+
+				const bool isDense = Ahat.isDense(ipatch, jpatch);
+				const SizeType rows = (isDense) ? Ahat.dense(ipatch, jpatch).rows() :
+				                                  Ahat.sparse(ipatch, jpatch).rows();
+				for (SizeType r = 0; r < rows; ++r) {
+					const SizeType i = r + offsets[ipatch];
+					RealType sign = (bosonOrFermion ==
+					                 ProgramGlobals::FermionOrBosonEnum::FERMION &&
+					                 signsNew_[i]) ? -1.0 : 1.0;
+					if (!isDense) {
+						BlockSparseMatrixType& m = Ahat.sparse(ipatch, jpatch);
+						for (int k = m.getRowPtr(r); k < m.getRowPtr(r + 1); ++k)
+							m.setValues(k, m.getValue(k)*sign*val);
+						continue;
+					}
+
+					MatrixType& m = Ahat.dense(ipatch, jpatch);
+					for (SizeType c = 0; c < m.cols(); ++c)
+						m(r, c) *= sign*val;
+				}
+			}
+		}
+	}
+
 	SizeType lSizeFunction(WhatBasisEnum what,
 	                       SizeType ipatch) const
 	{
@@ -446,6 +626,11 @@ private:
 	VectorArrayOfMatStructType yc_;
 	VectorBoolType signsNew_;
 	bool wftMode_;
+	VectorSizeType patchSizeLeft_;
+	VectorSizeType patchSizeRight_;
+	VectorSizeType patchStart_;
+	VectorBoolType patchIsBlock_;
+	VectorSizeType gather_;
 };
 } // namespace Dmrg
 
@@ -81,6 +81,8 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "InitKronBase.h"
 #include "Vector.h"
 #include "Profiling.h"
+#include "GemmR.h"
+#include "Concurrency.h"
 
 namespace Dmrg {
 
@@ -106,7 +108,10 @@ public:
 	typedef typename ArrayOfMatStructType::GenIjPatchType GenIjPatchType;
 	typedef typename PsimagLite::Vector<ArrayOfMatStructType*>::Type VectorArrayOfMatStructType;
 	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
+	typedef typename BaseType::VectorVectorType VectorVectorType;
 	typedef typename ArrayOfMatStructType::VectorSizeType VectorSizeType;
+	typedef PsimagLite::GemmR<ComplexOrRealType> GemmRType;
+	typedef typename PsimagLite::Vector<GemmRType*>::Type VectorGemmRType;
 
 	InitKronHamiltonian(const ModelType& model,
 	                    const HamiltonianConnectionType& hc,
@@ -115,12 +120,14 @@ public:
 	               aux.m(),
 	               hc.modelHelper().quantumNumber(aux.m()),
 	               model.params().denseSparseThreshold,
-	               !model.params().options.isSet("KronNoUseLowerPart")
-	               && !model.params().options.isSet("BatchedGemm")),
+	               useLowerPart(model)),
 	      model_(model),
 	      hc_(hc),
 	      vstart_(BaseType::patch(BaseType::NEW, GenIjPatchType::LEFT).size() + 1),
-	      offsetForPatches_(BaseType::patch(BaseType::NEW, GenIjPatchType::LEFT).size() + 1)
+	      offsetForPatches_(BaseType::patch(BaseType::NEW, GenIjPatchType::LEFT).size() + 1),
+	      products_(0),
+	      allocations_(0),
+	      steadyAllocations_(0)
 	{
 		addHlAndHr();
 
@@ -137,6 +144,26 @@ public:
 		yin_.resize(nsize, 0.0);
 		xout_.resize(nsize, 0.0);
 		BaseType::computeOffsets(offsetForPatches_, BaseType::NEW);
+		BaseType::setUpCopyMaps(vstart_);
+
+		// one GemmR per thread, reused by all matrix vector products
+		static const bool needsPrinting = false;
+		SizeType threads = std::max(PsimagLite::Concurrency::codeSectionParams.npthreads,
+		                            static_cast<SizeType>(1));
+		gemmR_.resize(threads, 0);
+		for (SizeType i = 0; i < threads; ++i)
+			gemmR_[i] = new GemmRType(needsPrinting, gemmRnb(), nthreads2());
+
+		blockWorkspace_.resize(threads);
+		blockCapacity_.resize(threads, 0);
+	}
+
+	~InitKronHamiltonian()
+	{
+		for (SizeType i = 0; i < gemmR_.size(); ++i) {
+			delete gemmR_[i];
+			gemmR_[i] = 0;
+		}
 	}
 
 	bool isWft() const {return false; }
@@ -146,6 +173,11 @@ public:
 		return model_.params().options.isSet("KronLoadBalance");
 	}
 
+	bool workStealing() const
+	{
+		return model_.params().options.isSet("KronWorkStealing");
+	}
+
 	SizeType gemmRnb() const
 	{
 		return model_.params().gemmRnb;
@@ -162,70 +194,100 @@ public:
 	void copyIn(const VectorType& vout,
 	            const VectorType& vin)
 	{
-		VectorType& xout = xout_;
-		VectorType& yin = yin_;
-
-		const VectorSizeType& permInverse = BaseType::lrs(BaseType::NEW).super().permutationInverse();
-		const SparseMatrixType& leftH = BaseType::lrs(BaseType::NEW).left().hamiltonian().getCRS();
-		SizeType nl = leftH.rows();
-
-		SizeType offset = BaseType::offset(BaseType::NEW);
-		SizeType npatches = BaseType::patch(BaseType::NEW, GenIjPatchType::LEFT).size();
-		const BasisType& left = BaseType::lrs(BaseType::NEW).left();
-		const BasisType& right = BaseType::lrs(BaseType::NEW).right();
-
-		for (SizeType ipatch=0; ipatch < npatches; ++ipatch) {
+		++products_;
+		BaseType::copyToPatches(yin_, vin, vstart_, 1, 0);
+		BaseType::copyToPatches(xout_, vout, vstart_, 1, 0);
+	}
 
-			SizeType igroup = BaseType::patch(BaseType::NEW, GenIjPatchType::LEFT)[ipatch];
-			SizeType jgroup = BaseType::patch(BaseType::NEW, GenIjPatchType::RIGHT)[ipatch];
+	// -------------------
+	// copy vin[v](:) to yinBlock(:) for all v
+	// each patch holds its nvectors pieces one after the other
+	// -------------------
+	void copyIn(const VectorVectorType& vout,
+	            const VectorVectorType& vin)
+	{
+		const SizeType nvectors = vin.size();
+		assert(vout.size() == nvectors);
+		++products_;
+		resizeWorkspace(yinBlock_, yin_.size()*nvectors);
+		resizeWorkspace(xoutBlock_, xout_.size()*nvectors);
+
+		for (SizeType v = 0; v < nvectors; ++v) {
+			BaseType::copyToPatches(yinBlock_, vin[v], vstart_, nvectors, v);
+			BaseType::copyToPatches(xoutBlock_, vout[v], vstart_, nvectors, v);
+		}
+	}
 
-			assert(left.partition(igroup+1) >= left.partition(igroup));
-			SizeType sizeLeft =  left.partition(igroup+1) - left.partition(igroup);
+	// -------------------
+	// copy xout(:) to vout(:)
+	// -------------------
+	void copyOut(VectorType& vout) const
+	{
+		BaseType::copyOut(vout, xout_, vstart_);
+	}
 
-			assert(right.partition(jgroup+1) >= right.partition(jgroup));
-			SizeType sizeRight = right.partition(jgroup+1) - right.partition(jgroup);
+	// -------------------
+	// copy xoutBlock(:) to vout[v](:) for all v
+	// -------------------
+	void copyOut(VectorVectorType& vout) const
+	{
+		BaseType::copyOut(vout, xoutBlock_, vstart_);
+	}
 
-			SizeType left_offset = left.partition(igroup);
-			SizeType right_offset = right.partition(jgroup);
+	const VectorType& yin() const { return yin_; }
 
-			for (SizeType ileft=0; ileft < sizeLeft; ++ileft) {
-				for (SizeType iright=0; iright < sizeRight; ++iright) {
+	VectorType& xout() { return xout_; }
 
-					SizeType i = ileft + left_offset;
-					SizeType j = iright + right_offset;
+	const VectorType& yinBlock() const { return yinBlock_; }
 
-					SizeType ij = i + j * nl;
+	VectorType& xoutBlock() { return xoutBlock_; }
 
-					assert(i < nl);
-					assert(j < BaseType::lrs(BaseType::NEW).right().hamiltonian().rows());
+	// zeroed workspace of the size of xout(), kept across products
+	VectorType& xoutTmp()
+	{
+		resizeWorkspace(xoutTmp_, xout_.size());
+		std::fill(xoutTmp_.begin(), xoutTmp_.end(), 0.0);
+		return xoutTmp_;
+	}
 
-					assert(ij < permInverse.size());
+	GemmRType& gemmR(SizeType threadNum) const
+	{
+		if (threadNum >= gemmR_.size())
+			err("InitKronHamiltonian::gemmR(): thread " + ttos(threadNum) +
+			    " has no workspace\n");
+		return *gemmR_[threadNum];
+	}
 
-					SizeType r = permInverse[ ij ];
-					assert(!((r < offset) || (r >= (offset + BaseType::size(BaseType::NEW)))));
+	// op(B)*Y of all vectors in kronMultBlock, one per thread, grown when too small
+	VectorType& blockWorkspace(SizeType threadNum) const
+	{
+		if (threadNum >= blockWorkspace_.size())
+			err("InitKronHamiltonian::blockWorkspace(): thread " + ttos(threadNum) +
+			    " has no workspace\n");
+		return blockWorkspace_[threadNum];
+	}
 
-					SizeType ip = vstart_[ipatch] + (iright + ileft * sizeRight);
-					assert(ip < yin.size());
+	// growths of the buffers owned here (yin/xout blocks, xoutTmp, and the
+	// per thread kronMultBlock workspaces), in total and after the first product.
+	// Temporaries inside the KronUtil kernels and GemmR are not counted
+	SizeType workspaceBufferAllocations() const { return allocations_; }
 
-					assert( (r >= offset) && ((r-offset) < vin.size()) );
-					yin[ip] = vin[r-offset];
-					xout[ip] = vout[r-offset];
-				}
-			}
-		}
-	}
+	SizeType steadyStateBufferAllocations() const { return steadyAllocations_; }
 
-	// -------------------
-	// copy xout(:) to vout(:)
-	// -------------------
-	void copyOut(VectorType& vout) const
+	// counts the growths of the per thread workspaces during the last product;
+	// called after the threads have joined
+	void countThreadWorkspaces()
 	{
-		BaseType::copyOut(vout, xout_, vstart_);
+		for (SizeType i = 0; i < blockWorkspace_.size(); ++i) {
+			const SizeType capacity = blockWorkspace_[i].capacity();
+			if (capacity <= blockCapacity_[i]) continue;
+			blockCapacity_[i] = capacity;
+			++allocations_;
+			if (products_ > 1) ++steadyAllocations_;
+		}
 	}
 
-	const VectorType& yin() const { return yin_; }
-
-	VectorType& xout() { return xout_; }
+	SizeType products() const { return products_; }
 
 	const SizeType& offsetForPatches(typename BaseType::WhatBasisEnum,
 	                                 SizeType ind) const
@@ -241,6 +303,16 @@ public:
 
 private:
 
+	static bool useLowerPart(const ModelType& model)
+	{
+		if (model.params().options.isSet("KronNoUseLowerPart")) return false;
+#ifdef PLUGIN_SC
+		// the plugin needs all patch pairs
+		if (model.params().options.isSet("BatchedGemm")) return false;
+#endif
+		return true;
+	}
+
 	void addHlAndHr()
 	{
 		const RealType value = 1.0;
@@ -280,6 +352,16 @@ private:
 		}
 	}
 
+	void resizeWorkspace(VectorType& v, SizeType n)
+	{
+		if (v.capacity() < n) {
+			++allocations_;
+			if (products_ > 1) ++steadyAllocations_;
+		}
+
+		v.resize(n);
+	}
+
 	InitKronHamiltonian(const InitKronHamiltonian&);
 
 	InitKronHamiltonian& operator=(const InitKronHamiltonian&);
@@ -291,7 +373,16 @@ private:
 	VectorSizeType vstart_;
 	VectorType yin_;
 	VectorType xout_;
+	VectorType yinBlock_;
+	VectorType xoutBlock_;
+	VectorType xoutTmp_;
 	VectorSizeType offsetForPatches_;
+	VectorGemmRType gemmR_;
+	mutable VectorVectorType blockWorkspace_;
+	VectorSizeType blockCapacity_;
+	SizeType products_;
+	SizeType allocations_;
+	SizeType steadyAllocations_;
 };
 } // namespace Dmrg
 
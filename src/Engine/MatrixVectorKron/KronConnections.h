@@ -108,7 +108,16 @@ public:
 	KronConnections(InitKronType& initKron)
 	    : initKron_(initKron),
 	      x_(initKron.xout()),
-	      y_(initKron.yin())
+	      y_(initKron.yin()),
+	      nvectors_(1)
+	{}
+
+	// nvectors vectors at once, in the layout of initKron.xoutBlock()
+	KronConnections(InitKronType& initKron, SizeType nvectors)
+	    : initKron_(initKron),
+	      x_(initKron.xoutBlock()),
+	      y_(initKron.yinBlock()),
+	      nvectors_(nvectors)
 	{}
 
 	SizeType tasks() const
@@ -116,21 +125,33 @@ public:
 		return initKron_.numberOfPatches(InitKronType::NEW);
 	}
 
-	void doTask(SizeType outPatch, SizeType)
+	void doTask(SizeType outPatch, SizeType threadNum)
 	{
-		const bool isComplex = PsimagLite::IsComplexNumber<ComplexOrRealType>::True;
+		SizeType offsetX = initKron_.offsetForPatches(InitKronType::NEW, outPatch)*nvectors_;
+		assert(offsetX < x_.size());
+		doPatches(x_,
+		          offsetX,
+		          outPatch,
+		          0,
+		          initKron_.numberOfPatches(InitKronType::OLD),
+		          threadNum);
+	}
 
-		static const bool needsPrinting = false;
-		PsimagLite::GemmR<ComplexOrRealType> gemmR(needsPrinting,
-		                                           initKron_.gemmRnb(),
-		                                           initKron_.nthreads2());
+	// x(offsetX:) += contributions of inPatch in [inBegin, inEnd) to outPatch
+	// using the GemmR and the workspace of thread threadNum
+	void doPatches(VectorType& x,
+	               SizeType offsetX,
+	               SizeType outPatch,
+	               SizeType inBegin,
+	               SizeType inEnd,
+	               SizeType threadNum) const
+	{
+		const bool isComplex = PsimagLite::IsComplexNumber<ComplexOrRealType>::True;
+		PsimagLite::GemmR<ComplexOrRealType>& gemmR = initKron_.gemmR(threadNum);
 
 		SizeType nC = initKron_.connections();
-		SizeType total = initKron_.numberOfPatches(InitKronType::OLD);
-		SizeType offsetX = initKron_.offsetForPatches(InitKronType::NEW, outPatch);
-		assert(offsetX < x_.size());
-		for (SizeType inPatch=0;inPatch<total;++inPatch) {
-			SizeType offsetY = initKron_.offsetForPatches(InitKronType::OLD, inPatch);
+		for (SizeType inPatch=inBegin;inPatch<inEnd;++inPatch) {
+			SizeType offsetY = initKron_.offsetForPatches(InitKronType::OLD, inPatch)*nvectors_;
 			assert(offsetY < y_.size());
 			for (SizeType ic=0;ic<nC;++ic) {
 				const ArrayOfMatStructType& xiStruct = initKron_.xc(ic);
@@ -151,20 +172,40 @@ public:
 					initKron_.checks(*Amat, *Bmat, outPatch, inPatch);
 
 				const char opt = performTranspose ? (isComplex ? 'c': 't') : 'n';
-				kronMult(x_,
-				         offsetX,
-				         y_,
-				         offsetY,
-				         opt,
-				         opt,
-				         *Amat,
-				         *Bmat,
-				         initKron_.denseFlopDiscount(),
-				         gemmR);
+				if (nvectors_ == 1) {
+					kronMult(x,
+					         offsetX,
+					         y_,
+					         offsetY,
+					         opt,
+					         opt,
+					         *Amat,
+					         *Bmat,
+					         initKron_.denseFlopDiscount(),
+					         gemmR);
+					continue;
+				}
+
+				kronMultBlock(x,
+				              offsetX,
+				              y_,
+				              offsetY,
+				              nvectors_,
+				              opt,
+				              opt,
+				              *Amat,
+				              *Bmat,
+				              initKron_.denseFlopDiscount(),
+				              initKron_.blockWorkspace(threadNum),
+				              gemmR);
 			}
 		}
 	}
 
+	VectorType& x() { return x_; }
+
+	SizeType nvectors() const { return nvectors_; }
+
 	void sync() {}
 
 private:
@@ -177,7 +218,8 @@ private:
 
 	const InitKronType& initKron_;
 	VectorType& x_;
-	const VectorType& y_;	
+	const VectorType& y_;
+	SizeType nvectors_;
 }; //class KronConnections
 
 } // namespace PsimagLite
@@ -0,0 +1,194 @@
+#ifndef KRONCOSTMODEL_H
+#define KRONCOSTMODEL_H
+#include "Vector.h"
+#include "Matrix.h"
+#include "CrsMatrix.h"
+#include "GemmR.h"
+#include "ProgressIndicator.h"
+#include "MatrixDenseOrSparse.h"
+#include "Concurrency.h"
+#include "TypeToString.h"
+#include <fstream>
+#include <cctype>
+#include <unistd.h>
+
+namespace Dmrg {
+
+/* PSIDOC KronCostModel
+ Measures on this machine the time per flop of the dense Kronecker kernels
+ relative to the sparse ones, by timing kronMult on representative dense
+ and sparse factors of the scalar type of the run. With that ratio r, a dense
+ flop costs r sparse flops, so r is the denseFlopDiscount of
+ estimate\_kron\_cost, and a matrix is cheaper to store dense once its
+ density exceeds r, so r is also the DenseSparseThreshold of ArrayOfMatStruct.
+ The result is cached in a file, one line per host name, number of threads
+ and scalar type, and reused by later runs with the same key; only the root
+ rank writes the file. Delete the file to recalibrate.
+ */
+template<typename ComplexOrRealType>
+class KronCostModel {
+
+	typedef typename PsimagLite::Real<ComplexOrRealType>::Type RealType;
+	typedef PsimagLite::CrsMatrix<ComplexOrRealType> SparseMatrixType;
+	typedef MatrixDenseOrSparse<SparseMatrixType> MatrixDenseOrSparseType;
+	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
+	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixType;
+
+	static const SizeType BENCHMARK_SIZE = 96;
+	static const SizeType SPARSE_ONE_IN = 10;
+	static const SizeType MIN_MILLIS = 100;
+
+public:
+
+	KronCostModel(PsimagLite::String filename, SizeType threads)
+	    : progress_("KronCostModel"),
+	      filename_(filename),
+	      key_(makeKey(threads)),
+	      ratio_(0)
+	{
+		if (readCache()) {
+			print("read from " + filename_ + " for " + key_);
+			return;
+		}
+
+		ratio_ = measure();
+		if (!PsimagLite::Concurrency::root()) return;
+
+		writeCache();
+		print("measured and saved to " + filename_ + " for " + key_);
+	}
+
+	RealType denseFlopDiscount() const { return ratio_; }
+
+private:
+
+	// host:threads:scalar, without blanks
+	static PsimagLite::String makeKey(SizeType threads)
+	{
+		char host[256];
+		PsimagLite::String hostname("unknown");
+		if (gethostname(host, sizeof(host)) == 0) {
+			host[sizeof(host) - 1] = '\0';
+			hostname = host;
+		}
+
+		for (SizeType i = 0; i < hostname.length(); ++i)
+			if (isspace(hostname[i])) hostname[i] = '_';
+
+		const bool isComplex = PsimagLite::IsComplexNumber<ComplexOrRealType>::True;
+		PsimagLite::String scalar = (sizeof(RealType) == sizeof(float)) ? "float" : "double";
+		if (isComplex) scalar = "complex<" + scalar + ">";
+
+		return hostname + ":" + ttos(threads) + ":" + scalar;
+	}
+
+	// lines are denseFlopDiscount key value; the last one with our key wins
+	bool readCache()
+	{
+		std::ifstream fin(filename_.c_str());
+		if (!fin) return false;
+
+		bool found = false;
+		PsimagLite::String label;
+		PsimagLite::String key;
+		RealType value = 0;
+		while (fin>>label>>key>>value) {
+			if (label != "denseFlopDiscount" || key != key_ || !(value > 0)) continue;
+			ratio_ = clamp(value);
+			found = true;
+		}
+
+		return found;
+	}
+
+	void writeCache()
+	{
+		std::ofstream fout(filename_.c_str(), std::ofstream::app);
+		if (!fout) {
+			print("WARNING: cannot write " + filename_);
+			return;
+		}
+
+		fout<<"denseFlopDiscount "<<key_<<" "<<ratio_<<"\n";
+	}
+
+	// time per dense flop over time per sparse flop
+	RealType measure() const
+	{
+		const SizeType n = BENCHMARK_SIZE;
+		MatrixType dense(n, n);
+		MatrixType sparse(n, n);
+		SizeType nnz = 0;
+		for (SizeType j = 0; j < n; ++j) {
+			for (SizeType i = 0; i < n; ++i) {
+				const ComplexOrRealType value = 1.0/(1.0 + ((i*7 + j*13) % 17));
+				dense(i, j) = value;
+				if ((i*31 + j*17) % SPARSE_ONE_IN != 0) continue;
+				sparse(i, j) = value;
+				++nnz;
+			}
+		}
+
+		// threshold 0 stores dense, threshold 2 stores sparse
+		MatrixDenseOrSparseType denseA(SparseMatrixType(dense), 0);
+		MatrixDenseOrSparseType sparseA(SparseMatrixType(sparse), 2);
+
+		// flops of one Kronecker product with both factors alike
+		const RealType flopsDense = 4.0*n*n*n;
+		const RealType flopsSparse = 4.0*nnz*n;
+
+		const RealType perFlopDense = timeOf(denseA)/flopsDense;
+		const RealType perFlopSparse = timeOf(sparseA)/flopsSparse;
+		if (!(perFlopSparse > 0)) return clamp(1);
+
+		return clamp(perFlopDense/perFlopSparse);
+	}
+
+	// milliseconds per kronMult of m with itself
+	static RealType timeOf(const MatrixDenseOrSparseType& m)
+	{
+		const SizeType n = m.rows();
+		VectorType y(n*n, 1.0);
+		VectorType x(n*n, 0.0);
+		static const bool needsPrinting = false;
+		PsimagLite::GemmR<ComplexOrRealType> gemmR(needsPrinting, 0, 1);
+
+		// warm up
+		kronMult(x, 0, y, 0, 'n', 'n', m, m, 1.0, gemmR);
+
+		SizeType reps = 0;
+		RealType millis = 0;
+		const PsimagLite::MemoryUsage::TimeHandle t1 = PsimagLite::ProgressIndicator::time();
+		while (millis < MIN_MILLIS) {
+			for (SizeType i = 0; i < 8; ++i)
+				kronMult(x, 0, y, 0, 'n', 'n', m, m, 1.0, gemmR);
+			reps += 8;
+			const PsimagLite::MemoryUsage::TimeHandle t2 = PsimagLite::ProgressIndicator::time();
+			millis = (t2 - t1).millis();
+		}
+
+		return millis/reps;
+	}
+
+	static RealType clamp(RealType value)
+	{
+		if (value < 0.01) return 0.01;
+		if (value > 1) return 1;
+		return value;
+	}
+
+	void print(PsimagLite::String what)
+	{
+		PsimagLite::OstringStream msgg(std::cout.precision());
+		PsimagLite::OstringStream::OstringStreamType& msg = msgg();
+		msg<<"denseFlopDiscount="<<ratio_<<" "<<what;
+		progress_.printline(msgg, std::cout);
+	}
+
+	PsimagLite::ProgressIndicator progress_;
+	PsimagLite::String filename_;
+	PsimagLite::String key_;
+	RealType ratio_;
+}; // class KronCostModel
+} // namespace Dmrg
+#endif // KRONCOSTMODEL_H
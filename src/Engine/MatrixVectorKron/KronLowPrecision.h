@@ -0,0 +1,214 @@
+#ifndef KRONLOWPRECISION_H
+#define KRONLOWPRECISION_H
+#include "Vector.h"
+#include "Matrix.h"
+#include "CrsMatrix.h"
+#include "GemmR.h"
+#include "Concurrency.h"
+#include "Parallelizer.h"
+#include "LoadBalancerWeights.h"
+#include "ProgressIndicator.h"
+#include "MatrixDenseOrSparse.h"
+
+namespace Dmrg {
+
+template<typename T>
+struct LowerPrecision {
+	typedef T Type;
+};
+
+template<>
+struct LowerPrecision<double> {
+	typedef float Type;
+};
+
+template<>
+struct LowerPrecision<std::complex<double> > {
+	typedef std::complex<float> Type;
+};
+
+/* PSIDOC KronLowPrecision
+ Single precision copy of the connections of KronMatrix, used for the
+ matrix vector products of Lanczos when mixed precision is requested, see
+ KronMixedPrecision in SolverOptions and bit 5 of the finite loops.
+ The patches of all operators are converted once, the first time they are needed;
+ each product converts the input vector to single precision, applies
+ the connections with the single precision Kron kernels, and adds the result to
+ the double precision output, so that the Lanczos recursion is still done
+ in double precision. When the whole build is float this class computes
+ in float as well, at no gain.
+ The patches are distributed with KronLoadBalance if set, but the single
+ precision products never use KronWorkStealing or BatchedGemm; these apply
+ only to the full precision products, including those of the refinement
+ that follows the single precision solve.
+ */
+template<typename InitKronType>
+class KronLowPrecision {
+
+	typedef typename InitKronType::ArrayOfMatStructType ArrayOfMatStructType;
+	typedef typename ArrayOfMatStructType::MatrixDenseOrSparseType MatrixDenseOrSparseType;
+	typedef typename MatrixDenseOrSparseType::value_type ComplexOrRealType;
+	typedef typename LowerPrecision<ComplexOrRealType>::Type LowComplexOrRealType;
+	typedef typename PsimagLite::Real<LowComplexOrRealType>::Type LowRealType;
+	typedef PsimagLite::CrsMatrix<LowComplexOrRealType> LowSparseMatrixType;
+	typedef MatrixDenseOrSparse<LowSparseMatrixType> LowMatrixDenseOrSparseType;
+	typedef PsimagLite::Matrix<LowMatrixDenseOrSparseType*> MatrixLowPointerType;
+	typedef typename PsimagLite::Vector<MatrixLowPointerType>::Type VectorMatrixLowPointerType;
+	typedef typename PsimagLite::Vector<LowComplexOrRealType>::Type LowVectorType;
+	typedef PsimagLite::GemmR<LowComplexOrRealType> LowGemmRType;
+	typedef typename PsimagLite::Vector<LowGemmRType*>::Type VectorLowGemmRType;
+
+public:
+
+	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
+
+	KronLowPrecision(InitKronType& initKron)
+	    : initKron_(initKron), progress_("KronLowPrecision")
+	{
+		const SizeType nC = initKron.connections();
+		const SizeType npatchNew = initKron.numberOfPatches(InitKronType::NEW);
+		const SizeType npatchOld = initKron.numberOfPatches(InitKronType::OLD);
+		xc_.resize(nC);
+		yc_.resize(nC);
+		for (SizeType ic = 0; ic < nC; ++ic) {
+			convert(xc_[ic], initKron.xc(ic), npatchNew, npatchOld);
+			convert(yc_[ic], initKron.yc(ic), npatchNew, npatchOld);
+		}
+
+		static const bool needsPrinting = false;
+		SizeType threads = std::max(PsimagLite::Concurrency::codeSectionParams.npthreads,
+		                            static_cast<SizeType>(1));
+		gemmR_.resize(threads, 0);
+		for (SizeType i = 0; i < threads; ++i)
+			gemmR_[i] = new LowGemmRType(needsPrinting,
+			                             initKron.gemmRnb(),
+			                             initKron.nthreads2());
+
+		PsimagLite::OstringStream msgg(std::cout.precision());
+		PsimagLite::OstringStream::OstringStreamType& msg = msgg();
+		msg<<"converted "<<nC<<" connections to single precision";
+		progress_.printline(msgg, std::cout);
+	}
+
+	~KronLowPrecision()
+	{
+		for (SizeType ic = 0; ic < xc_.size(); ++ic) {
+			destroy(xc_[ic]);
+			destroy(yc_[ic]);
+		}
+
+		for (SizeType i = 0; i < gemmR_.size(); ++i) {
+			delete gemmR_[i];
+			gemmR_[i] = 0;
+		}
+	}
+
+	void matrixVectorProduct(VectorType& vout, const VectorType& vin)
+	{
+		initKron_.copyIn(vout, vin);
+
+		const VectorType& yin = initKron_.yin();
+		y_.resize(yin.size());
+		for (SizeType i = 0; i < yin.size(); ++i)
+			y_[i] = static_cast<LowComplexOrRealType>(yin[i]);
+
+		VectorType& xout = initKron_.xout();
+		x_.resize(xout.size());
+		std::fill(x_.begin(), x_.end(), 0.0);
+
+		SizeType threads = PsimagLite::Concurrency::codeSectionParams.npthreads;
+		PsimagLite::CodeSectionParams codeSectionParams(threads);
+		if (initKron_.loadBalance()) {
+			PsimagLite::Parallelizer<KronLowPrecision,
+			        PsimagLite::LoadBalancerWeights> parallelizer(codeSectionParams);
+			parallelizer.loopCreate(*this, initKron_.weightsOfPatchesNew());
+		} else {
+			PsimagLite::Parallelizer<KronLowPrecision> parallelizer(codeSectionParams);
+			parallelizer.loopCreate(*this);
+		}
+
+		for (SizeType i = 0; i < xout.size(); ++i)
+			xout[i] += static_cast<ComplexOrRealType>(x_[i]);
+
+		initKron_.copyOut(vout);
+	}
+
+	SizeType tasks() const
+	{
+		return initKron_.numberOfPatches(InitKronType::NEW);
+	}
+
+	// the same as KronConnections::doTask, with the single precision copies
+	void doTask(SizeType outPatch, SizeType threadNum)
+	{
+		assert(threadNum < gemmR_.size());
+		const bool isComplex = PsimagLite::IsComplexNumber<ComplexOrRealType>::True;
+		const LowRealType denseFlopDiscount = initKron_.denseFlopDiscount();
+		const SizeType offsetX = initKron_.offsetForPatches(InitKronType::NEW, outPatch);
+		const SizeType npatchOld = initKron_.numberOfPatches(InitKronType::OLD);
+		const SizeType nC = xc_.size();
+		for (SizeType inPatch = 0; inPatch < npatchOld; ++inPatch) {
+			const SizeType offsetY = initKron_.offsetForPatches(InitKronType::OLD, inPatch);
+			const bool performTranspose = (initKron_.useLowerPart() && (outPatch < inPatch));
+			const SizeType row = (performTranspose) ? inPatch : outPatch;
+			const SizeType col = (performTranspose) ? outPatch : inPatch;
+			const char opt = performTranspose ? (isComplex ? 'c': 't') : 'n';
+			for (SizeType ic = 0; ic < nC; ++ic) {
+				const LowMatrixDenseOrSparseType* a = xc_[ic](row, col);
+				const LowMatrixDenseOrSparseType* b = yc_[ic](row, col);
+				if (!a || !b) continue;
+
+				kronMult(x_,
+				         offsetX,
+				         y_,
+				         offsetY,
+				         opt,
+				         opt,
+				         *a,
+				         *b,
+				         denseFlopDiscount,
+				         *gemmR_[threadNum]);
+			}
+		}
+	}
+
+private:
+
+	static void convert(MatrixLowPointerType& dest,
+	                    const ArrayOfMatStructType& src,
+	                    SizeType npatchNew,
+	                    SizeType npatchOld)
+	{
+		dest.resize(npatchNew, npatchOld);
+		for (SizeType jpatch = 0; jpatch < npatchOld; ++jpatch) {
+			for (SizeType ipatch = 0; ipatch < npatchNew; ++ipatch) {
+				const MatrixDenseOrSparseType* m = src(ipatch, jpatch);
+				dest(ipatch, jpatch) = (m) ? new LowMatrixDenseOrSparseType(*m) : 0;
+			}
+		}
+	}
+
+	static void destroy(MatrixLowPointerType& m)
+	{
+		for (SizeType j = 0; j < m.cols(); ++j) {
+			for (SizeType i = 0; i < m.rows(); ++i) {
+				delete m(i, j);
+				m(i, j) = 0;
+			}
+		}
+	}
+
+	KronLowPrecision(const KronLowPrecision&);
+
+	const KronLowPrecision& operator=(const KronLowPrecision&);
+
+	InitKronType& initKron_;
+	PsimagLite::ProgressIndicator progress_;
+	VectorMatrixLowPointerType xc_;
+	VectorMatrixLowPointerType yc_;
+	VectorLowGemmRType gemmR_;
+	LowVectorType y_;
+	LowVectorType x_;
+}; // class KronLowPrecision
+} // namespace Dmrg
+#endif // KRONLOWPRECISION_H
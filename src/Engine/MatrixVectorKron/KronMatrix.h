@@ -86,6 +86,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "PsimagLite.h"
 #include "ProgressIndicator.h"
 #include "LoadBalancerWeights.h"
+#include "KronWorkQueue.h"
 #ifdef PLUGIN_SC
 #include "BatchedGemmPluginSc.h"
 #else
@@ -102,19 +103,22 @@ class KronMatrix {
 	typedef KronConnections<InitKronType> KronConnectionsType;
 	typedef typename KronConnectionsType::MatrixType MatrixType;
 	typedef typename KronConnectionsType::VectorType VectorType;
+	typedef typename KronConnectionsType::VectorVectorType VectorVectorType;
 	typedef typename InitKronType::ArrayOfMatStructType ArrayOfMatStructType;
 	typedef typename InitKronType::GenIjPatchType GenIjPatchType;
 	typedef typename ArrayOfMatStructType::MatrixDenseOrSparseType MatrixDenseOrSparseType;
 	typedef typename PsimagLite::Vector<SizeType>::Type VectorSizeType;
 	typedef typename GenIjPatchType::BasisType BasisType;
 	typedef BatchedGemm2<InitKronType> BatchedGemmType;
+	typedef KronWorkQueue<KronConnectionsType, InitKronType> KronWorkQueueType;
 
 public:
 
 	KronMatrix(InitKronType& initKron, PsimagLite::String name)
 	    : initKron_(initKron),
 	      progress_("KronMatrix"),
-	      batchedGemm_(initKron)
+	      batchedGemm_(initKron),
+	      workQueue_(0)
 	{
 		PsimagLite::String str((initKron.loadBalance()) ? "true" : "false");
 		PsimagLite::OstringStream msgg(std::cout.precision());
@@ -123,6 +127,17 @@ public:
 		msg<<" "<<initKron.size(InitKronType::OLD);
 		msg<<" loadBalance "<<str;
 		progress_.printline(msgg, std::cout);
+
+		if (!initKron.workStealing() || batchedGemm_.enabled()) return;
+
+		SizeType threads = PsimagLite::Concurrency::codeSectionParams.npthreads;
+		workQueue_ = new KronWorkQueueType(initKron, threads);
+	}
+
+	~KronMatrix()
+	{
+		delete workQueue_;
+		workQueue_ = 0;
 	}
 
 	void matrixVectorProduct(VectorType& vout, const VectorType& vin) const
@@ -131,7 +146,7 @@ public:
 
 		if (batchedGemm_.enabled()) {
 			VectorType& xout = initKron_.xout();
-			VectorType xoutTmp(xout.size(), 0.0);
+			VectorType& xoutTmp = initKron_.xoutTmp();
 			batchedGemm_.matrixVector(xoutTmp, initKron_.yin());
 			for(SizeType i = 0; i < xoutTmp.size(); ++i)
 				xout[i] += xoutTmp[i];
@@ -141,6 +156,44 @@ public:
 		}
 
 		KronConnectionsType kc(initKron_);
+		runConnections(kc);
+
+		initKron_.copyOut(vout);
+	}
+
+	// vout[v] += H*vin[v] for all v, with one pass over the connections
+	void matrixMultiVectorProduct(VectorVectorType& vout, const VectorVectorType& vin) const
+	{
+		assert(vout.size() == vin.size());
+		if (vin.size() == 1 || batchedGemm_.enabled()) {
+			for (SizeType v = 0; v < vin.size(); ++v)
+				matrixVectorProduct(vout[v], vin[v]);
+			return;
+		}
+
+		initKron_.copyIn(vout, vin);
+
+		KronConnectionsType kc(initKron_, vin.size());
+		runConnections(kc);
+
+		initKron_.copyOut(vout);
+	}
+
+private:
+
+	KronMatrix(const KronMatrix&);
+
+	const KronMatrix& operator=(const KronMatrix&);
+
+	void runConnections(KronConnectionsType& kc) const
+	{
+		if (workQueue_) {
+			workQueue_->run(kc);
+			kc.sync();
+			initKron_.countThreadWorkspaces();
+			return;
+		}
+
 		SizeType threads = PsimagLite::Concurrency::codeSectionParams.npthreads;
 		PsimagLite::CodeSectionParams codeSectionParams(threads);
 
@@ -154,19 +207,13 @@ public:
 		}
 
 		kc.sync();
-
-		initKron_.copyOut(vout);
+		initKron_.countThreadWorkspaces();
 	}
 
-private:
-
-	KronMatrix(const KronMatrix&);
-
-	const KronMatrix& operator=(const KronMatrix&);
-
 	InitKronType& initKron_;
 	PsimagLite::ProgressIndicator progress_;
 	BatchedGemmType batchedGemm_;
+	KronWorkQueueType* workQueue_;
 }; //class KronMatrix
 
 } // namespace PsimagLite
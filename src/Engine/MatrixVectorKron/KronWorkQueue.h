@@ -0,0 +1,258 @@
+#ifndef KRONWORKQUEUE_H
+#define KRONWORKQUEUE_H
+#include "Vector.h"
+#include "Concurrency.h"
+#include "Parallelizer.h"
+#include "ProgressIndicator.h"
+#include <algorithm>
+
+namespace Dmrg {
+
+/* PSIDOC KronWorkQueue
+ Dynamic scheduling of the Kronecker products of KronMatrix, enabled with
+ KronWorkStealing in SolverOptions. The work of an output patch is the sum over
+ input patches and connections of one kronMult each; output patches whose
+ estimated cost exceeds a fair share are split into ranges of input patches.
+ The resulting units are sorted by decreasing cost, and each thread takes the
+ next unit from a shared queue when it is done with the previous one, so that
+ the large patches start first and the small ones fill the gaps.
+ Units that are part of a split patch are computed into a buffer of their
+ thread and then added to the output under a lock.
+ The time each thread waits for the slowest one is accumulated and printed
+ when the Kron matrix is destroyed.
+ */
+template<typename KronConnectionsType, typename InitKronType>
+class KronWorkQueue {
+
+	typedef typename KronConnectionsType::VectorType VectorType;
+	typedef typename VectorType::value_type ComplexOrRealType;
+	typedef typename InitKronType::ArrayOfMatStructType ArrayOfMatStructType;
+	typedef typename ArrayOfMatStructType::MatrixDenseOrSparseType MatrixDenseOrSparseType;
+	typedef typename PsimagLite::Vector<VectorType>::Type VectorVectorType;
+	typedef typename PsimagLite::Vector<double>::Type VectorDoubleType;
+	typedef PsimagLite::Concurrency ConcurrencyType;
+
+	// units per thread to aim for when splitting
+	static const SizeType UNITS_PER_THREAD = 4;
+
+	struct WorkUnit {
+
+		WorkUnit(SizeType o, SizeType b, SizeType e, double c, bool s)
+		    : outPatch(o), inBegin(b), inEnd(e), cost(c), split(s)
+		{}
+
+		bool operator<(const WorkUnit& other) const
+		{
+			return (cost > other.cost);
+		}
+
+		SizeType outPatch;
+		SizeType inBegin;
+		SizeType inEnd;
+		double cost;
+		bool split;
+	};
+
+	typedef typename PsimagLite::Vector<WorkUnit>::Type VectorWorkUnitType;
+
+public:
+
+	KronWorkQueue(const InitKronType& initKron, SizeType threads)
+	    : initKron_(initKron),
+	      progress_("KronWorkQueue"),
+	      threads_(std::max(threads, static_cast<SizeType>(1))),
+	      kc_(0),
+	      next_(0),
+	      buffer_(threads_),
+	      finish_(threads_, 0),
+	      idle_(threads_, 0),
+	      products_(0),
+	      start_(0, 0)
+	{
+		ConcurrencyType::mutexInit(&mutex_);
+		makeUnits();
+	}
+
+	~KronWorkQueue()
+	{
+		ConcurrencyType::mutexDestroy(&mutex_);
+		printIdle();
+	}
+
+	void run(KronConnectionsType& kc)
+	{
+		kc_ = &kc;
+		next_ = 0;
+		// a thread that gets no task counts as idle for the whole product
+		std::fill(finish_.begin(), finish_.end(), 0);
+		start_ = PsimagLite::ProgressIndicator::time();
+
+		PsimagLite::CodeSectionParams codeSectionParams(threads_);
+		PsimagLite::Parallelizer<KronWorkQueue> parallelizer(codeSectionParams);
+		parallelizer.loopCreate(*this);
+
+		double last = *std::max_element(finish_.begin(), finish_.end());
+		for (SizeType i = 0; i < threads_; ++i)
+			idle_[i] += last - finish_[i];
+
+		++products_;
+		kc_ = 0;
+	}
+
+	SizeType tasks() const { return threads_; }
+
+	void doTask(SizeType, SizeType threadNum)
+	{
+		assert(kc_);
+		assert(threadNum < threads_);
+		const SizeType nvectors = kc_->nvectors();
+		VectorType& x = kc_->x();
+
+		SizeType unit = 0;
+		while (takeNext(unit)) {
+			const WorkUnit& w = units_[unit];
+			SizeType offsetX = initKron_.offsetForPatches(InitKronType::NEW,
+			                                              w.outPatch)*nvectors;
+			if (!w.split) {
+				kc_->doPatches(x, offsetX, w.outPatch, w.inBegin, w.inEnd, threadNum);
+				continue;
+			}
+
+			const SizeType size = nvectors*
+			        (initKron_.offsetForPatches(InitKronType::NEW, w.outPatch + 1) -
+			         initKron_.offsetForPatches(InitKronType::NEW, w.outPatch));
+			VectorType& buffer = buffer_[threadNum];
+			if (buffer.size() < size) buffer.resize(size);
+			std::fill(buffer.begin(), buffer.begin() + size, 0.0);
+
+			kc_->doPatches(buffer, 0, w.outPatch, w.inBegin, w.inEnd, threadNum);
+
+			ConcurrencyType::mutexLock(&mutex_);
+			for (SizeType i = 0; i < size; ++i)
+				x[offsetX + i] += buffer[i];
+			ConcurrencyType::mutexUnlock(&mutex_);
+		}
+
+		// the latest exit of this thread, should it run more than one task
+		const PsimagLite::MemoryUsage::TimeHandle now = PsimagLite::ProgressIndicator::time();
+		const double millis = (now - start_).millis();
+		finish_[threadNum] = std::max(finish_[threadNum], millis);
+	}
+
+private:
+
+	bool takeNext(SizeType& unit)
+	{
+		ConcurrencyType::mutexLock(&mutex_);
+		unit = next_++;
+		ConcurrencyType::mutexUnlock(&mutex_);
+		return (unit < units_.size());
+	}
+
+	void makeUnits()
+	{
+		const SizeType npatches = initKron_.numberOfPatches(InitKronType::NEW);
+		const SizeType total = initKron_.numberOfPatches(InitKronType::OLD);
+
+		double grandTotal = 0;
+		typename PsimagLite::Vector<VectorDoubleType>::Type allCosts(npatches);
+		for (SizeType outPatch = 0; outPatch < npatches; ++outPatch) {
+			allCosts[outPatch].resize(total, 0);
+			for (SizeType inPatch = 0; inPatch < total; ++inPatch) {
+				allCosts[outPatch][inPatch] = cost(outPatch, inPatch);
+				grandTotal += allCosts[outPatch][inPatch];
+			}
+		}
+
+		const double share = grandTotal/(threads_*UNITS_PER_THREAD);
+
+		for (SizeType outPatch = 0; outPatch < npatches; ++outPatch) {
+			const VectorDoubleType& c = allCosts[outPatch];
+			double sum = 0;
+			for (SizeType inPatch = 0; inPatch < total; ++inPatch)
+				sum += c[inPatch];
+
+			if (sum <= share || total < 2) {
+				units_.push_back(WorkUnit(outPatch, 0, total, sum, false));
+				continue;
+			}
+
+			SizeType begin = 0;
+			double partial = 0;
+			for (SizeType inPatch = 0; inPatch < total; ++inPatch) {
+				partial += c[inPatch];
+				if (partial < share && inPatch + 1 < total) continue;
+				units_.push_back(WorkUnit(outPatch, begin, inPatch + 1, partial, true));
+				begin = inPatch + 1;
+				partial = 0;
+			}
+		}
+
+		std::sort(units_.begin(), units_.end());
+
+		PsimagLite::OstringStream msgg(std::cout.precision());
+		PsimagLite::OstringStream::OstringStreamType& msg = msgg();
+		msg<<"patches="<<npatches<<" units="<<units_.size()<<" threads="<<threads_;
+		progress_.printline(msgg, std::cout);
+	}
+
+	// estimated flops of all connections from inPatch to outPatch
+	double cost(SizeType outPatch, SizeType inPatch) const
+	{
+		const bool performTranspose = (initKron_.useLowerPart() && (outPatch < inPatch));
+		const SizeType row = (performTranspose) ? inPatch : outPatch;
+		const SizeType col = (performTranspose) ? outPatch : inPatch;
+		double sum = 0;
+		for (SizeType ic = 0; ic < initKron_.connections(); ++ic) {
+			const MatrixDenseOrSparseType* a = initKron_.xc(ic)(row, col);
+			const MatrixDenseOrSparseType* b = initKron_.yc(ic)(row, col);
+			if (!a || !b) continue;
+
+			// op(B)*Y then times op(A)^T
+			const SizeType colsOpA = (performTranspose) ? a->rows() : a->cols();
+			const SizeType rowsOpB = (performTranspose) ? b->cols() : b->rows();
+			sum += 2.0*(nonZeros(*b)*colsOpA + nonZeros(*a)*rowsOpB);
+		}
+
+		return sum;
+	}
+
+	double nonZeros(const MatrixDenseOrSparseType& m) const
+	{
+		if (!m.isDense())
+			return m.sparse().nonZeros();
+
+		return initKron_.denseFlopDiscount()*m.rows()*m.cols();
+	}
+
+	void printIdle()
+	{
+		if (products_ == 0) return;
+
+		PsimagLite::OstringStream msgg(std::cout.precision());
+		PsimagLite::OstringStream::OstringStreamType& msg = msgg();
+		msg<<"idle milliseconds per thread after "<<products_<<" products:";
+		for (SizeType i = 0; i < threads_; ++i)
+			msg<<" "<<idle_[i];
+		progress_.printline(msgg, std::cout);
+	}
+
+	KronWorkQueue(const KronWorkQueue&);
+
+	KronWorkQueue& operator=(const KronWorkQueue&);
+
+	const InitKronType& initKron_;
+	PsimagLite::ProgressIndicator progress_;
+	SizeType threads_;
+	KronConnectionsType* kc_;
+	SizeType next_;
+	VectorWorkUnitType units_;
+	VectorVectorType buffer_;
+	VectorDoubleType finish_;
+	VectorDoubleType idle_;
+	SizeType products_;
+	PsimagLite::MemoryUsage::TimeHandle start_;
+	ConcurrencyType::MutexType mutex_;
+}; // class KronWorkQueue
+} // namespace Dmrg
+#endif // KRONWORKQUEUE_H
@@ -83,7 +83,9 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Vector.h"
 #include "InitKronHamiltonian.h"
 #include "KronMatrix.h"
+#include "KronLowPrecision.h"
 #include "MatrixVectorBase.h"
+#include "ProgressIndicator.h"
 
 namespace Dmrg {
 template<typename ModelType_>
@@ -101,6 +103,7 @@ public:
 	typedef typename ModelHelperType::RealType RealType;
 	typedef InitKronHamiltonian<ModelType> InitKronType;
 	typedef KronMatrix<InitKronType> KronMatrixType;
+	typedef KronLowPrecision<InitKronType> KronLowPrecisionType;
 	typedef typename ModelHelperType::SparseMatrixType SparseMatrixType;
 	typedef typename SparseMatrixType::value_type ComplexOrRealType;
 	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
@@ -115,6 +118,8 @@ public:
 	    : params_(model.params()),
 	      initKron_(model, hc, aux),
 	      kronMatrix_(initKron_, "Hamiltonian"),
+	      lowPrecision_(0),
+	      useLowPrecision_(false),
 	      time_(0, 0)
 	{
 		int maxMatrixRankStored = model.params().maxMatrixRankStored;
@@ -128,7 +133,20 @@ public:
 
 	~MatrixVectorKron()
 	{
+		delete lowPrecision_;
+		lowPrecision_ = 0;
+
 		std::cout<<"DeltaClock matrixVectorProduct "<<time_.millis()<<"\n";
+
+		if (!params_.options.isSet("verbose")) return;
+
+		PsimagLite::ProgressIndicator progress("MatrixVectorKron");
+		PsimagLite::OstringStream msgg(std::cout.precision());
+		PsimagLite::OstringStream::OstringStreamType& msg = msgg();
+		msg<<"KronWorkspace buffer allocations "<<initKron_.workspaceBufferAllocations();
+		msg<<" steadyState "<<initKron_.steadyStateBufferAllocations();
+		msg<<" products "<<initKron_.products();
+		progress.printline(msgg, std::cout);
 	}
 
 	SizeType rows() const { return initKron_.size(InitKronType::NEW); }
@@ -140,6 +158,8 @@ public:
 
 		if (matrixStored_.rows() > 0)
 			matrixStored_.matrixVectorProduct(x,y);
+		else if (useLowPrecision_)
+			lowPrecision_->matrixVectorProduct(x,y);
 		else
 			kronMatrix_.matrixVectorProduct(x,y);
 
@@ -148,6 +168,38 @@ public:
 		time_ += deltaTime;
 	}
 
+	// x[v] += H*y[v] for all v; the Kron path goes through the connections once
+	void matrixMultiVectorProduct(typename PsimagLite::Vector<VectorType>::Type& x,
+	                              const typename PsimagLite::Vector<VectorType>::Type& y) const
+	{
+		const PsimagLite::MemoryUsage::TimeHandle time1 = PsimagLite::ProgressIndicator::time();
+
+		if (matrixStored_.rows() > 0) {
+			for (SizeType v = 0; v < y.size(); ++v)
+				matrixStored_.matrixVectorProduct(x[v], y[v]);
+		} else if (useLowPrecision_) {
+			for (SizeType v = 0; v < y.size(); ++v)
+				lowPrecision_->matrixVectorProduct(x[v], y[v]);
+		} else {
+			kronMatrix_.matrixMultiVectorProduct(x, y);
+		}
+
+		const PsimagLite::MemoryUsage::TimeHandle time2 = PsimagLite::ProgressIndicator::time();
+		const PsimagLite::MemoryUsage::TimeHandle deltaTime = time2 - time1;
+		time_ += deltaTime;
+	}
+
+	// products in single precision from now on if flag is set, see KronLowPrecision;
+	// returns true if the products are now in single precision
+	bool lowPrecision(bool flag)
+	{
+		useLowPrecision_ = (flag && matrixStored_.rows() == 0);
+		if (useLowPrecision_ && !lowPrecision_)
+			lowPrecision_ = new KronLowPrecisionType(initKron_);
+
+		return useLowPrecision_;
+	}
+
 	void fullDiag(VectorRealType& eigs,FullMatrixType& fm) const
 	{
 		BaseType::fullDiag(eigs, fm, matrixStored_, params_.maxMatrixRankStored);
@@ -187,6 +239,8 @@ private:
 	const ParametersType& params_;
 	InitKronType initKron_;
 	KronMatrixType kronMatrix_;
+	KronLowPrecisionType* lowPrecision_;
+	bool useLowPrecision_;
 	SparseMatrixType matrixStored_;
 	mutable PsimagLite::MemoryUsage::TimeHandle time_;
 }; // class MatrixVectorKron
@@ -125,6 +125,13 @@ public:
 			model_.matrixVectorProduct(x, y, hc_, aux_);
 	}
 
+	template<typename SomeVectorVectorType>
+	void matrixMultiVectorProduct(SomeVectorVectorType& x, const SomeVectorVectorType& y) const
+	{
+		for (SizeType v = 0; v < y.size(); ++v)
+			matrixVectorProduct(x[v], y[v]);
+	}
+
 	void fullDiag(VectorRealType& eigs,FullMatrixType& fm) const
 	{
 		int mrs = model_.params().maxMatrixRankStored;
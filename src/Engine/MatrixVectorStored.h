@@ -135,6 +135,13 @@ public:
 		matrixStored_[pointer_].matrixVectorProduct(x,y);
 	}
 
+	template<typename SomeVectorVectorType>
+	void matrixMultiVectorProduct(SomeVectorVectorType& x, const SomeVectorVectorType& y) const
+	{
+		for (SizeType v = 0; v < y.size(); ++v)
+			matrixStored_[pointer_].matrixVectorProduct(x[v], y[v]);
+	}
+
 	value_type operator()(SizeType i,SizeType j) const
 	{
 		return matrixStored_[pointer_](i,j);
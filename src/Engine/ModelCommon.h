@@ -133,6 +133,12 @@ public:
 		MyBasis::useSu2Symmetry(ModelHelperType::isSu2());
 		if (params.options.isSet("OperatorsChangeAll"))
 			OperatorsType::setChangeAll(true);
+
+		if (params.options.isSet("BatchedChangeOfBasis"))
+			OperatorsType::setBatchedChangeOfBasis(true);
+
+		if (params.options.isSet("BlockedOperatorStorage"))
+			OperatorsType::setBlockedStorage(true, params.denseSparseThreshold);
 	}
 
 	const ParametersType& params() const { return params_; }
@@ -109,12 +109,31 @@ public:
 	typedef typename PsimagLite::Vector<SparseMatrixType>::Type VectorSparseMatrixType;
 	typedef typename BasisType::QnType QnType;
 
+	// Maps the pair (left state, right state) to its row in the symmetry sector m,
+	// or to -1 if the pair is not in the sector.
+	// The states of a pair of left and right partitions are contiguous in the
+	// superblock, left index fastest, so only the offset of each pair of
+	// partitions in the sector is stored, and the row is obtained by offset arithmetic.
 	class Aux {
 
+		typedef PsimagLite::Vector<int>::Type VectorIntType;
+
 	public:
 
+		// the part of the map that depends only on the left state
+		struct LeftState {
+
+			LeftState(const int* o, SizeType l, SizeType s)
+			    : offsets(o), local(l), size(s)
+			{}
+
+			const int* offsets; // offset in the sector of each right partition, or -1
+			SizeType local;     // index of the left state in its partition
+			SizeType size;      // size of its partition
+		};
+
 		Aux(SizeType m, const LeftRightSuperType& lrs) :
-		    m_(m), buffer_(lrs.left().size())
+		    m_(m), npe_(0)
 
 		{
 			createBuffer(lrs);
@@ -125,15 +144,23 @@ public:
 
 		int buffer(SizeType i, SizeType j) const
 		{
-			assert(i < buffer_.size());
-			assert(j < buffer_[i].size());
-			return buffer_[i][j];
+			return buffer(leftState(i), j);
+		}
+
+		LeftState leftState(SizeType i) const
+		{
+			assert(i < leftPartition_.size());
+			const SizeType ps = leftPartition_[i];
+			assert(ps < leftSizes_.size());
+			return LeftState(&(patchOffsets_[ps*npe_]), leftLocal_[i], leftSizes_[ps]);
 		}
 
-		const PsimagLite::Vector<int>::Type& buffer(SizeType i) const
+		int buffer(const LeftState& left, SizeType j) const
 		{
-			assert(i < buffer_.size());
-			return buffer_[i];
+			assert(j < rightPartition_.size());
+			const int offset = left.offsets[rightPartition_[j]];
+			if (offset < 0) return -1;
+			return offset + left.local + rightLocal_[j]*left.size;
 		}
 
 		SizeType alpha(SizeType i) const
@@ -158,19 +185,48 @@ public:
 
 		void createBuffer(const LeftRightSuperType& lrs)
 		{
-			SizeType ns = lrs.left().size();
-			SizeType ne = lrs.right().size();
+			const BasisType& left = lrs.left();
+			const BasisType& right = lrs.right();
+			const SizeType ns = left.size();
+			const SizeType nps = left.partition() - 1;
+			npe_ = right.partition() - 1;
 			int offset = lrs.super().partition(m_);
 			int total = lrs.super().partition(m_+1) - offset;
 
-			typename PsimagLite::Vector<int>::Type  tmpBuffer(ne);
-			for (SizeType alphaPrime=0;alphaPrime<ns;alphaPrime++) {
-				for (SizeType betaPrime=0;betaPrime<ne;betaPrime++) {
-					tmpBuffer[betaPrime] = lrs.super().
-					        permutationInverse(alphaPrime + betaPrime*ns) -offset;
-					if (tmpBuffer[betaPrime]>=total) tmpBuffer[betaPrime]= -1;
+			createPartitionOf(leftPartition_, leftLocal_, left);
+			createPartitionOf(rightPartition_, rightLocal_, right);
+
+			leftSizes_.resize(nps);
+			for (SizeType ps = 0; ps < nps; ++ps)
+				leftSizes_[ps] = left.partition(ps + 1) - left.partition(ps);
+
+			// a pair of partitions is in the sector if its first state is
+			patchOffsets_.resize(nps*npe_);
+			for (SizeType ps = 0; ps < nps; ++ps) {
+				for (SizeType pe = 0; pe < npe_; ++pe) {
+					const SizeType first = left.partition(ps) + right.partition(pe)*ns;
+					int x = lrs.super().permutationInverse(first) - offset;
+					if (x < 0 || x >= total) x = -1;
+					patchOffsets_[pe + ps*npe_] = x;
+				}
+			}
+		}
+
+		static void createPartitionOf(VectorSizeType& partitionOf,
+		                              VectorSizeType& local,
+		                              const BasisType& basis)
+		{
+			const SizeType n = basis.size();
+			const SizeType np = basis.partition() - 1;
+			partitionOf.resize(n);
+			local.resize(n);
+			for (SizeType p = 0; p < np; ++p) {
+				const SizeType start = basis.partition(p);
+				const SizeType end = basis.partition(p + 1);
+				for (SizeType i = start; i < end; ++i) {
+					partitionOf[i] = p;
+					local[i] = i - start;
 				}
-				buffer_[alphaPrime]=tmpBuffer;
 			}
 		}
 
@@ -193,7 +249,13 @@ public:
 		}
 
 		SizeType m_;
-		typename PsimagLite::Vector<PsimagLite::Vector<int>::Type>::Type buffer_;
+		SizeType npe_;
+		VectorIntType patchOffsets_;
+		VectorSizeType leftPartition_;
+		VectorSizeType leftLocal_;
+		VectorSizeType leftSizes_;
+		VectorSizeType rightPartition_;
+		VectorSizeType rightLocal_;
 		VectorSizeType alpha_;
 		VectorSizeType beta_;
 		typename PsimagLite::Vector<bool>::Type fermionSigns_;
@@ -275,14 +337,16 @@ public:
 	}
 
 	// Does x+= (AB)y, where A belongs to pSprime and B  belongs to pEprime or
-	// viceversa (inter)
+	// viceversa (inter), for the rows of x in [rowBegin, rowEnd)
 	// Has been changed to accomodate for reflection symmetry
 	void fastOpProdInter(VectorSparseElementType& x,
 	                     const VectorSparseElementType& y,
 	                     const SparseMatrixType& A,
 	                     const SparseMatrixType& B,
 	                     const LinkType& link,
-	                     const Aux& aux) const
+	                     const Aux& aux,
+	                     SizeType rowBegin,
+	                     SizeType rowEnd) const
 	{
 		RealType fermionSign =  (link.fermionOrBoson == ProgramGlobals::FermionOrBosonEnum::FERMION)
 		        ? -1 : 1;
@@ -291,16 +355,15 @@ public:
 			LinkType link2 = link;
 			link2.value *= fermionSign;
 			link2.type = ProgramGlobals::ConnectionEnum::SYSTEM_ENVIRON;
-			fastOpProdInter(x, y, B, A, link2, aux);
+			fastOpProdInter(x, y, B, A, link2, aux, rowBegin, rowEnd);
 			return;
 		}
 
 		//! work only on partition m
-		int m = aux.m();
-		int offset = lrs_.super().partition(m);
-		int total = lrs_.super().partition(m + 1) - offset;
+		assert(rowEnd <= lrs_.super().partition(aux.m() + 1) -
+		       lrs_.super().partition(aux.m()));
 
-		for (int i=0;i<total;++i) {
+		for (SizeType i = rowBegin; i < rowEnd; ++i) {
 			// row i of the ordered product basis
 			int alpha = aux.alpha(i);
 			int beta = aux.beta(i);
@@ -321,12 +384,11 @@ public:
 			for (int k=startk;k<endk;++k) {
 				int alphaPrime = A.getCol(k);
 				SparseElementType tmp2 = A.getValue(k) *fsValue;
-				const typename PsimagLite::Vector<int>::Type& bufferTmp =
-				        aux.buffer(alphaPrime);
+				const typename Aux::LeftState leftState = aux.leftState(alphaPrime);
 
 				for (int kk=startkk;kk<endkk;++kk) {
 					int betaPrime= B.getCol(kk);
-					int j = bufferTmp[betaPrime];
+					int j = aux.buffer(leftState, betaPrime);
 					if (j<0) continue;
 
 					SparseElementType tmp = tmp2 * B.getValue(kk);
@@ -341,22 +403,24 @@ public:
 	// Let H_{alpha,beta; alpha',beta'} =
 	// basis2.hamiltonian_{alpha,alpha'} \delta_{beta,beta'}
 	// Let H_m be  the m-th block (in the ordering of basis1) of H
-	// Then, this function does x += H_m * y
+	// Then, this function does x += H_m * y, for the rows of x in [rowBegin, rowEnd)
 	// This is a performance critical function
 	// Has been changed to accomodate for reflection symmetry
 	void hamiltonianLeftProduct(VectorSparseElementType& x,
 	                            const VectorSparseElementType& y,
-	                            const Aux& aux) const
+	                            const Aux& aux,
+	                            SizeType rowBegin,
+	                            SizeType rowEnd) const
 	{
 		int m = aux.m();
 		int offset = lrs_.super().partition(m);
-		int i,k,alphaPrime;
-		int bs = lrs_.super().partition(m+1)-offset;
+		int k,alphaPrime;
+		assert(rowEnd <= lrs_.super().partition(m+1)-offset);
 		const SparseMatrixType& hamiltonian = lrs_.left().hamiltonian().getCRS();
 		SizeType ns = lrs_.left().size();
 		SparseElementType sum = 0.0;
 		PackIndicesType pack(ns);
-		for (i=0;i<bs;i++) {
+		for (SizeType i = rowBegin; i < rowEnd; i++) {
 			SizeType r,beta;
 			pack.unpack(r,beta,lrs_.super().permutation(i+offset));
 
@@ -376,21 +440,23 @@ public:
 	// Let  H_{alpha,beta; alpha',beta'} =
 	// basis2.hamiltonian_{beta,beta'} \delta_{alpha,alpha'}
 	// Let H_m be  the m-th block (in the ordering of basis1) of H
-	// Then, this function does x += H_m * y
+	// Then, this function does x += H_m * y, for the rows of x in [rowBegin, rowEnd)
 	// This is a performance critical function
 	void hamiltonianRightProduct(VectorSparseElementType& x,
 	                             const VectorSparseElementType& y,
-	                             const Aux& aux) const
+	                             const Aux& aux,
+	                             SizeType rowBegin,
+	                             SizeType rowEnd) const
 	{
 		int m = aux.m();
 		int offset = lrs_.super().partition(m);
-		int i,k;
-		int bs = lrs_.super().partition(m+1)-offset;
+		int k;
+		assert(rowEnd <= lrs_.super().partition(m+1)-offset);
 		const SparseMatrixType& hamiltonian = lrs_.right().hamiltonian().getCRS();
 		SizeType ns = lrs_.left().size();
 		SparseElementType sum = 0.0;
 		PackIndicesType pack(ns);
-		for (i=0;i<bs;i++) {
+		for (SizeType i = rowBegin; i < rowEnd; i++) {
 			SizeType alpha,r;
 			pack.unpack(alpha,r,lrs_.super().permutation(i+offset));
 
@@ -0,0 +1,131 @@
+/*
+Copyright (c) 2009-2020, UT-Battelle, LLC
+All rights reserved
+
+[DMRG++, Version 5.]
+[by G.A., Oak Ridge National Laboratory]
+
+UT Battelle Open Source Software License 11242008
+
+OPEN SOURCE LICENSE
+
+Subject to the conditions of this License, each
+contributor to this software hereby grants, free of
+charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), a
+perpetual, worldwide, non-exclusive, no-charge,
+royalty-free, irrevocable copyright license to use, copy,
+modify, merge, publish, distribute, and/or sublicense
+copies of the Software.
+
+1. Redistributions of Software must retain the above
+copyright and license notices, this list of conditions,
+and the following disclaimer.  Changes or modifications
+to, or derivative works of, the Software should be noted
+with comments and the contributor and organization's
+name.
+
+2. Neither the names of UT-Battelle, LLC or the
+Department of Energy nor the names of the Software
+contributors may be used to endorse or promote products
+derived from this software without specific prior written
+permission of UT-Battelle.
+
+3. The software and the end-user documentation included
+with the redistribution, with or without modification,
+must include the following acknowledgment:
+
+"This product includes software produced by UT-Battelle,
+LLC under Contract No. DE-AC05-00OR22725  with the
+Department of Energy."
+
+*********************************************************
+DISCLAIMER
+
+THE SOFTWARE IS SUPPLIED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER, CONTRIBUTORS, UNITED STATES GOVERNMENT,
+OR THE UNITED STATES DEPARTMENT OF ENERGY BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+NEITHER THE UNITED STATES GOVERNMENT, NOR THE UNITED
+STATES DEPARTMENT OF ENERGY, NOR THE COPYRIGHT OWNER, NOR
+ANY OF THEIR EMPLOYEES, REPRESENTS THAT THE USE OF ANY
+INFORMATION, DATA, APPARATUS, PRODUCT, OR PROCESS
+DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
+
+*********************************************************
+
+
+*/
+/** \ingroup DMRG */
+/*@{*/
+/** \file NestedThreads.h
+*/
+
+#ifndef NESTED_THREADS_H
+#define NESTED_THREADS_H
+#include "Concurrency.h"
+
+namespace Dmrg {
+
+/* PSIDOC NestedThreads
+ Nested threads for an outer parallel loop over tasks and the code that
+ each task runs, which reads Concurrency::codeSectionParams.npthreads, as the
+ Lanczos matrix vector product does. The outer loop gets outer() threads, up to
+ Threads=, and each task inner() threads, which are ThreadsLevelTwo=, as for
+ the other nested parallel sections of DMRG++; npthreads is set to inner()
+ for the lifetime of this object, and restored when it goes out of scope,
+ even if a task throws. Create it on the calling
+ thread, before the outer loop starts, and let it go out of scope after the
+ loop has joined its threads, so that no other thread reads npthreads while
+ it changes.
+ */
+class NestedThreads {
+
+	typedef PsimagLite::Concurrency ConcurrencyType;
+
+public:
+
+	explicit NestedThreads(SizeType tasks)
+	    : savedNpthreads_(ConcurrencyType::codeSectionParams.npthreads),
+	      outer_(std::max(static_cast<SizeType>(1), std::min(tasks, savedNpthreads_))),
+	      inner_(std::max(static_cast<SizeType>(1),
+	                      ConcurrencyType::codeSectionParams.npthreadsLevelTwo))
+	{
+		ConcurrencyType::codeSectionParams.npthreads = inner_;
+	}
+
+	~NestedThreads()
+	{
+		ConcurrencyType::codeSectionParams.npthreads = savedNpthreads_;
+	}
+
+	SizeType outer() const { return outer_; }
+
+	SizeType inner() const { return inner_; }
+
+private:
+
+	NestedThreads(const NestedThreads&);
+
+	NestedThreads& operator=(const NestedThreads&);
+
+	SizeType savedNpthreads_;
+	SizeType outer_;
+	SizeType inner_;
+}; // class NestedThreads
+} // namespace Dmrg
+/*@}*/
+#endif // NESTED_THREADS_H
@@ -124,7 +124,12 @@ public:
 	      observe_(io, start, nf, trail, model.params())
 	{}
 
-	bool endOfData() const { return observe_.helper().endOfData(); }
+	// the caller may read the data file next, see ObserverHelper::joinPrefetch()
+	bool endOfData() const
+	{
+		observe_.helper().joinPrefetch();
+		return observe_.helper().endOfData();
+	}
 
 	const ModelType& model() const { return model_; }
 
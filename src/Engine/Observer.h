@@ -86,6 +86,8 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "VectorWithOffsets.h" // for operator*
 #include "VectorWithOffset.h" // for operator*
 #include "Parallel4PointDs.h"
+#include "ParallelManyPointCorrelations.h"
+#include "LoadBalancerWeights.h"
 #include "MultiPointCorrelations.h"
 #include "Concurrency.h"
 #include "Parallelizer.h"
@@ -120,6 +122,7 @@ public:
 	typedef ModelType_ ModelType;
 	typedef VectorWithOffsetType_ VectorWithOffsetType;
 	typedef Parallel4PointDs<ModelType,FourPointCorrelationsType> Parallel4PointDsType;
+	typedef typename FourPointCorrelationsType::VectorFieldType VectorFieldType;
 	typedef PsimagLite::Vector<PsimagLite::String>::Type VectorStringType;
 	typedef PsimagLite::PredicateAwesome<> PredicateAwesomeType;
 
@@ -151,6 +154,11 @@ public:
 		PsimagLite::String actionString_;
 	};
 
+	typedef ParallelManyPointCorrelations<FourPointCorrelationsType, ManyPointAction>
+	ParallelManyPointType;
+	typedef typename ParallelManyPointType::TaskType TaskType;
+	typedef typename ParallelManyPointType::VectorTaskType VectorTaskType;
+
 	Observer(IoInputType& io,
 	         SizeType start,
 	         SizeType nf,
@@ -160,7 +168,8 @@ public:
 	              start,
 	              nf,
 	              trail,
-	              !params.options.isSet("fixLegacyBugs")),
+	              !params.options.isSet("fixLegacyBugs"),
+	              params.observeMemory),
 	      onepoint_(helper_),
 	      skeleton_(helper_, true),
 	      twopoint_(skeleton_),
@@ -287,35 +296,33 @@ public:
 		if (!needsPrinting)
 			err("Observer::threePoint with !needsPrinting only for all sites fixed\n");
 
-		if (flag == 1) {
-			SizeType site0 = braket.site(0);
-			std::cout<<"Fixed site0= "<<site0<<"\n";
-			for (SizeType site1 = site0+1; site1 < rows; ++site1) {
-				for (SizeType site2 = site1+1; site2 < cols; ++site2) {
-					typename MatrixType::value_type tmp = fourpoint_.threePoint(site0,
-					                                                            site1,
-					                                                            site2,
-					                                                            braket);
-					std::cout<<site1<<" "<<site2<<"  "<<tmp<<"\n";
-
-				}
-			}
-		}
-
-		assert(flag == 0);
-		for (SizeType site0 = 0; site0 < rows; ++site0) {
-			for (SizeType site1 = site0+1; site1 < rows; ++site1) {
-				for (SizeType site2 = site1+1; site2 < cols; ++site2) {
-
-					typename MatrixType::value_type tmp = fourpoint_.threePoint(site0,
-					                                                            site1,
-					                                                            site2,
-					                                                            braket);
-					std::cout<<site0<<" "<<site1<<" "<<site2<<"  "<<tmp<<"\n";
-				}
+		// one task for each site0 and site1, see ParallelManyPointCorrelations
+		VectorTaskType tasks;
+		const SizeType site0Begin = (flag == 1) ? braket.site(0) : 0;
+		const SizeType site0End = (flag == 1) ? site0Begin + 1 : rows;
+		for (SizeType site0 = site0Begin; site0 < site0End; ++site0)
+			for (SizeType site1 = site0+1; site1 < rows; ++site1)
+				if (site1 + 1 < cols)
+					tasks.push_back(TaskType(site0, site1, site1 + 1, cols));
+
+		ParallelManyPointType helperManyPoint(fourpoint_, braket, tasks);
+		runManyPoint(helperManyPoint);
+
+		if (flag == 1) std::cout<<"Fixed site0= "<<site0Begin<<"\n";
+
+		PsimagLite::OstringStream msgg(std::cout.precision());
+		PsimagLite::OstringStream::OstringStreamType& msg = msgg();
+		for (SizeType t = 0; t < tasks.size(); ++t) {
+			const TaskType& task = tasks[t];
+			const VectorFieldType& values = helperManyPoint.values(t);
+			assert(values.size() == task.end - task.begin);
+			for (SizeType site2 = task.begin; site2 < task.end; ++site2) {
+				if (flag == 0) msg<<task.site0<<" ";
+				msg<<task.site1<<" "<<site2<<"  "<<values[site2 - task.begin]<<"\n";
 			}
 		}
 
+		std::cout<<msg.str();
 		return 0;
 	}
 
@@ -383,55 +390,29 @@ public:
 			const bool finalTransform = true;
 			fourpoint_.firstStage(O2gt, 'N', site0, 'N', site1, braket, 0, 1, finalTransform);
 
-			for (SizeType site2 = site1+1; site2 < rows; ++site2) {
-				for (SizeType site3 = site2+1; site3 < cols; ++site3) {
-					typename MatrixType::value_type tmp = fourpoint_.secondStage(O2gt,
-					                                                             site1,
-					                                                             'N',
-					                                                             site2,
-					                                                             'N',
-					                                                             site3,
-					                                                             braket,
-					                                                             2,
-					                                                             3);
-					std::cout<<site2<<" "<<site3<<" "<<tmp<<"\n";
-				}
-			}
+			// one task for each site2, all sharing O2gt
+			VectorTaskType tasks;
+			for (SizeType site2 = site1+1; site2 < rows; ++site2)
+				tasks.push_back(TaskType(site0, site1, site2, site2 + 1));
 
+			const ManyPointAction noAction(false, "");
+			ParallelManyPointType helperManyPoint(fourpoint_, braket, tasks, cols, noAction, &O2gt);
+			runManyPoint(helperManyPoint);
+			printFourPoint(tasks, helperManyPoint, cols, noAction, false);
 			return;
 		}
 
 		assert(flag == 0);
-		const bool finalTransform = true;
-		for (SizeType site0 = 0; site0 < rows; ++site0) {
-			for (SizeType site1 = site0+1; site1 < cols; ++site1) {
-				for (SizeType site2 = site1+1; site2 < rows; ++site2) {
-					for (SizeType site3 = site2+1; site3 < cols; ++site3) {
-						if (!myaction(site0, site1, site2, site3)) continue;
-						typename FourPointCorrelationsType::SparseMatrixType O2gt;
-						fourpoint_.firstStage(O2gt,
-						                      'N',
-						                      site0,
-						                      'N',
-						                      site1,
-						                      braket,0,
-						                      1,
-						                      finalTransform);
-						typename MatrixType::value_type tmp = fourpoint_.secondStage(O2gt,
-						                                                             site1,
-						                                                             'N',
-						                                                             site2,
-						                                                             'N',
-						                                                             site3,
-						                                                             braket,
-						                                                             2,
-						                                                             3);
-						std::cout<<site0<<" "<<site1<<" ";
-						std::cout<<site2<<" "<<site3<<" "<<tmp<<"\n";
-					}
-				}
-			}
-		}
+		// one task for each site0 and site1, see ParallelManyPointCorrelations
+		VectorTaskType tasks;
+		for (SizeType site0 = 0; site0 < rows; ++site0)
+			for (SizeType site1 = site0+1; site1 < cols; ++site1)
+				if (site1 + 1 < rows)
+					tasks.push_back(TaskType(site0, site1, site1 + 1, rows));
+
+		ParallelManyPointType helperManyPoint(fourpoint_, braket, tasks, cols, myaction, 0);
+		runManyPoint(helperManyPoint);
+		printFourPoint(tasks, helperManyPoint, cols, myaction, true);
 	}
 
 	FieldType anyPoint(const BraketType& braket, bool needsPrinting) const
@@ -561,6 +542,40 @@ public:
 
 private:
 
+	static void runManyPoint(ParallelManyPointType& helperManyPoint)
+	{
+		typedef PsimagLite::Parallelizer<ParallelManyPointType,
+		        PsimagLite::LoadBalancerWeights> ParallelizerType;
+		ParallelizerType threadedManyPoint(PsimagLite::Concurrency::codeSectionParams);
+		threadedManyPoint.loopCreate(helperManyPoint, helperManyPoint.weights());
+	}
+
+	// all values at once, in the order of the serial loops
+	static void printFourPoint(const VectorTaskType& tasks,
+	                           const ParallelManyPointType& helperManyPoint,
+	                           SizeType cols,
+	                           const ManyPointAction& myaction,
+	                           bool printFirstTwo)
+	{
+		PsimagLite::OstringStream msgg(std::cout.precision());
+		PsimagLite::OstringStream::OstringStreamType& msg = msgg();
+		for (SizeType t = 0; t < tasks.size(); ++t) {
+			const TaskType& task = tasks[t];
+			const VectorFieldType& values = helperManyPoint.values(t);
+			SizeType k = 0;
+			for (SizeType site2 = task.begin; site2 < task.end; ++site2) {
+				for (SizeType site3 = site2+1; site3 < cols; ++site3) {
+					if (!myaction(task.site0, task.site1, site2, site3)) continue;
+					assert(k < values.size());
+					if (printFirstTwo) msg<<task.site0<<" "<<task.site1<<" ";
+					msg<<site2<<" "<<site3<<" "<<values[k++]<<"\n";
+				}
+			}
+		}
+
+		std::cout<<msg.str();
+	}
+
 	const ObserverHelperType helper_;
 	const OnePointCorrelationsType onepoint_;
 	const CorrelationsSkeletonType skeleton_;
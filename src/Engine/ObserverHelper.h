@@ -85,9 +85,27 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "VectorWithOffsets.h" // to include norm
 #include "VectorWithOffset.h" // to include norm
 #include "GetBraOrKet.h"
+#include "Concurrency.h"
+#include <memory>
 
 namespace Dmrg {
 
+/* PSIDOC ObserverHelperCache
+ With ObserveMemory= zero, the data of all finite steps, in DmrgSerializer and
+ TimeSerializer, is read at the start. Otherwise an entry is read from disk the first
+ time it is needed, and entries are evicted, least recently used first, while
+ they take more than ObserveMemory= bytes. The entry after the one requested,
+ in the order in which the requests of a thread are going, is read in
+ the background, as CorrelationsSkeleton::growDirectly() moves step by step;
+ this read is waited for at the end of each sweep, see joinPrefetch().
+ Each thread keeps the last two entries it asked for in a slot of its own, so that
+ asking again for the last entry takes no lock; only a change of entry takes the lock,
+ finds the entry, reading it if needed, and evicts.
+ A reference that the accessors return dangles once the same thread has asked for
+ two other entries, because then its entry is no longer held by the slot and may be
+ evicted; do not keep one across steps.
+ Reading in the background needs pthreads and an HDF5 library built thread safe.
+ */
 template<typename IoInputType_,
          typename MatrixType_,
          typename VectorType_,
@@ -121,12 +139,30 @@ public:
 	               SizeType start,
 	               SizeType nf,
 	               SizeType trail,
-	               bool withLegacyBugs)
+	               bool withLegacyBugs,
+	               SizeType maxBytes = 0)
 	    : io_(io),
 	      withLegacyBugs_(withLegacyBugs),
 	      noMoreData_(false),
-	      numberOfSites_(0)
+	      numberOfSites_(0),
+	      maxBytes_(maxBytes),
+	      start_(start),
+	      hasTime_(false),
+	      bytes_(0),
+	      clock_(0),
+	      loads_(0),
+	      evictions_(0),
+	      hasWorker_(false),
+	      prefetching_(0),
+	      prefetchDone_(true)
 	{
+		ConcurrencyType::mutexInit(&mutex_);
+		ConcurrencyType::mutexInit(&ioMutex_);
+#ifdef USE_PTHREADS
+		if (pthread_key_create(&slotKey_, slotDestructor) != 0)
+			err("ObserverHelper: could not create a thread key\n");
+#endif
+
 		typename BasisWithOperatorsType::VectorBoolType odds;
 		io_.read(odds, "OddElectronsOneSite");
 		SizeType n = odds.size();
@@ -145,15 +181,37 @@ public:
 
 	~ObserverHelper()
 	{
-		for (SizeType i = 0; i < dSerializerV_.size(); ++i) {
-			delete dSerializerV_[i];
-			dSerializerV_[i] = 0;
-		}
+		joinPrefetch();
+
+#ifdef USE_PTHREADS
+		// slots of threads still running; the others were deleted at their exit
+		pthread_key_delete(slotKey_);
+		for (SizeType i = 0; i < slots_.size(); ++i)
+			delete slots_[i];
+		slots_.clear();
+#endif
 
-		for (SizeType i = 0; i < timeSerializerV_.size(); ++i) {
-			delete timeSerializerV_[i];
-			timeSerializerV_[i] = 0;
-		}
+		ConcurrencyType::mutexDestroy(&ioMutex_);
+		ConcurrencyType::mutexDestroy(&mutex_);
+
+		if (maxBytes_ == 0) return;
+
+		std::cerr<<"ObserverHelper: entries read= "<<loads_<<" evicted= "<<evictions_;
+		std::cerr<<" of "<<cache_.size()<<"\n";
+	}
+
+	// waits for the entry being read in the background, see prefetch(); io_ must not
+	// be read other than through this class before this returns. Not to be called
+	// while other threads use this object
+	void joinPrefetch() const
+	{
+#ifdef USE_PTHREADS
+		ConcurrencyType::mutexLock(&mutex_);
+		const bool hasWorker = hasWorker_;
+		hasWorker_ = false;
+		ConcurrencyType::mutexUnlock(&mutex_);
+		if (hasWorker) pthread_join(worker_, 0);
+#endif
 	}
 
 	const SizeType& numberOfSites() const { return numberOfSites_; }
@@ -164,20 +222,17 @@ public:
 	               const SparseMatrixType& O2,
 	               SizeType ind) const
 	{
-		checkIndex(ind);
-		return dSerializerV_[ind]->transform(ret, O2);
+		return entry(ind).dSerializer->transform(ret, O2);
 	}
 
 	SizeType cols(SizeType ind) const
 	{
-		checkIndex(ind);
-		return dSerializerV_[ind]->cols();
+		return entry(ind).dSerializer->cols();
 	}
 
 	SizeType rows(SizeType ind) const
 	{
-		checkIndex(ind);
-		return dSerializerV_[ind]->rows();
+		return entry(ind).dSerializer->rows();
 	}
 
 	short int signsOneSite(SizeType site) const
@@ -188,58 +243,50 @@ public:
 
 	const FermionSignType& fermionicSignLeft(SizeType ind) const
 	{
-		checkIndex(ind);
-		return dSerializerV_[ind]->fermionicSignLeft();
+		return entry(ind).dSerializer->fermionicSignLeft();
 	}
 
 	const FermionSignType& fermionicSignRight(SizeType ind) const
 	{
-		checkIndex(ind);
-		return dSerializerV_[ind]->fermionicSignRight();
+		return entry(ind).dSerializer->fermionicSignRight();
 	}
 
 	const LeftRightSuperType& leftRightSuper(SizeType ind) const
 	{
-		checkIndex(ind);
-		return dSerializerV_[ind]->leftRightSuper();
+		return entry(ind).dSerializer->leftRightSuper();
 	}
 
 	ProgramGlobals::DirectionEnum direction(SizeType ind) const
 	{
-		checkIndex(ind);
-		return dSerializerV_[ind]->direction();
+		return entry(ind).dSerializer->direction();
 	}
 
 	const VectorWithOffsetType& psiConst(SizeType ind,
 	                                     SizeType sectorIndex,
 	                                     SizeType levelIndex) const
 	{
-		checkIndex(ind);
-
-		return dSerializerV_[ind]->psiConst(sectorIndex, levelIndex);
+		return entry(ind).dSerializer->psiConst(sectorIndex, levelIndex);
 	}
 
 	RealType time(SizeType ind) const
 	{
-		if (timeSerializerV_.size() == 0) return 0.0;
-		assert(ind < timeSerializerV_.size());
-		assert(timeSerializerV_[ind]);
-		return timeSerializerV_[ind]->time();
+		if (!hasTime_) return 0.0;
+		const EntryType& e = entry(ind);
+		assert(e.timeSerializer);
+		return e.timeSerializer->time();
 	}
 
 	SizeType site(SizeType ind) const
 	{
-		if (timeSerializerV_.size() == 0) {
-			checkIndex(ind);
-			return dSerializerV_[ind]->site();
-		}
+		const EntryType& e = entry(ind);
+		if (!hasTime_)
+			return e.dSerializer->site();
 
-		assert(ind < timeSerializerV_.size());
-		assert(timeSerializerV_[ind]);
-		return timeSerializerV_[ind]->site();
+		assert(e.timeSerializer);
+		return e.timeSerializer->site();
 	}
 
-	SizeType size() const { return dSerializerV_.size(); }
+	SizeType size() const { return cache_.size(); }
 
 	const VectorWithOffsetType& getVectorFromBracketId(const PsimagLite::GetBraOrKet& braOrKet,
 	                                                   SizeType index) const
@@ -255,9 +302,9 @@ public:
 	const VectorWithOffsetType& timeVector(SizeType braketId,
 	                                       SizeType ind) const
 	{
-		assert(ind < timeSerializerV_.size());
-		assert(timeSerializerV_[ind]);
-		return timeSerializerV_[ind]->vector(braketId);
+		const EntryType& e = entry(ind);
+		assert(e.timeSerializer);
+		return e.timeSerializer->vector(braketId);
 	}
 
 	bool withLegacyBugs() const
@@ -284,6 +331,35 @@ public:
 
 private:
 
+	struct EntryType {
+
+		EntryType() : bytes(0) {}
+
+		std::unique_ptr<DmrgSerializerType> dSerializer;
+		std::unique_ptr<TimeSerializerType> timeSerializer;
+		SizeType bytes;
+	};
+
+	typedef std::shared_ptr<EntryType> EntryPtrType;
+	typedef typename PsimagLite::Vector<EntryPtrType>::Type VectorEntryPtrType;
+
+	typedef PsimagLite::Concurrency ConcurrencyType;
+
+	// the last entries a thread asked for, most recent first, which are not evicted;
+	// only its thread uses it
+	struct SlotType {
+
+		SlotType(const ObserverHelper* helper_ = 0) : helper(helper_) {}
+
+		const ObserverHelper* helper;
+		VectorSizeType indices;
+		VectorEntryPtrType entries;
+	};
+
+	typedef typename PsimagLite::Vector<SlotType*>::Type VectorSlotPtrType;
+
+	static const SizeType PINS_PER_THREAD = 2;
+
 	bool init(SizeType start, SizeType end, SaveEnum saveOrNot)
 	{
 		PsimagLite::String prefix = "Serializer";
@@ -291,38 +367,231 @@ private:
 		io_.read(total, prefix + "/Size");
 		if (start >= end || start >= total || end > total) return false;
 
-		for (SizeType i = start; i < end; ++i) {
+		if (saveOrNot == SaveEnum::YES) {
+			start_ = start;
+			cache_.resize(end - start);
+			lastUse_.resize(end - start, 0);
+		}
 
-			DmrgSerializerType* dSerializer = new DmrgSerializerType(io_,
-			                                                         prefix + "/" + ttos(i),
-			                                                         false,
-			                                                         true);
+		for (SizeType i = start; i < end; ++i) {
 
+			EntryPtrType ptr(readEntry(i));
 
-			SizeType tmp = dSerializer->leftRightSuper().sites();
+			SizeType tmp = ptr->dSerializer->leftRightSuper().sites();
 			if (tmp > 0 && numberOfSites_ == 0) numberOfSites_ = tmp;
 
-			if (saveOrNot == SaveEnum::YES)
-				dSerializerV_.push_back(dSerializer);
-			else
-				delete dSerializer;
-
-			try {
-				PsimagLite::String prefix("/TargetingCommon/" + ttos(i));
-				TimeSerializerType* ts = new TimeSerializerType(io_, prefix);
-				if (saveOrNot == SaveEnum::YES)
-					timeSerializerV_.push_back(ts);
-				else
-					delete ts;
-			} catch(...) {}
+			if (saveOrNot == SaveEnum::YES) {
+				if (i == start) hasTime_ = (ptr->timeSerializer != nullptr);
+				cache_[i - start] = ptr;
+				bytes_ += ptr->bytes;
+				++loads_;
+			}
 
 			std::cerr<<__FILE__<<" read "<<i<<" out of "<<total<<"\n";
+
+			// the rest is read when needed
+			if (saveOrNot == SaveEnum::YES && maxBytes_ > 0) break;
 		}
 
 		noMoreData_ = (end == total);
-		return (dSerializerV_.size() > 0);
+		return (cache_.size() > 0);
 	}
 
+	EntryType* readEntry(SizeType i) const
+	{
+		PsimagLite::String prefix = "Serializer";
+		EntryType* e = new EntryType;
+		e->dSerializer.reset(new DmrgSerializerType(io_,
+		                                            prefix + "/" + ttos(i),
+		                                            false,
+		                                            true));
+		e->bytes = e->dSerializer->memoryEstimate();
+
+		try {
+			PsimagLite::String prefix("/TargetingCommon/" + ttos(i));
+			e->timeSerializer.reset(new TimeSerializerType(io_, prefix));
+		} catch(...) {}
+
+		if (!e->timeSerializer) return e;
+
+		for (SizeType j = 0; j < e->timeSerializer->numberOfVectors(); ++j) {
+			const VectorWithOffsetType& v = e->timeSerializer->vector(j);
+			for (SizeType ii = 0; ii < v.sectors(); ++ii)
+				e->bytes += v.effectiveSize(v.sector(ii))*sizeof(FieldType);
+		}
+
+		return e;
+	}
+
+	const EntryType& entry(SizeType ind) const
+	{
+		checkIndex(ind);
+
+		// all entries were read by init()
+		if (maxBytes_ == 0) return *cache_[ind];
+
+		SlotType& slot = mySlot();
+		if (slot.indices.size() > 0 && slot.indices[0] == ind)
+			return *slot.entries[0];
+
+		return changeEntry(slot, ind);
+	}
+
+	// the slot of the calling thread, created the first time
+	SlotType& mySlot() const
+	{
+#ifdef USE_PTHREADS
+		SlotType* slot = static_cast<SlotType*>(pthread_getspecific(slotKey_));
+		if (slot) return *slot;
+
+		slot = new SlotType(this);
+		ConcurrencyType::mutexLock(&mutex_);
+		slots_.push_back(slot);
+		ConcurrencyType::mutexUnlock(&mutex_);
+		pthread_setspecific(slotKey_, slot);
+		return *slot;
+#else
+		return slot_;
+#endif
+	}
+
+#ifdef USE_PTHREADS
+	// called at the exit of a thread that has a slot
+	static void slotDestructor(void* arg)
+	{
+		SlotType* slot = static_cast<SlotType*>(arg);
+		const ObserverHelper* helper = slot->helper;
+		ConcurrencyType::mutexLock(&helper->mutex_);
+		for (SizeType i = 0; i < helper->slots_.size(); ++i) {
+			if (helper->slots_[i] != slot) continue;
+			helper->slots_.erase(helper->slots_.begin() + i);
+			break;
+		}
+
+		delete slot;
+		ConcurrencyType::mutexUnlock(&helper->mutex_);
+	}
+#endif
+
+	// the slot of this thread moves to entry ind
+	const EntryType& changeEntry(SlotType& slot, SizeType ind) const
+	{
+		ConcurrencyType::mutexLock(&mutex_);
+		EntryPtrType ptr = cache_[ind];
+		if (!ptr) {
+			ConcurrencyType::mutexUnlock(&mutex_);
+			ptr = load(ind);
+			ConcurrencyType::mutexLock(&mutex_);
+		}
+
+		lastUse_[ind] = ++clock_;
+		const int previous = (slot.indices.size() > 0) ? slot.indices[0] : -1;
+		slot.indices.insert(slot.indices.begin(), ind);
+		slot.entries.insert(slot.entries.begin(), ptr);
+		if (slot.indices.size() > PINS_PER_THREAD) {
+			slot.indices.pop_back();
+			slot.entries.pop_back();
+		}
+
+		const bool backwards = (previous == static_cast<int>(ind) + 1);
+		if (!backwards) prefetch(ind + 1);
+		else if (ind > 0) prefetch(ind - 1);
+
+		ConcurrencyType::mutexUnlock(&mutex_);
+		return *ptr;
+	}
+
+	// reading is serialized by ioMutex_, and is done at most once per entry
+	EntryPtrType load(SizeType ind) const
+	{
+		ConcurrencyType::mutexLock(&ioMutex_);
+		ConcurrencyType::mutexLock(&mutex_);
+		EntryPtrType ptr = cache_[ind];
+		ConcurrencyType::mutexUnlock(&mutex_);
+		if (ptr) {
+			ConcurrencyType::mutexUnlock(&ioMutex_);
+			return ptr;
+		}
+
+		try {
+			ptr.reset(readEntry(start_ + ind));
+		} catch (...) {
+			ConcurrencyType::mutexUnlock(&ioMutex_);
+			throw;
+		}
+
+		ConcurrencyType::mutexLock(&mutex_);
+		cache_[ind] = ptr;
+		lastUse_[ind] = ++clock_;
+		bytes_ += ptr->bytes;
+		++loads_;
+		evict();
+		ConcurrencyType::mutexUnlock(&mutex_);
+		ConcurrencyType::mutexUnlock(&ioMutex_);
+		return ptr;
+	}
+
+	// must be called with mutex_ locked, after a load only; entries held only
+	// by cache_ can go
+	void evict() const
+	{
+		while (bytes_ > maxBytes_) {
+			int lru = -1;
+			for (SizeType i = 0; i < cache_.size(); ++i) {
+				if (!cache_[i] || cache_[i].use_count() > 1) continue;
+				if (lru < 0 || lastUse_[i] < lastUse_[lru]) lru = i;
+			}
+
+			if (lru < 0) return;
+
+			bytes_ -= cache_[lru]->bytes;
+			cache_[lru].reset();
+			++evictions_;
+		}
+	}
+
+	// must be called with mutex_ locked; one read in the background at a time
+	void prefetch(SizeType ind) const
+	{
+#ifdef USE_PTHREADS
+		if (ind >= cache_.size() || cache_[ind]) return;
+
+		if (hasWorker_) {
+			if (!prefetchDone_) return;
+			pthread_join(worker_, 0);
+			hasWorker_ = false;
+		}
+
+		prefetchDone_ = false;
+		prefetching_ = ind;
+		if (pthread_create(&worker_, 0, prefetchThread, const_cast<ObserverHelper*>(this)) != 0) {
+			prefetchDone_ = true;
+			return; // to be read when needed
+		}
+
+		hasWorker_ = true;
+#endif
+	}
+
+#ifdef USE_PTHREADS
+	// reads entry prefetching_; runs on worker_
+	static void* prefetchThread(void* arg)
+	{
+		const ObserverHelper* helper = static_cast<ObserverHelper*>(arg);
+		ConcurrencyType::mutexLock(&helper->mutex_);
+		const SizeType ind = helper->prefetching_;
+		ConcurrencyType::mutexUnlock(&helper->mutex_);
+		try {
+			helper->load(ind);
+		} catch (...) {} // to be read, and thrown, when needed
+
+		ConcurrencyType::mutexLock(&helper->mutex_);
+		helper->prefetchDone_ = true;
+		ConcurrencyType::mutexUnlock(&helper->mutex_);
+		return 0;
+	}
+#endif
+
 	static SizeType braketStringToNumber(const PsimagLite::String& str)
 	{
 		GetBraOrKetType ketOrBra(str);
@@ -334,21 +603,41 @@ private:
 
 	void checkIndex(SizeType ind) const
 	{
-		if (ind >= dSerializerV_.size())
-			err("Index " + ttos(ind) + " bigger than " + ttos(dSerializerV_.size()));
+		if (ind >= cache_.size())
+			err("Index " + ttos(ind) + " bigger than " + ttos(cache_.size()));
 
-		if (dSerializerV_[ind]) return;
+		if (maxBytes_ > 0 || cache_[ind]) return;
 
-		err("dSerializerV_ at index " + ttos(ind) + " point to 0x0\n");
+		err("ObserverHelper entry at index " + ttos(ind) + " point to 0x0\n");
 	}
 
 	IoInputType& io_;
-	typename PsimagLite::Vector<DmrgSerializerType*>::Type dSerializerV_;
-	typename PsimagLite::Vector<TimeSerializerType*>::Type timeSerializerV_;
 	const bool withLegacyBugs_;
 	bool noMoreData_;
 	VectorShortIntType signsOneSite_;
 	SizeType numberOfSites_;
+	const SizeType maxBytes_;
+	SizeType start_;
+	bool hasTime_;
+	mutable VectorEntryPtrType cache_;
+	mutable VectorSizeType lastUse_;
+	mutable SizeType bytes_;
+	mutable SizeType clock_;
+	mutable SizeType loads_;
+	mutable SizeType evictions_;
+	mutable ConcurrencyType::MutexType mutex_;
+	mutable ConcurrencyType::MutexType ioMutex_;
+#ifdef USE_PTHREADS
+	pthread_key_t slotKey_;
+	mutable VectorSlotPtrType slots_;
+	mutable pthread_t worker_;
+#else
+	mutable SlotType slot_;
+#endif
+	mutable bool hasWorker_;
+	// prefetching_ and prefetchDone_ are guarded by mutex_
+	mutable SizeType prefetching_;
+	mutable bool prefetchDone_;
 };  // ObserverHelper
 } // namespace Dmrg
 
@@ -0,0 +1,449 @@
+#ifndef OPERATORBLOCKS_H
+#define OPERATORBLOCKS_H
+#include <algorithm>
+#include "Vector.h"
+#include "Matrix.h"
+#include "CrsMatrix.h"
+#include "GemmR.h"
+#include "BlockDiagonalMatrix.h"
+
+namespace Dmrg {
+
+/* PSIDOC OperatorBlocks
+ A square operator held as the list of its nonzero blocks, one for each pair
+ (row partition, column partition) of the symmetry sectors of its basis;
+ the partitions are the offsets of the sectors, with the size of the basis
+ as their last entry. Unlike BlockOffDiagMatrix this class can be copied, so that
+ it can be the storage of an operator, see OperatorStorage.
+ Like MatrixDenseOrSparse, each block is stored dense only if more than
+ threshold times its size of its entries are nonzero, and CRS otherwise, so that
+ the local operators of an enlarged basis, which are very sparse, stay small.
+ transform() and dense(ipatch, jpatch) make a block dense.
+ Blocks are kept sorted by row partition and then by column partition.
+ */
+template<typename ComplexOrRealType>
+class OperatorBlocks {
+
+public:
+
+	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixType;
+	typedef PsimagLite::CrsMatrix<ComplexOrRealType> SparseMatrixType;
+	typedef BlockDiagonalMatrix<MatrixType> BlockDiagonalMatrixType;
+	typedef typename PsimagLite::Real<ComplexOrRealType>::Type RealType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef PsimagLite::Vector<char>::Type VectorCharType;
+
+	OperatorBlocks() {}
+
+	OperatorBlocks(const SparseMatrixType& sparse,
+	               const VectorSizeType& partitions,
+	               RealType threshold)
+	    : offsets_(partitions)
+	{
+		if (sparse.rows() != sparse.cols())
+			err("OperatorBlocks::ctor() expects square sparse matrix\n");
+
+		if (partitions.size() == 0)
+			err("OperatorBlocks::ctor() expects partitions.size() > 0\n");
+
+		const SizeType n = partitions.size() - 1;
+		const SizeType total = partitions[n];
+		if (sparse.rows() != total)
+			err("OperatorBlocks::ctor() partitions do not match matrix\n");
+
+		VectorSizeType indexToPart(total, 0);
+		for (SizeType i = 0; i < n; ++i)
+			for (SizeType r = partitions[i]; r < partitions[i + 1]; ++r)
+				indexToPart[r] = i;
+
+		const ComplexOrRealType zero = 0.0;
+		index_.resize(n, n);
+		index_.setTo(-1);
+		VectorSizeType nonZerosOf(n, 0);
+		for (SizeType ipatch = 0; ipatch < n; ++ipatch) {
+			VectorSizeType seen;
+			for (SizeType row = partitions[ipatch]; row < partitions[ipatch + 1]; ++row) {
+				for (int k = sparse.getRowPtr(row); k < sparse.getRowPtr(row + 1); ++k) {
+					if (sparse.getValue(k) == zero) continue;
+					const SizeType jpatch = indexToPart[sparse.getCol(k)];
+					++nonZerosOf[jpatch];
+					if (index_(ipatch, jpatch) >= 0) continue;
+					index_(ipatch, jpatch) = 0;
+					seen.push_back(jpatch);
+				}
+			}
+
+			std::sort(seen.begin(), seen.end());
+			const SizeType firstBlock = blocks_.size();
+			const SizeType nrows = partitions[ipatch + 1] - partitions[ipatch];
+			for (SizeType s = 0; s < seen.size(); ++s) {
+				const SizeType jpatch = seen[s];
+				const SizeType ncols = partitions[jpatch + 1] - partitions[jpatch];
+				const bool isDense = (nonZerosOf[jpatch] > threshold*nrows*ncols);
+				nonZerosOf[jpatch] = 0;
+				index_(ipatch, jpatch) = blocks_.size();
+				ipatch_.push_back(ipatch);
+				jpatch_.push_back(jpatch);
+				isDense_.push_back(isDense);
+				blocks_.push_back((isDense) ? MatrixType(nrows, ncols) : MatrixType());
+				sparseBlocks_.push_back((isDense) ? SparseMatrixType() :
+				                                    SparseMatrixType(nrows, ncols));
+			}
+
+			// the sparse blocks are filled row by row, counters in nonZerosOf
+			for (SizeType row = partitions[ipatch]; row < partitions[ipatch + 1]; ++row) {
+				const SizeType r = row - partitions[ipatch];
+				for (SizeType b = firstBlock; b < blocks_.size(); ++b)
+					if (!isDense_[b])
+						sparseBlocks_[b].setRow(r, nonZerosOf[jpatch_[b]]);
+
+				for (int k = sparse.getRowPtr(row); k < sparse.getRowPtr(row + 1); ++k) {
+					const ComplexOrRealType value = sparse.getValue(k);
+					if (value == zero) continue;
+					const SizeType col = sparse.getCol(k);
+					const SizeType jpatch = indexToPart[col];
+					const SizeType b = index_(ipatch, jpatch);
+					const SizeType c = col - partitions[jpatch];
+					if (isDense_[b]) {
+						blocks_[b](r, c) = value;
+						continue;
+					}
+
+					sparseBlocks_[b].pushCol(c);
+					sparseBlocks_[b].pushValue(value);
+					++nonZerosOf[jpatch];
+				}
+			}
+
+			for (SizeType b = firstBlock; b < blocks_.size(); ++b) {
+				if (isDense_[b]) continue;
+				const SizeType jpatch = jpatch_[b];
+				sparseBlocks_[b].setRow(nrows, nonZerosOf[jpatch]);
+				sparseBlocks_[b].checkValidity();
+				nonZerosOf[jpatch] = 0;
+			}
+		}
+	}
+
+	// zeros of the dense blocks are not copied
+	void toSparse(SparseMatrixType& sparse) const
+	{
+		const SizeType total = rows();
+		const ComplexOrRealType zero = 0.0;
+
+		sparse.clear();
+		sparse.resize(total, total);
+
+		SizeType count = 0;
+		SizeType b = 0;
+		for (SizeType ipatch = 0; ipatch + 1 < offsets_.size(); ++ipatch) {
+			SizeType bEnd = b;
+			while (bEnd < blocks_.size() && ipatch_[bEnd] == ipatch)
+				++bEnd;
+
+			for (SizeType row = offsets_[ipatch]; row < offsets_[ipatch + 1]; ++row) {
+				sparse.setRow(row, count);
+				const SizeType r = row - offsets_[ipatch];
+				for (SizeType bb = b; bb < bEnd; ++bb) {
+					const SizeType offsetCol = offsets_[jpatch_[bb]];
+					if (!isDense_[bb]) {
+						const SparseMatrixType& m = sparseBlocks_[bb];
+						for (int k = m.getRowPtr(r); k < m.getRowPtr(r + 1); ++k) {
+							sparse.pushCol(m.getCol(k) + offsetCol);
+							sparse.pushValue(m.getValue(k));
+							++count;
+						}
+
+						continue;
+					}
+
+					const MatrixType& m = blocks_[bb];
+					if (r >= m.rows()) continue;
+					for (SizeType c = 0; c < m.cols(); ++c) {
+						if (m(r, c) == zero) continue;
+						sparse.pushCol(c + offsetCol);
+						sparse.pushValue(m(r, c));
+						++count;
+					}
+				}
+			}
+
+			b = bEnd;
+		}
+
+		sparse.setRow(total, count);
+		sparse.checkValidity();
+	}
+
+	MatrixType toDense() const
+	{
+		const SizeType total = rows();
+		MatrixType dense(total, total);
+		for (SizeType b = 0; b < blocks_.size(); ++b) {
+			const SizeType offsetRow = offsets_[ipatch_[b]];
+			const SizeType offsetCol = offsets_[jpatch_[b]];
+			if (!isDense_[b]) {
+				const SparseMatrixType& m = sparseBlocks_[b];
+				for (SizeType r = 0; r < m.rows(); ++r)
+					for (int k = m.getRowPtr(r); k < m.getRowPtr(r + 1); ++k)
+						dense(r + offsetRow, m.getCol(k) + offsetCol) = m.getValue(k);
+				continue;
+			}
+
+			const MatrixType& m = blocks_[b];
+			for (SizeType c = 0; c < m.cols(); ++c)
+				for (SizeType r = 0; r < m.rows(); ++r)
+					dense(r + offsetRow, c + offsetCol) = m(r, c);
+		}
+
+		return dense;
+	}
+
+	// this = f^\dagger this f, see BlockOffDiagMatrix::transform()
+	// all blocks are dense afterwards
+	void transform(const BlockDiagonalMatrixType& f,
+	               SizeType nb,
+	               SizeType nthreadsInner)
+	{
+		static const bool needsPrinting = false;
+		PsimagLite::GemmR<ComplexOrRealType> gemmR(needsPrinting, nb, nthreadsInner);
+
+		for (SizeType b = 0; b < blocks_.size(); ++b) {
+			const MatrixType& mLeft = f(ipatch_[b]);
+			const MatrixType& mRight = f(jpatch_[b]);
+
+			if (mLeft.rows() == 0 || mRight.rows() == 0) {
+				blocks_[b].clear();
+				SparseMatrixType().swap(sparseBlocks_[b]);
+				isDense_[b] = true;
+				continue;
+			}
+
+			MatrixType tmp;
+			if (isDense_[b]) {
+				MatrixType& m = blocks_[b];
+				assert(m.cols() == mRight.rows());
+				assert(m.rows() == mLeft.rows());
+
+				tmp.resize(m.rows(), mRight.cols());
+				gemmR('N',
+				      'N',
+				      m.rows(),
+				      mRight.cols(),
+				      m.cols(),
+				      1.0,
+				      &(m(0, 0)),
+				      m.rows(),
+				      &(mRight(0, 0)),
+				      mRight.rows(),
+				      0.0,
+				      &(tmp(0, 0)),
+				      tmp.rows());
+			} else {
+				const SparseMatrixType& m = sparseBlocks_[b];
+				assert(m.cols() == mRight.rows());
+				assert(m.rows() == mLeft.rows());
+
+				tmp.resize(m.rows(), mRight.cols());
+				for (SizeType c = 0; c < mRight.cols(); ++c)
+					for (SizeType r = 0; r < m.rows(); ++r)
+						for (int k = m.getRowPtr(r); k < m.getRowPtr(r + 1); ++k)
+							tmp(r, c) += m.getValue(k)*mRight(m.getCol(k), c);
+
+				SparseMatrixType().swap(sparseBlocks_[b]);
+				isDense_[b] = true;
+			}
+
+			MatrixType& m = blocks_[b];
+			m.clear();
+			m.resize(mLeft.cols(), mRight.cols());
+			gemmR('C',
+			      'N',
+			      mLeft.cols(),
+			      tmp.cols(),
+			      tmp.rows(),
+			      1.0,
+			      &(mLeft(0, 0)),
+			      mLeft.rows(),
+			      &(tmp(0, 0)),
+			      tmp.rows(),
+			      0.0,
+			      &(m(0, 0)),
+			      m.rows());
+		}
+
+		transformOffsets(f);
+	}
+
+	// the blocks transformed one by one elsewhere, see ChangeOfBasisBatched
+	void transformOffsets(const BlockDiagonalMatrixType& f)
+	{
+		offsets_ = f.offsetsCols();
+		assert(offsets_.size() == index_.rows() + 1);
+	}
+
+	bool hasBlock(SizeType ipatch, SizeType jpatch) const
+	{
+		return (index_(ipatch, jpatch) >= 0);
+	}
+
+	bool isDense(SizeType ipatch, SizeType jpatch) const
+	{
+		const int b = index_(ipatch, jpatch);
+		assert(b >= 0);
+		return isDense_[b];
+	}
+
+	const MatrixType& dense(SizeType ipatch, SizeType jpatch) const
+	{
+		const int b = index_(ipatch, jpatch);
+		assert(b >= 0 && isDense_[b]);
+		return blocks_[b];
+	}
+
+	// a sparse block is made dense first
+	MatrixType& dense(SizeType ipatch, SizeType jpatch)
+	{
+		const int b = index_(ipatch, jpatch);
+		assert(b >= 0);
+		if (!isDense_[b]) {
+			crsMatrixToFullMatrix(blocks_[b], sparseBlocks_[b]);
+			SparseMatrixType().swap(sparseBlocks_[b]);
+			isDense_[b] = true;
+		}
+
+		return blocks_[b];
+	}
+
+	const SparseMatrixType& sparse(SizeType ipatch, SizeType jpatch) const
+	{
+		const int b = index_(ipatch, jpatch);
+		assert(b >= 0 && !isDense_[b]);
+		return sparseBlocks_[b];
+	}
+
+	SparseMatrixType& sparse(SizeType ipatch, SizeType jpatch)
+	{
+		const int b = index_(ipatch, jpatch);
+		assert(b >= 0 && !isDense_[b]);
+		return sparseBlocks_[b];
+	}
+
+	SizeType patches() const { return index_.rows(); }
+
+	const VectorSizeType& offsets() const { return offsets_; }
+
+	SizeType rows() const
+	{
+		const SizeType n = offsets_.size();
+		return (n == 0) ? 0 : offsets_[n - 1];
+	}
+
+	SizeType cols() const { return rows(); }
+
+	// entries stored, zeros of the dense blocks included
+	SizeType nonZeros() const
+	{
+		SizeType sum = 0;
+		for (SizeType b = 0; b < blocks_.size(); ++b)
+			sum += (isDense_[b]) ? blocks_[b].rows()*blocks_[b].cols() :
+			                       sparseBlocks_[b].nonZeros();
+		return sum;
+	}
+
+	void checkValidity() const
+	{
+#ifndef NDEBUG
+		for (SizeType b = 0; b < blocks_.size(); ++b) {
+			const SizeType ipatch = ipatch_[b];
+			const SizeType jpatch = jpatch_[b];
+			assert(index_(ipatch, jpatch) == static_cast<int>(b));
+			const SizeType nrows = (isDense_[b]) ? blocks_[b].rows() : sparseBlocks_[b].rows();
+			const SizeType ncols = (isDense_[b]) ? blocks_[b].cols() : sparseBlocks_[b].cols();
+			if (!isDense_[b]) sparseBlocks_[b].checkValidity();
+			if (nrows == 0 && ncols == 0) continue;
+			assert(nrows == offsets_[ipatch + 1] - offsets_[ipatch]);
+			assert(ncols == offsets_[jpatch + 1] - offsets_[jpatch]);
+		}
+#endif
+	}
+
+	void clear()
+	{
+		offsets_.clear();
+		index_.clear();
+		ipatch_.clear();
+		jpatch_.clear();
+		isDense_.clear();
+		blocks_.clear();
+		sparseBlocks_.clear();
+	}
+
+	void conjugate()
+	{
+		for (SizeType b = 0; b < blocks_.size(); ++b) {
+			if (isDense_[b])
+				blocks_[b].conjugate();
+			else
+				sparseBlocks_[b].conjugate();
+		}
+	}
+
+	OperatorBlocks& operator*=(const ComplexOrRealType& value)
+	{
+		for (SizeType b = 0; b < blocks_.size(); ++b) {
+			if (isDense_[b])
+				blocks_[b] *= value;
+			else
+				sparseBlocks_[b] *= value;
+		}
+
+		return *this;
+	}
+
+	friend void transposeConjugate(OperatorBlocks& dest, const OperatorBlocks& src)
+	{
+		const SizeType n = src.patches();
+		dest.clear();
+		dest.offsets_ = src.offsets_;
+		dest.index_.resize(n, n);
+		dest.index_.setTo(-1);
+		for (SizeType jpatch = 0; jpatch < n; ++jpatch) {
+			for (SizeType ipatch = 0; ipatch < n; ++ipatch) {
+				if (!src.hasBlock(ipatch, jpatch)) continue;
+				const bool isDense = src.isDense(ipatch, jpatch);
+				dest.index_(jpatch, ipatch) = dest.blocks_.size();
+				dest.ipatch_.push_back(jpatch);
+				dest.jpatch_.push_back(ipatch);
+				dest.isDense_.push_back(isDense);
+				dest.blocks_.push_back(MatrixType());
+				dest.sparseBlocks_.push_back(SparseMatrixType());
+				if (!isDense) {
+					transposeConjugate(dest.sparseBlocks_.back(), src.sparse(ipatch, jpatch));
+					continue;
+				}
+
+				const MatrixType& m = src.dense(ipatch, jpatch);
+				MatrixType& mt = dest.blocks_.back();
+				mt.resize(m.cols(), m.rows());
+				for (SizeType c = 0; c < m.cols(); ++c)
+					for (SizeType r = 0; r < m.rows(); ++r)
+						mt(c, r) = PsimagLite::conj(m(r, c));
+			}
+		}
+	}
+
+private:
+
+	VectorSizeType offsets_;
+	PsimagLite::Matrix<int> index_;
+	VectorSizeType ipatch_;
+	VectorSizeType jpatch_;
+	// block b is blocks_[b] if isDense_[b], and sparseBlocks_[b] otherwise;
+	// not bool, because threads make different blocks dense, see ChangeOfBasisBatched
+	VectorCharType isDense_;
+	typename PsimagLite::Vector<MatrixType>::Type blocks_;
+	typename PsimagLite::Vector<SparseMatrixType>::Type sparseBlocks_;
+}; // class OperatorBlocks
+} // namespace Dmrg
+#endif // OPERATORBLOCKS_H
@@ -2,18 +2,27 @@
 #define OPERATORSTORAGE_H
 #include "BlockDiagonalMatrix.h"
 #include "BlockOffDiagMatrix.h"
+#include "OperatorBlocks.h"
 #include "Matrix.h"
 #include "Io/IoNg.h"
 
 // Selects storage for operators,
 // This can be just a CRS matrix or it can be the following.
-// Blocked off diagonal matrix,
-// but blocks are now dense matrices, in the future we might make them
-// MatrixDenseOrSparse type
+// Blocked off diagonal matrix, see OperatorBlocks,
+// with blocks that are dense or CRS matrices
 // It also selects BlockDiagonalType for storage that we know is
 // block diagonal, like the DMRG transformation matrix
 namespace Dmrg {
 
+/* PSIDOC OperatorStorage
+ Storage of an operator, either a CRS matrix or, after toBlocked(), the
+ blocks of its symmetry sectors, see OperatorBlocks and BlockedOperatorStorage
+ in SolverOptions, never both. Consumers that know about blocks, like ChangeOfBasis
+ and the Kron connections, use getBlocks(). getCRS() is only for CRS storage;
+ write(), the external products and the free functions below build a temporary
+ CRS matrix from the blocks, and toCRS() converts the storage back to CRS.
+ */
+
 template<typename ComplexOrRealType>
 class OperatorStorage {
 
@@ -29,6 +38,7 @@ public:
 	typedef PsimagLite::CrsMatrix<ComplexOrRealType> SparseMatrixType;
 	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
 	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef OperatorBlocks<ComplexOrRealType> OperatorBlocksType;
 
 	OperatorStorage() : justCrs_(true)
 	{}
@@ -39,50 +49,40 @@ public:
 
 	void makeDiagonal(SizeType rows, ComplexOrRealType value = 1) // replace this by a ctor
 	{
-		if (!justCrs_)
-			throw PsimagLite::RuntimeError("OperatorStorage::makeDiagonal\n");
-
-		justCrs_ = true;
+		setCrsMode();
 		crs_.makeDiagonal(rows, value);
 	}
 
 	void read(PsimagLite::String label,
 	          PsimagLite::IoNgSerializer& io)
 	{
-		if (justCrs_)
-			return crs_.read(label, io);
-
-		throw PsimagLite::RuntimeError("OperatorStorage::read\n");
+		setCrsMode();
+		crs_.read(label, io);
 	}
 
+	// blocked storage is written as CRS, so that files do not depend on it
 	void write(PsimagLite::String label,
 	           PsimagLite::IoNgSerializer& io,
 	           PsimagLite::IoSerializer::WriteMode mode = PsimagLite::IoNgSerializer::NO_OVERWRITE)
 	const
 	{
-		if (justCrs_)
-			return crs_.write(label, io, mode);
-
-		throw PsimagLite::RuntimeError("OperatorStorage::write\n");
+		SparseMatrixType tmp;
+		getCRS(tmp).write(label, io, mode);
 	}
 
 	void overwrite(PsimagLite::String label,
 	               PsimagLite::IoNgSerializer& io) const
 	{
-		if (justCrs_)
-			return crs_.overwrite(label, io);
-
-		throw PsimagLite::RuntimeError("OperatorStorage::overwrite\n");
+		SparseMatrixType tmp;
+		getCRS(tmp).overwrite(label, io);
 	}
 
 	OperatorStorage operator+=(const OperatorStorage& other)
 	{
-		if (justCrs_ && other.justCrs_) {
-			crs_ += other.crs_;
-			return *this;
-		}
-
-		throw PsimagLite::RuntimeError("OperatorStorage::operator+=\n");
+		toCRS();
+		SparseMatrixType tmp;
+		crs_ += other.getCRS(tmp);
+		return *this;
 	}
 
 	OperatorStorage operator*=(const ComplexOrRealType& value)
@@ -92,23 +92,20 @@ public:
 			return *this;
 		}
 
-		throw PsimagLite::RuntimeError("OperatorStorage::operator*=\n");
+		blocks_ *= value;
+		return *this;
 	}
 
 	void fromDense(const PsimagLite::Matrix<ComplexOrRealType>& m)
 	{
-		if (!justCrs_)
-			throw PsimagLite::RuntimeError("OperatorStorage::fromDense()\n");
-
+		setCrsMode();
 		fullMatrixToCrsMatrix(crs_, m);
 	}
 
 	void clear()
 	{
-		if (justCrs_)
-			return crs_.clear();
-
-		throw PsimagLite::RuntimeError("OperatorStorage::clear()\n");
+		setCrsMode();
+		crs_.clear();
 	}
 
 	void checkValidity() const
@@ -116,7 +113,7 @@ public:
 		if (justCrs_)
 			return crs_.checkValidity();
 
-		throw PsimagLite::RuntimeError("OperatorStorage::checkValidity\n");
+		blocks_.checkValidity();
 	}
 
 	void conjugate()
@@ -124,13 +121,12 @@ public:
 		if (justCrs_)
 			return crs_.conjugate();
 
-		throw PsimagLite::RuntimeError("OperatorStorage::conjugate\n");
+		blocks_.conjugate();
 	}
 
 	void transpose()
 	{
-		if (!justCrs_)
-			throw PsimagLite::RuntimeError("OperatorStorage::transpose\n");
+		toCRS();
 
 		// transpose conjugate
 		SparseMatrixType copy = crs_;
@@ -143,14 +139,10 @@ public:
 	void rotate(const PsimagLite::CrsMatrix<ComplexOrRealType>& left,
 	            const PsimagLite::CrsMatrix<ComplexOrRealType>& right)
 	{
-		if (justCrs_) {
-			SparseMatrixType tmp;
-			multiply(tmp, crs_, right);
-			multiply(crs_, left, tmp);
-			return;
-		}
-
-		throw PsimagLite::RuntimeError("OperatorStorage::rotate\n");
+		toCRS();
+		SparseMatrixType tmp;
+		multiply(tmp, crs_, right);
+		multiply(crs_, left, tmp);
 	}
 
 	MatrixType toDense() const
@@ -158,30 +150,75 @@ public:
 		if (justCrs_)
 			return crs_.toDense();
 
-		throw PsimagLite::RuntimeError("OperatorStorage::toDense\n");
+		return blocks_.toDense();
 	}
 
 	const SparseMatrixType& getCRS() const
 	{
 		if (!justCrs_)
-			throw PsimagLite::RuntimeError("OperatorStorage::toCRS\n");
+			throw PsimagLite::RuntimeError("OperatorStorage::getCRS: blocked storage\n");
 		return crs_;
 	}
 
+	// The CRS matrix; for blocked storage it is built into tmp,
+	// and the reference returned is valid only while tmp is
+	const SparseMatrixType& getCRS(SparseMatrixType& tmp) const
+	{
+		if (justCrs_) return crs_;
+
+		blocks_.toSparse(tmp);
+		return tmp;
+	}
+
 	// FIXME TODO DELETE THIS FUNCTION!!
 	SparseMatrixType& getCRSNonConst()
 	{
-		if (!justCrs_)
-			throw PsimagLite::RuntimeError("OperatorStorage::toCRS\n");
+		toCRS();
 		return crs_;
 	}
 
+	// Converts to blocked storage with these partitions, see OperatorBlocks;
+	// blocks with a fraction of nonzeros below threshold stay sparse
+	void toBlocked(const VectorSizeType& partitions, RealType threshold)
+	{
+		if (!justCrs_ && blocks_.offsets() == partitions) return;
+
+		toCRS();
+		OperatorBlocksType blocks(crs_, partitions, threshold);
+		SparseMatrixType().swap(crs_);
+		blocks_ = blocks;
+		justCrs_ = false;
+	}
+
+	void toCRS()
+	{
+		if (justCrs_) return;
+
+		blocks_.toSparse(crs_);
+		justCrs_ = true;
+		blocks_ = OperatorBlocksType();
+	}
+
+	const OperatorBlocksType& getBlocks() const
+	{
+		if (justCrs_)
+			throw PsimagLite::RuntimeError("OperatorStorage::getBlocks\n");
+		return blocks_;
+	}
+
+	OperatorBlocksType& getBlocksNonConst()
+	{
+		if (justCrs_)
+			throw PsimagLite::RuntimeError("OperatorStorage::getBlocksNonConst\n");
+		return blocks_;
+	}
+
 	SizeType nonZeros() const
 	{
 		if (justCrs_)
 			return crs_.nonZeros();
 
-		throw PsimagLite::RuntimeError("OperatorStorage::nonZeros\n");
+		return blocks_.nonZeros();
 	}
 
 	SizeType rows() const
@@ -189,7 +226,7 @@ public:
 		if (justCrs_)
 			return crs_.rows();
 
-		throw PsimagLite::RuntimeError("OperatorStorage::rows()\n");
+		return blocks_.rows();
 	}
 
 	SizeType cols() const
@@ -197,7 +234,7 @@ public:
 		if (justCrs_)
 			return crs_.cols();
 
-		throw PsimagLite::RuntimeError("OperatorStorage::cols()\n");
+		return blocks_.cols();
 	}
 
 	bool justCRS() const { return justCrs_; }
@@ -205,29 +242,27 @@ public:
 	friend void transposeConjugate(OperatorStorage& dest,
 	                               const OperatorStorage& src)
 	{
-		if (dest.justCRS() && src.justCRS())
+		if (src.justCRS()) {
+			dest.setCrsMode();
 			return transposeConjugate(dest.crs_, src.getCRS());
+		}
 
-		err("OperatorStorage: transposeConjugate\n");
+		SparseMatrixType().swap(dest.crs_);
+		dest.justCrs_ = false;
+		transposeConjugate(dest.blocks_, src.blocks_);
 	}
 
 	friend void fromCRS(OperatorStorage& dest,
 	                    const PsimagLite::CrsMatrix<ComplexOrRealType>& src)
 	{
-		if (dest.justCrs_) {
-			dest.crs_ = src;
-			return;
-		}
-
-		throw PsimagLite::RuntimeError("OperatorStorage: fromCRS\n");
+		dest.setCrsMode();
+		dest.crs_ = src;
 	}
 
 	friend void bcast(OperatorStorage& dest)
 	{
-		if (dest.justCrs_)
-			return bcast(dest.crs_);
-
-		err("OperatorStorage: bcast\n");
+		dest.toCRS();
+		bcast(dest.crs_);
 	}
 
 	// See CrsMatrix.h line 734
@@ -238,15 +273,14 @@ public:
 	                             bool order,
 	                             const VectorSizeType& permutationFull)
 	{
-		if (B.justCRS() && A.justCRS())
-			return externalProduct(B.crs_,
-			                       A.getCRS(),
-			                       nout,
-			                       signs,
-			                       order,
-			                       permutationFull);
-
-		throw PsimagLite::RuntimeError("OperatorStorage: externalProduct\n");
+		B.setCrsMode();
+		SparseMatrixType tmpA;
+		externalProduct(B.crs_,
+		                A.getCRS(tmpA),
+		                nout,
+		                signs,
+		                order,
+		                permutationFull);
 	}
 
 	friend void externalProduct2(OperatorStorage& C,
@@ -256,30 +290,38 @@ public:
 	                             bool order,
 	                             const VectorSizeType& permutationFull)
 	{
-		if (A.justCRS() && B.justCRS() && C.justCRS())
-			return externalProduct(C.crs_,
-			                       A.getCRS(),
-			                       B.getCRS(),
-			                       signs,
-			                       order,
-			                       permutationFull);
-
-		throw PsimagLite::RuntimeError("OperatorStorage: externalProduct\n");
+		C.setCrsMode();
+		SparseMatrixType tmpA;
+		SparseMatrixType tmpB;
+		externalProduct(C.crs_,
+		                A.getCRS(tmpA),
+		                B.getCRS(tmpB),
+		                signs,
+		                order,
+		                permutationFull);
 	}
 
 	friend void fullMatrixToCrsMatrix(OperatorStorage& dest,
 	                                  const PsimagLite::Matrix<ComplexOrRealType>& src)
 	{
-		if (dest.justCrs_)
-			return fullMatrixToCrsMatrix(dest.crs_, src);
-
-		err("OperatorStorage: fullMatrixToCrsMatrix\n");
+		dest.setCrsMode();
+		fullMatrixToCrsMatrix(dest.crs_, src);
 	}
 
 private:
 
+	void setCrsMode()
+	{
+		if (justCrs_) return;
+		justCrs_ = true;
+		blocks_ = OperatorBlocksType();
+	}
+
 	bool justCrs_;
+	// empty unless justCrs_
 	SparseMatrixType crs_;
+	// empty if justCrs_
+	OperatorBlocksType blocks_;
 };
 
 template<typename ComplexOrRealType>
@@ -287,10 +329,8 @@ OperatorStorage<ComplexOrRealType>
 operator*(const typename OperatorStorage<ComplexOrRealType>::RealType& value,
           const OperatorStorage<ComplexOrRealType>& storage)
 {
-	if (storage.justCRS())
-		return storage.getCRS()*value;
-
-	throw PsimagLite::RuntimeError("OperatorStorage: operator*\n");
+	typename OperatorStorage<ComplexOrRealType>::SparseMatrixType tmp;
+	return storage.getCRS(tmp)*value;
 }
 
 template<typename ComplexOrRealType>
@@ -298,57 +338,47 @@ OperatorStorage<ComplexOrRealType>
 operator*(const OperatorStorage<ComplexOrRealType>& a,
           const OperatorStorage<ComplexOrRealType>& b)
 {
-	if (a.justCRS() && b.justCRS())
-		return OperatorStorage<ComplexOrRealType>(a.getCRS()*b.getCRS());
-
-	throw PsimagLite::RuntimeError("OperatorStorage: operator*\n");
+	typename OperatorStorage<ComplexOrRealType>::SparseMatrixType tmpA;
+	typename OperatorStorage<ComplexOrRealType>::SparseMatrixType tmpB;
+	return OperatorStorage<ComplexOrRealType>(a.getCRS(tmpA)*b.getCRS(tmpB));
 }
 
 template<typename ComplexOrRealType>
 void crsMatrixToFullMatrix(PsimagLite::Matrix<ComplexOrRealType>& dest,
                            const OperatorStorage<ComplexOrRealType>& src)
 {
-	if (src.justCRS())
-		return crsMatrixToFullMatrix(dest, src.getCRS());
-
-	err("OperatorStorage: crsMatrixToFullMatrix\n");
+	typename OperatorStorage<ComplexOrRealType>::SparseMatrixType tmp;
+	crsMatrixToFullMatrix(dest, src.getCRS(tmp));
 }
 
 template<typename ComplexOrRealType>
 PsimagLite::Matrix<ComplexOrRealType> multiplyTc(const OperatorStorage<ComplexOrRealType>& src1,
                                                  const OperatorStorage<ComplexOrRealType>& src2)
 {
-	if (src1.justCRS() && src2.justCRS())
-		return multiplyTc(src1.getCRS(), src2.getCRS());
-
-	throw PsimagLite::RuntimeError("OperatorStorage: multiplyTc\n");
+	typename OperatorStorage<ComplexOrRealType>::SparseMatrixType tmp1;
+	typename OperatorStorage<ComplexOrRealType>::SparseMatrixType tmp2;
+	return multiplyTc(src1.getCRS(tmp1), src2.getCRS(tmp2));
 }
 
 template<typename ComplexOrRealType>
 bool isHermitian(const OperatorStorage<ComplexOrRealType>& src)
 {
-	if (src.justCRS())
-		return isHermitian(src.getCRS());
-
-	throw PsimagLite::RuntimeError("OperatorStorage: isHermitian\n");
+	typename OperatorStorage<ComplexOrRealType>::SparseMatrixType tmp;
+	return isHermitian(src.getCRS(tmp));
 }
 
 template<typename ComplexOrRealType>
 bool isAntiHermitian(const OperatorStorage<ComplexOrRealType>& src)
 {
-	if (src.justCRS())
-		return isAntiHermitian(src.getCRS());
-
-	throw PsimagLite::RuntimeError("OperatorStorage: isHermitian\n");
+	typename OperatorStorage<ComplexOrRealType>::SparseMatrixType tmp;
+	return isAntiHermitian(src.getCRS(tmp));
 }
 
 template<typename ComplexOrRealType>
 bool isTheIdentity(const OperatorStorage<ComplexOrRealType>& src)
 {
-	if (src.justCRS())
-		return isTheIdentity(src.getCRS());
-
-	throw PsimagLite::RuntimeError("OperatorStorage: isTheIdentity\n");
+	typename OperatorStorage<ComplexOrRealType>::SparseMatrixType tmp;
+	return isTheIdentity(src.getCRS(tmp));
 }
 
 template<typename ComplexOrRealType>
@@ -84,8 +84,10 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Complex.h"
 #include "Concurrency.h"
 #include "Parallelizer.h"
+#include "Parallelizer2.h"
 #include "BlockOffDiagMatrix.h"
 #include "ChangeOfBasis.h"
+#include "ChangeOfBasisBatched.h"
 #include "Operator.h"
 #include "Matrix.h"
 
@@ -124,6 +126,7 @@ public:
 	typedef typename OperatorType::StorageType OperatorStorageType;
 	typedef PsimagLite::Matrix<SparseElementType> DenseMatrixType;
 	typedef ChangeOfBasis<OperatorStorageType, DenseMatrixType> ChangeOfBasisType;
+	typedef ChangeOfBasisBatched<OperatorStorageType, DenseMatrixType> ChangeOfBasisBatchedType;
 	typedef typename OperatorType::StorageType StorageType;
 	typedef typename StorageType::value_type ComplexOrRealType;
 	typedef typename PsimagLite::Real<ComplexOrRealType>::Type RealType;
@@ -290,11 +293,55 @@ public:
 		return operators_.size();
 	}
 
+	// of local operators, super operators, and the Hamiltonian
+	SizeType nonZeros() const
+	{
+		SizeType sum = hamiltonian_.nonZeros();
+		for (SizeType i = 0; i < operators_.size(); ++i)
+			sum += operators_[i].getStorage().nonZeros();
+		for (SizeType i = 0; i < superOps_.size(); ++i)
+			sum += superOps_[i].getStorage().nonZeros();
+		return sum;
+	}
+
+	static void setBatchedChangeOfBasis(bool flag)
+	{
+		batchedChangeOfBasis_ = flag;
+	}
+
+	static void setBlockedStorage(bool flag, RealType denseSparseThreshold)
+	{
+		blockedStorage_ = flag;
+		blockedThreshold_ = denseSparseThreshold;
+	}
+
+	// local operators to blocked storage, see OperatorStorage, if BlockedOperatorStorage
+	void toBlocked(const VectorSizeType& partitions)
+	{
+		if (!blockedStorage_) return;
+
+		PsimagLite::Parallelizer2<> parallelizer2(PsimagLite::Concurrency::codeSectionParams);
+		parallelizer2.parallelFor(0,
+		                          operators_.size(),
+		                          [this, &partitions](SizeType i, SizeType) {
+			this->operators_[i].getStorageNonConst().toBlocked(partitions, blockedThreshold_);
+		});
+	}
+
 	void changeBasis(const BlockDiagonalMatrixType& ftransform,
 	                 const PairSizeSizeType& startEnd,
 	                 SizeType gemmRnb,
 	                 SizeType threadsForGemmR)
 	{
+		if (batchedChangeOfBasis_ &&
+		        !ProgramGlobals::oldChangeOfBasis &&
+		        superOps_.size() == 0) {
+			changeBasisBatched(ftransform, startEnd, gemmRnb, threadsForGemmR);
+			hamiltonian_.checkValidity();
+			ChangeOfBasisType::changeBasis(hamiltonian_, ftransform, gemmRnb, threadsForGemmR);
+			return;
+		}
+
 		typedef PsimagLite::Parallelizer<MyLoop> ParallelizerType;
 		ParallelizerType threadObject(PsimagLite::Concurrency::codeSectionParams);
 
@@ -404,57 +451,47 @@ public:
 
 private:
 
+	// in parallel over operators; the sign vectors depend only on whether
+	// the operator is a fermion or a boson, so both are computed up front
 	void setToProductLocal(const BasisType& basis2,
 	                       const ThisType& ops2,
 		                   const BasisType& basis3,
 		                   const ThisType& ops3,
 	                       const VectorSizeType& permutationInverse)
 	{
-		typename PsimagLite::Vector<RealType>::Type fermionicSigns;
+		VectorRealType signsBoson;
+		VectorRealType signsFermion;
+		fillBothSigns(signsBoson, signsFermion, basis2);
 		SizeType nlocalOps = ops2.sizeOfLocal() + ops3.sizeOfLocal();
 		operators_.resize(nlocalOps);
-		ProgramGlobals::FermionOrBosonEnum savedSign = ProgramGlobals::FermionOrBosonEnum::BOSON;
-
-		for (SizeType i = 0; i < nlocalOps; ++i) {
-			if (i < ops2.sizeOfLocal()) {
-				const OperatorType& myOp = ops2.getLocalByIndex(i);
-				bool isFermion = (myOp.fermionOrBoson() ==
-				                  ProgramGlobals::FermionOrBosonEnum::FERMION);
-				if (savedSign != myOp.fermionOrBoson() || fermionicSigns.size() == 0) {
-					utils::fillFermionicSigns(fermionicSigns,
-					                          basis2.signs(),
-					                          (isFermion) ? -1 : 1);
-					savedSign = myOp.fermionOrBoson();
-				}
-
-				crossProductForLocal(i,
-				                     myOp,
-				                     basis3.size(),
-				                     fermionicSigns,
-				                     true,
-				                     permutationInverse);
-
-			} else {
-				const OperatorType& myOp = ops3.getLocalByIndex(i - ops2.sizeOfLocal());
-
-				bool isFermion = (myOp.fermionOrBoson() ==
-				                  ProgramGlobals::FermionOrBosonEnum::FERMION);
-
-				if (savedSign != myOp.fermionOrBoson() || fermionicSigns.size() == 0) {
-					utils::fillFermionicSigns(fermionicSigns,
-					                          basis2.signs(),
-					                          (isFermion) ? -1 : 1);
-					savedSign = myOp.fermionOrBoson();
-				}
-
-				crossProductForLocal(i,
-				                     myOp,
-				                     basis2.size(),
-				                     fermionicSigns,
-				                     false,
-				                     permutationInverse);
-			}
-		}
+		const SizeType nops2 = ops2.sizeOfLocal();
+
+		PsimagLite::Parallelizer2<> parallelizer2(PsimagLite::Concurrency::codeSectionParams);
+		parallelizer2.parallelFor(0,
+		                          nlocalOps,
+		                          [this,
+		                          nops2,
+		                          &ops2,
+		                          &ops3,
+		                          &basis2,
+		                          &basis3,
+		                          &signsBoson,
+		                          &signsFermion,
+		                          &permutationInverse]
+		                          (SizeType i, SizeType) {
+			const bool option = (i < nops2);
+			const OperatorType& myOp = (option) ? ops2.getLocalByIndex(i)
+			                                    : ops3.getLocalByIndex(i - nops2);
+			const bool isFermion = (myOp.fermionOrBoson() ==
+			                        ProgramGlobals::FermionOrBosonEnum::FERMION);
+
+			this->crossProductForLocal(i,
+			                           myOp,
+			                           (option) ? basis3.size() : basis2.size(),
+			                           (isFermion) ? signsFermion : signsBoson,
+			                           option,
+			                           permutationInverse);
+		});
 	}
 
 	template<typename SomeSuperOperatorHelperType>
@@ -466,13 +503,26 @@ private:
 	                       const SomeSuperOperatorHelperType& someSuperOpHelper)
 	{
 		if (someSuperOpHelper.size() == 0) return;
-		typename PsimagLite::Vector<RealType>::Type fermionicSigns;
+		VectorRealType signsBoson;
+		VectorRealType signsFermion;
+		fillBothSigns(signsBoson, signsFermion, basis2);
 		SizeType nSuperOps = someSuperOpHelper.size();
 		superOps_.resize(nSuperOps);
-		ProgramGlobals::FermionOrBosonEnum savedSign = ProgramGlobals::FermionOrBosonEnum::BOSON;
 		typedef typename SomeSuperOperatorHelperType::PairBoolSizeType PairBoolSizeType;
 		const bool option = (basis3.block().size() == 1);
-		for (SizeType i = 0; i < nSuperOps; ++i) {
+
+		PsimagLite::Parallelizer2<> parallelizer2(PsimagLite::Concurrency::codeSectionParams);
+		parallelizer2.parallelFor(0,
+		                          nSuperOps,
+		                          [this,
+		                          option,
+		                          &ops2,
+		                          &ops3,
+		                          &someSuperOpHelper,
+		                          &signsBoson,
+		                          &signsFermion,
+		                          &permutationInverse]
+		                          (SizeType i, SizeType) {
 			const PairBoolSizeType op2Index  = someSuperOpHelper.leftOperatorIndex(i);
 			const PairBoolSizeType op3Index = someSuperOpHelper.rightOperatorIndex(i);
 			const OperatorType& op1 = (!op2Index.first) ? ops2.getLocalByIndex(op2Index.second)
@@ -483,15 +533,20 @@ private:
 			                                                                          second);
 			bool isFermion = (op3.fermionOrBoson() == ProgramGlobals::FermionOrBosonEnum::FERMION);
 
-			if (savedSign != op3.fermionOrBoson() || fermionicSigns.size() == 0) {
-				utils::fillFermionicSigns(fermionicSigns, basis2.signs(), (isFermion) ? -1 : 1);
-				savedSign = op3.fermionOrBoson();
-			}
-
-
-			superOps_[i].outerProduct(op1, op3, fermionicSigns, option, permutationInverse);
+			this->superOps_[i].outerProduct(op1,
+			                                op3,
+			                                (isFermion) ? signsFermion : signsBoson,
+			                                option,
+			                                permutationInverse);
+		});
+	}
 
-		}
+	static void fillBothSigns(VectorRealType& signsBoson,
+	                          VectorRealType& signsFermion,
+	                          const BasisType& basis2)
+	{
+		utils::fillFermionicSigns(signsBoson, basis2.signs(), 1);
+		utils::fillFermionicSigns(signsFermion, basis2.signs(), -1);
 	}
 
 	/* PSIDOC OperatorsExternalProduct
@@ -536,6 +591,28 @@ private:
 		// apply(operators_[i]);
 	}
 
+	// the same as MyLoop, with the GEMMs of all operators batched
+	void changeBasisBatched(const BlockDiagonalMatrixType& ftransform,
+	                        const PairSizeSizeType& startEnd,
+	                        SizeType gemmRnb,
+	                        SizeType threadsForGemmR)
+	{
+		typename ChangeOfBasisBatchedType::VectorOperatorStoragePtrType storages;
+		for (SizeType k = 0; k < operators_.size(); ++k) {
+			const bool excluded = (changeAll_ != ChangeAllEnum::TRUE_SET &&
+			        (k < startEnd.first || k >= startEnd.second));
+			if (excluded) {
+				operators_[k].clear();
+				continue;
+			}
+
+			storages.push_back(&(operators_[k].getStorageNonConst()));
+		}
+
+		ChangeOfBasisBatchedType changeOfBasisBatched(ftransform, gemmRnb, threadsForGemmR);
+		changeOfBasisBatched(storages);
+	}
+
 	static void printChangeAll()
 	{
 		PsimagLite::String msg("INFO: Operators::changeAll_=");
@@ -563,6 +640,9 @@ private:
 	}
 
 	static ChangeAllEnum changeAll_;
+	static bool batchedChangeOfBasis_;
+	static bool blockedStorage_;
+	static RealType blockedThreshold_;
 	ChangeOfBasisType changeOfBasis_;
 	VectorOperatorType operators_;
 	VectorOperatorType superOps_;
@@ -574,6 +654,15 @@ template<typename T>
 typename Operators<T>::ChangeAllEnum Operators<T>::changeAll_ =
         Operators<T>::ChangeAllEnum::UNSET;
 
+template<typename T>
+bool Operators<T>::batchedChangeOfBasis_ = false;
+
+template<typename T>
+bool Operators<T>::blockedStorage_ = false;
+
+template<typename T>
+typename Operators<T>::RealType Operators<T>::blockedThreshold_ = 0.2;
+
 } // namespace Dmrg
 
 /*@}*/
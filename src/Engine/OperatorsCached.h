@@ -1,7 +1,6 @@
 #ifndef OPERATORSCACHED_H
 #define OPERATORSCACHED_H
 #include "ProgramGlobals.h"
-#include "Concurrency.h"
 
 namespace Dmrg {
 
@@ -17,107 +16,85 @@ public:
 	typedef typename BasisWithOperatorsType::OperatorsType OperatorsType;
 	typedef typename OperatorsType::OperatorType OperatorType;
 	typedef typename OperatorType::StorageType OperatorStorageType;
-	typedef PsimagLite::Concurrency ConcurrencyType;
 	typedef typename PsimagLite::Vector<OperatorStorageType*>::Type VectorOperatorStorageType;
-	typedef typename PsimagLite::Vector<VectorOperatorStorageType>::Type
-	VectorVectorOperatorStorageType;
 	typedef BlockType VectorSizeType;
 
 	OperatorsCached(const LeftRightSuperType& lrs)
-	    : lrs_(lrs),
-	      garbage_(ConcurrencyType::codeSectionParams.npthreads),
-	      seen_(ConcurrencyType::codeSectionParams.npthreads)
-	{
-		ConcurrencyType::mutexInit(&mutex_);
-	}
+	    : lrs_(lrs)
+	{}
 
 	~OperatorsCached()
 	{
-		const SizeType n = garbage_.size();
-		for (SizeType i = 0; i < n; ++i) {
-			const SizeType m = garbage_[i].size();
-			for (SizeType j = 0; j < m; ++j) {
-				delete garbage_[i][j];
-				garbage_[i][j] = 0;
-			}
+		for (SizeType i = 0; i < conjugates_.size(); ++i) {
+			delete conjugates_[i];
+			conjugates_[i] = 0;
 		}
-
-		ConcurrencyType::mutexDestroy(&mutex_);
 	}
 
-	void clearThreadSelves() const
+	// computes the transpose conjugate of an operator with modifier C, once;
+	// to be called from one thread for all links, before any reducedOperator
+	void prepare(char modifier,
+	             SizeType iifirst,
+	             const ProgramGlobals::SysOrEnvEnum type)
 	{
-		threadSelves_.clear();
+		if (modifier == 'N') return;
+
+		assert(modifier == 'C');
+		const SizeType packed = packedIndex(iifirst, type);
+		if (packed >= conjugates_.size()) conjugates_.resize(packed + 1, 0);
+		if (conjugates_[packed]) return;
+
+		OperatorStorageType* mc = new OperatorStorageType;
+		transposeConjugate(*mc, storage(iifirst, type));
+		mc->checkValidity();
+		conjugates_[packed] = mc;
 	}
 
+	// read only, and so safe to call from all threads; the transpose
+	// conjugates are shared by all threads
 	const OperatorStorageType& reducedOperator(char modifier,
 	                                           SizeType iifirst,
 	                                           const ProgramGlobals::SysOrEnvEnum type) const
 	{
-
-		assert(!BasisType::useSu2Symmetry());
-
-		const OperatorStorageType* m = 0;
-		if (type == ProgramGlobals::SysOrEnvEnum::SYSTEM) {
-			m = &(lrs_.left().localOperator(iifirst).getStorage());
-		} else {
-			assert(type == ProgramGlobals::SysOrEnvEnum::ENVIRON);
-			m =&(lrs_.right().localOperator(iifirst).getStorage());
-		}
-
-		m->checkValidity();
-		if (modifier == 'N') return *m;
+		const OperatorStorageType& m = storage(iifirst, type);
+		m.checkValidity();
+		if (modifier == 'N') return m;
 
 		assert(modifier == 'C');
-		SizeType typeIndex = (type == ProgramGlobals::SysOrEnvEnum::SYSTEM) ? 0 : 1;
-		SizeType packed = typeIndex + iifirst*2;
-		const ConcurrencyType::PthreadtType threadSelf = ConcurrencyType::threadSelf();
-		const SizeType threadNum = threadNumberFromSelf(threadSelf);
-
-		if (garbage_.size() != seen_.size())
-			err("reducedOperator: FATAL: internal error\n");
-
-		if (garbage_.size() <= threadNum || seen_.size() <= threadNum)
-			err("reducedOperator: FATAL: " + ttos(threadNum) + " >= " +
-			    ttos(garbage_.size()) + "\n");
-
-		int indexOfSeen = PsimagLite::indexOrMinusOne(seen_[threadNum], packed);
-		if (indexOfSeen >= 0) {
-			assert(static_cast<SizeType>(indexOfSeen) < garbage_[threadNum].size());
-			return *(garbage_[threadNum][indexOfSeen]);
-		}
-
-		OperatorStorageType* mc = new OperatorStorageType;
-		transposeConjugate(*mc, *m);
-		garbage_[threadNum].push_back(mc);
-		seen_[threadNum].push_back(packed);
-		mc->checkValidity();
+		const SizeType packed = packedIndex(iifirst, type);
+		if (packed >= conjugates_.size() || !conjugates_[packed])
+			err("reducedOperator: FATAL: transpose conjugate of " + ttos(iifirst) +
+			    " was not prepared\n");
 
-		return *mc;
+		return *(conjugates_[packed]);
 	}
 
 private:
 
-	SizeType threadNumberFromSelf(ConcurrencyType::PthreadtType threadSelf) const
+	const OperatorStorageType& storage(SizeType iifirst,
+	                                   const ProgramGlobals::SysOrEnvEnum type) const
 	{
-		ConcurrencyType::mutexLock(&mutex_);
+		assert(!BasisType::useSu2Symmetry());
 
-		int threadPreNum = PsimagLite::indexOrMinusOne(threadSelves_, threadSelf);
-		if (threadPreNum < 0) {
-			threadPreNum = threadSelves_.size();
-			threadSelves_.push_back(threadSelf);
-		}
+		if (type == ProgramGlobals::SysOrEnvEnum::SYSTEM)
+			return lrs_.left().localOperator(iifirst).getStorage();
 
-		ConcurrencyType::mutexUnlock(&mutex_);
+		assert(type == ProgramGlobals::SysOrEnvEnum::ENVIRON);
+		return lrs_.right().localOperator(iifirst).getStorage();
+	}
 
-		return threadPreNum;
+	static SizeType packedIndex(SizeType iifirst, const ProgramGlobals::SysOrEnvEnum type)
+	{
+		const SizeType typeIndex = (type == ProgramGlobals::SysOrEnvEnum::SYSTEM) ? 0 : 1;
+		return typeIndex + iifirst*2;
 	}
 
+	OperatorsCached(const OperatorsCached&);
+
+	OperatorsCached& operator=(const OperatorsCached&);
+
 	const LeftRightSuperType& lrs_;
-	mutable VectorVectorOperatorStorageType garbage_;
-	mutable typename PsimagLite::Vector<BlockType>::Type seen_;
-	mutable ConcurrencyType::MutexType mutex_;
-	mutable PsimagLite::Vector<ConcurrencyType::PthreadtType>::Type threadSelves_;
+	VectorOperatorStorageType conjugates_;
 };
 }
 #endif // OPERATORSCACHED_H
@@ -85,6 +85,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 
 namespace Dmrg {
 
+// One task per row i of w, see TwoPointCorrelations::calcRow()
 template<typename TwoPointCorrelationsType>
 class Parallel2PointCorrelations {
 
@@ -94,12 +95,11 @@ public:
 	typedef typename TwoPointCorrelationsType::SparseMatrixType SparseMatrixType;
 	typedef typename MatrixType::value_type FieldType;
 	typedef PsimagLite::Concurrency ConcurrencyType;
-	typedef std::pair<SizeType,SizeType> PairType;
 	typedef typename PsimagLite::Real<FieldType>::Type RealType;
 
 	Parallel2PointCorrelations(MatrixType& w,
 	                           const TwoPointCorrelationsType& twopoint,
-	                           const typename PsimagLite::Vector<PairType>::Type& pairs,
+	                           SizeType rows,
 	                           const SparseMatrixType& O1,
 	                           const SparseMatrixType& O2,
 	                           ProgramGlobals::FermionOrBosonEnum fermionicSign,
@@ -107,7 +107,7 @@ public:
 	                           const PsimagLite::GetBraOrKet& ket)
 	    : w_(w),
 	      twopoint_(twopoint),
-	      pairs_(pairs),
+	      rows_(rows),
 	      O1_(O1),
 	      O2_(O2),
 	      fermionicSign_(fermionicSign),
@@ -117,24 +117,22 @@ public:
 
 	void doTask(SizeType taskNumber, SizeType)
 	{
-		SizeType i = pairs_[taskNumber].first;
-		SizeType j = pairs_[taskNumber].second;
-		w_(i,j) = twopoint_.calcCorrelation(i,
-		                                    j,
-		                                    O1_,
-		                                    O2_,
-		                                    fermionicSign_,
-		                                    bra_,
-		                                    ket_);
+		twopoint_.calcRow(w_,
+		                  taskNumber,
+		                  O1_,
+		                  O2_,
+		                  fermionicSign_,
+		                  bra_,
+		                  ket_);
 	}
 
-	SizeType tasks() const { return pairs_.size(); }
+	SizeType tasks() const { return rows_; }
 
 private:
 
 	MatrixType& w_;
 	const TwoPointCorrelationsType& twopoint_;
-	const typename PsimagLite::Vector<PairType>::Type& pairs_;
+	SizeType rows_;
 	const SparseMatrixType& O1_;
 	const SparseMatrixType& O2_;
 	const ProgramGlobals::FermionOrBosonEnum fermionicSign_;
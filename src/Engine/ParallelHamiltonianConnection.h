@@ -5,6 +5,15 @@
 
 namespace Dmrg {
 
+/* PSIDOC ParallelHamiltonianConnection
+ Computes x += H y for MatrixVectorOnTheFly and MatrixVectorStored.
+ The rows of x are split into blocks, UNITS_PER_THREAD per thread, and
+ each task adds to its own block of rows the left and right Hamiltonians
+ and all connections, so that threads never write to the same row.
+ No copies of x are made per thread and no reduction is needed, except
+ with MPI, where the contributions of all ranks go through one buffer
+ that is summed over ranks.
+ */
 template<typename HamiltonianConnectionType>
 class ParallelHamiltonianConnection {
 
@@ -17,6 +26,9 @@ class ParallelHamiltonianConnection {
 	typedef typename HamiltonianConnectionType::LinkType LinkType;
 	typedef typename ModelHelperType::Aux AuxType;
 
+	// blocks of rows per thread, to even out rows of different cost
+	static const SizeType UNITS_PER_THREAD = 4;
+
 public:
 
 	ParallelHamiltonianConnection(VectorType& x,
@@ -27,70 +39,58 @@ public:
 	      y_(y),
 	      hc_(hc),
 	      aux_(aux),
-	      xtemp_(ConcurrencyType::storageSize(ConcurrencyType::codeSectionParams.npthreads))
+	      useMpi_(mpiRun()),
+	      blockSize_(1)
 	{
-		hc_.clearThreadSelves();
+		const SizeType threads = std::max(ConcurrencyType::codeSectionParams.npthreads,
+		                                  static_cast<SizeType>(1));
+		const SizeType blocks = std::max(threads*UNITS_PER_THREAD, static_cast<SizeType>(1));
+		blockSize_ = std::max((x_.size() + blocks - 1)/blocks, static_cast<SizeType>(1));
+
+		if (useMpi_) xmpi_.resize(x_.size(), 0.0);
 	}
 
-	void doTask(SizeType taskNumber ,SizeType threadNum)
+	void doTask(SizeType taskNumber, SizeType)
 	{
-		if (xtemp_[threadNum].size() != x_.size())
-			xtemp_[threadNum].resize(x_.size(),0.0);
-
-		if (taskNumber == 0) {
-			hc_.modelHelper().hamiltonianLeftProduct(xtemp_[threadNum], y_, aux_);
-//			const SparseMatrixType& hamiltonian = hc_.modelHelper().leftRightSuper().
-//			        left().hamiltonian().getCRS();
-//			hc_.kroneckerDumper().push(true, hamiltonian, y_);
-			return;
-		}
-
-		if (taskNumber == 1) {
-			hc_.modelHelper().hamiltonianRightProduct(xtemp_[threadNum], y_, aux_);
-//			const SparseMatrixType& hamiltonian = hc_.modelHelper().leftRightSuper().
-//			        right().hamiltonian().getCRS();
-	//		hc_.kroneckerDumper().push(false, hamiltonian, y_);
-			return;
+		const SizeType rowBegin = taskNumber*blockSize_;
+		if (rowBegin >= x_.size()) return;
+		const SizeType rowEnd = std::min(rowBegin + blockSize_, x_.size());
+
+		VectorType& x = (useMpi_) ? xmpi_ : x_;
+		const ModelHelperType& modelHelper = hc_.modelHelper();
+
+		modelHelper.hamiltonianLeftProduct(x, y_, aux_, rowBegin, rowEnd);
+		modelHelper.hamiltonianRightProduct(x, y_, aux_, rowBegin, rowEnd);
+
+		const SizeType total = hc_.tasks();
+		for (SizeType ix = 0; ix < total; ++ix) {
+			OperatorStorageType const* A = 0;
+			OperatorStorageType const* B = 0;
+			const LinkType& link2 = hc_.getKron(&A, &B, ix);
+			modelHelper.fastOpProdInter(x,
+			                            y_,
+			                            A->getCRS(),
+			                            B->getCRS(),
+			                            link2,
+			                            aux_,
+			                            rowBegin,
+			                            rowEnd);
 		}
-
-		assert(taskNumber > 1);
-		taskNumber -= 2;
-
-		OperatorStorageType const* A = 0;
-		OperatorStorageType const* B = 0;
-		const LinkType& link2 = hc_.getKron(&A, &B, taskNumber);
-		hc_.modelHelper().fastOpProdInter(xtemp_[threadNum],
-		                                  y_,
-		                                  A->getCRS(),
-		                                  B->getCRS(),
-		                                  link2,
-		                                  aux_);
-
-//		hc_.kroneckerDumper().push(A->getCRS(),
-//		                           B->getCRS(),
-//		                           link2.value,
-//		                           link2.fermionOrBoson,
-//		                           y_);
 	}
 
-	SizeType tasks() const { return hc_.tasks() + 2; }
+	SizeType tasks() const
+	{
+		return (x_.size() + blockSize_ - 1)/blockSize_;
+	}
 
 	void sync()
 	{
-		SizeType total = 0;
-		for (SizeType threadNum = 0; threadNum < xtemp_.size(); threadNum++)
-			if (xtemp_[threadNum].size() == x_.size()) total++;
-
-		typename PsimagLite::Vector<ComplexOrRealType>::Type x(x_.size(),0);
-		for (SizeType threadNum = 0; threadNum < total; threadNum++)
-			for (SizeType i=0;i<x_.size();i++)
-				x[i]+=xtemp_[threadNum][i];
+		if (!useMpi_) return;
 
-		if (!ConcurrencyType::isMpiDisabled("HamiltonianConnection"))
-			PsimagLite::MPI::allReduce(x);
+		PsimagLite::MPI::allReduce(xmpi_);
 
-		for (SizeType i=0;i<x_.size();i++)
-			x_[i] += x[i];
+		for (SizeType i = 0; i < x_.size(); ++i)
+			x_[i] += xmpi_[i];
 	}
 
 	template<typename SomeConcurrencyType,typename SomeOtherConcurrencyType>
@@ -101,11 +101,23 @@ public:
 
 private:
 
+	// only an actual MPI run, with more than one rank, needs xmpi_ and
+	// the reduction in sync(); otherwise products go directly into x_
+	static bool mpiRun()
+	{
+		if (ConcurrencyType::isMpiDisabled("HamiltonianConnection"))
+			return false;
+
+		return (PsimagLite::MPI::commSize(PsimagLite::MPI::COMM_WORLD) > 1);
+	}
+
 	VectorType& x_;
 	const VectorType& y_;
 	const HamiltonianConnectionType& hc_;
 	const AuxType& aux_;
-	typename PsimagLite::Vector<VectorType>::Type xtemp_;
+	bool useMpi_;
+	SizeType blockSize_;
+	VectorType xmpi_;
 };
 }
 #endif // PARALLELHAMILTONIANCONNECTION_H
@@ -0,0 +1,168 @@
+#ifndef PARALLEL_MANYPOINT_CORRELATIONS_H
+#define PARALLEL_MANYPOINT_CORRELATIONS_H
+
+#include "Vector.h"
+#include "Concurrency.h"
+#include "ProgramGlobals.h"
+
+namespace Dmrg {
+
+/* PSIDOC ParallelManyPointCorrelations
+ Three and four point correlations, see Observer, done in parallel by tasks.
+ A task fixes the first two sites, site0 and site1, and a range [begin, end) of
+ the third one, so that the operators grown for its first sites are shared by all
+ its tuples, see FourPointCorrelations. The values of each task are kept in order,
+ so that the caller can print all of them once the tasks are done.
+ */
+template<typename FourPointCorrelationsType, typename ManyPointActionType>
+class ParallelManyPointCorrelations {
+
+public:
+
+	typedef typename FourPointCorrelationsType::FieldType FieldType;
+	typedef typename FourPointCorrelationsType::VectorFieldType VectorFieldType;
+	typedef typename FourPointCorrelationsType::SparseMatrixType SparseMatrixType;
+	typedef typename FourPointCorrelationsType::BraketType BraketType;
+	typedef typename PsimagLite::Vector<VectorFieldType>::Type VectorVectorFieldType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+
+	struct TaskType {
+
+		TaskType(SizeType site0_, SizeType site1_, SizeType begin_, SizeType end_)
+		    : site0(site0_), site1(site1_), begin(begin_), end(end_)
+		{}
+
+		SizeType site0;
+		SizeType site1;
+		SizeType begin;
+		SizeType end;
+	};
+
+	typedef typename PsimagLite::Vector<TaskType>::Type VectorTaskType;
+
+	// three points, the third one in (site1, end) of each task
+	ParallelManyPointCorrelations(const FourPointCorrelationsType& fourpoint,
+	                              const BraketType& braket,
+	                              const VectorTaskType& tasks)
+	    : fourpoint_(fourpoint),
+	      braket_(braket),
+	      tasks_(tasks),
+	      cols_(0),
+	      action_(0),
+	      O2gt_(0),
+	      values_(tasks.size())
+	{}
+
+	// four points, the fourth one below cols; O2gt is the firstStage of
+	// site0 and site1 if it is the same for all tasks, and 0 otherwise
+	ParallelManyPointCorrelations(const FourPointCorrelationsType& fourpoint,
+	                              const BraketType& braket,
+	                              const VectorTaskType& tasks,
+	                              SizeType cols,
+	                              const ManyPointActionType& action,
+	                              const SparseMatrixType* O2gt)
+	    : fourpoint_(fourpoint),
+	      braket_(braket),
+	      tasks_(tasks),
+	      cols_(cols),
+	      action_(&action),
+	      O2gt_(O2gt),
+	      values_(tasks.size())
+	{}
+
+	void doTask(SizeType taskNumber, SizeType)
+	{
+		const TaskType& task = tasks_[taskNumber];
+		VectorFieldType& values = values_[taskNumber];
+
+		if (!action_) {
+			fourpoint_.threePoint(values, task.site0, task.site1, task.end, braket_);
+			return;
+		}
+
+		const ManyPointActionType& action = *action_;
+		auto pred = [&action, &task](SizeType site2, SizeType site3) {
+			return action(task.site0, task.site1, site2, site3);
+		};
+
+		if (!hasAnyTuple(task, pred)) return;
+
+		SparseMatrixType O2gtLocal;
+		const SparseMatrixType* O2gt = O2gt_;
+		if (!O2gt) {
+			const bool finalTransform = true;
+			fourpoint_.firstStage(O2gtLocal,
+			                      'N',
+			                      task.site0,
+			                      'N',
+			                      task.site1,
+			                      braket_,
+			                      0,
+			                      1,
+			                      finalTransform);
+			O2gt = &O2gtLocal;
+		}
+
+		fourpoint_.secondStage(values,
+		                       *O2gt,
+		                       task.site1,
+		                       'N',
+		                       'N',
+		                       task.begin,
+		                       task.end,
+		                       cols_,
+		                       braket_,
+		                       2,
+		                       3,
+		                       pred);
+	}
+
+	SizeType tasks() const { return tasks_.size(); }
+
+	// the number of tuples of each task, and so its cost
+	VectorSizeType weights() const
+	{
+		const SizeType n = tasks_.size();
+		VectorSizeType w(n, 0);
+		for (SizeType i = 0; i < n; ++i) {
+			const TaskType& task = tasks_[i];
+			if (!action_) {
+				w[i] = (task.end > task.site1) ? task.end - task.site1 : 0;
+				continue;
+			}
+
+			for (SizeType site2 = task.begin; site2 < task.end; ++site2)
+				w[i] += (cols_ > site2) ? cols_ - site2 : 0;
+		}
+
+		return w;
+	}
+
+	const VectorFieldType& values(SizeType taskNumber) const
+	{
+		assert(taskNumber < values_.size());
+		return values_[taskNumber];
+	}
+
+private:
+
+	template<typename SomePredicateType>
+	bool hasAnyTuple(const TaskType& task, const SomePredicateType& pred) const
+	{
+		for (SizeType site2 = task.begin; site2 < task.end; ++site2)
+			for (SizeType site3 = site2 + 1; site3 < cols_; ++site3)
+				if (pred(site2, site3)) return true;
+
+		return false;
+	}
+
+	const FourPointCorrelationsType& fourpoint_;
+	const BraketType& braket_;
+	const VectorTaskType& tasks_;
+	SizeType cols_;
+	const ManyPointActionType* action_;
+	const SparseMatrixType* O2gt_;
+	VectorVectorFieldType values_;
+}; // class ParallelManyPointCorrelations
+} // namespace Dmrg
+#endif // PARALLEL_MANYPOINT_CORRELATIONS_H
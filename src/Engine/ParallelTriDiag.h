@@ -79,9 +79,22 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 
 #include "Mpi.h"
 #include "Concurrency.h"
+#include "NoPthreadsNg.h"
+#include "Parallelizer.h"
+#include "LoadBalancerWeights.h"
+#include "NestedThreads.h"
 
 namespace Dmrg {
 
+/* PSIDOC ParallelTriDiag
+ Krylov tridiagonalization of each symmetry sector of one or more vectors phi,
+ see add(). Each sector of each phi needs its own Lanczos process, because the
+ Hamiltonian of each sector is different. With the SolverOption TridiagInParallel
+ these processes run concurrently, balanced by sector size, up to Threads= at a time
+ with ThreadsLevelTwo= threads for the matrix vector product of each one, see
+ NestedThreads; otherwise they run one after the other with all threads for each
+ matrix vector product.
+ */
 template<typename ModelType,typename LanczosSolverType, typename VectorWithOffsetType>
 class ParallelTriDiag {
 
@@ -92,8 +105,10 @@ class ParallelTriDiag {
 	typedef typename SparseMatrixType::value_type ComplexOrRealType;
 	typedef typename PsimagLite::Real<ComplexOrRealType>::Type RealType;
 	typedef typename LanczosSolverType::TridiagonalMatrixType TridiagonalMatrixType;
+	typedef typename LanczosSolverType::ParametersSolverType ParametersSolverType;
 	typedef typename ModelType::InputValidatorType InputValidatorType;
 	typedef PsimagLite::Concurrency ConcurrencyType;
+	typedef typename PsimagLite::Vector<SizeType>::Type VectorSizeType;
 
 public:
 
@@ -109,30 +124,123 @@ public:
 	                RealType currentTime,
 	                const ModelType& model,
 	                InputValidatorType& io)
-	    : phi_(phi),
-	      T_(T),
-	      V_(V),
-	      steps_(steps),
-	      lrs_(lrs),
+	    : lrs_(lrs),
 	      currentTime_(currentTime),
 	      model_(model),
-	      io_(io)
-	{}
+	      params_(io,"Tridiag")
+	{
+		params_.lotaMemory = true;
+		add(phi, T, V, steps);
+	}
+
+	ParallelTriDiag(const LeftRightSuperType& lrs,
+	                RealType currentTime,
+	                const ModelType& model,
+	                InputValidatorType& io)
+	    : lrs_(lrs),
+	      currentTime_(currentTime),
+	      model_(model),
+	      params_(io,"Tridiag")
+	{
+		params_.lotaMemory = true;
+	}
+
+	// T, V, and steps must have phi.sectors() entries each, and phi, T, V, and
+	// steps must outlive this object
+	void add(const VectorWithOffsetType& phi,
+	         VectorMatrixFieldType& T,
+	         VectorMatrixFieldType& V,
+	         typename PsimagLite::Vector<SizeType>::Type& steps)
+	{
+		const SizeType n = phi.sectors();
+		assert(T.size() == n && V.size() == n && steps.size() == n);
+
+		for (SizeType ii = 0; ii < n; ++ii)
+			tasks_.push_back(Task(phi, T[ii], V[ii], steps[ii], ii));
+	}
 
-	SizeType tasks() const { return phi_.sectors(); }
+	void run()
+	{
+		const SizeType n = tasks_.size();
+		const bool inParallel = model_.params().options.isSet("TridiagInParallel");
+		const SizeType npthreads = ConcurrencyType::codeSectionParams.npthreads;
+
+		if (!inParallel || n < 2 || npthreads < 2) {
+			typedef PsimagLite::NoPthreadsNg<ParallelTriDiag> ParallelizerType;
+			ParallelizerType threadedTriDiag(PsimagLite::CodeSectionParams(1));
+			threadedTriDiag.loopCreate(*this);
+			return;
+		}
+
+		VectorSizeType weights(n);
+		for (SizeType i = 0; i < n; ++i) {
+			const Task& task = tasks_[i];
+			weights[i] = task.phi.effectiveSize(task.phi.sector(task.ii));
+		}
+
+		NestedThreads nestedThreads(n);
+		PsimagLite::CodeSectionParams codeSectionParams(nestedThreads.outer());
+		PsimagLite::Parallelizer<ParallelTriDiag,
+		        PsimagLite::LoadBalancerWeights> threadedTriDiag(codeSectionParams);
+		threadedTriDiag.loopCreate(*this, weights);
+	}
+
+	// the largest number of Lanczos steps of each task, from the input file
+	// unless changed with maxSteps(steps)
+	SizeType maxSteps() const { return params_.steps; }
+
+	void maxSteps(SizeType steps)
+	{
+		assert(steps > 0);
+		params_.steps = steps;
+	}
+
+	SizeType tasks() const { return tasks_.size(); }
 
-	void doTask(SizeType ii, SizeType)
+	// the norm of the residual after the last Lanczos step of task taskNumber,
+	// in the order of add(), that is, the coefficient past its T; zero if the
+	// Lanczos process stopped because its Krylov space was invariant
+	RealType residual(SizeType taskNumber) const
 	{
-		SizeType i = phi_.sector(ii);
-		steps_[ii] = triDiag(phi_,T_[ii],V_[ii],i);
+		assert(taskNumber < tasks_.size());
+		return tasks_[taskNumber].residual;
+	}
+
+	void doTask(SizeType taskNumber, SizeType)
+	{
+		assert(taskNumber < tasks_.size());
+		Task& task = tasks_[taskNumber];
+		SizeType i = task.phi.sector(task.ii);
+		task.steps = triDiag(task.phi, task.T, task.V, task.residual, i);
 	}
 
 private:
 
+	struct Task {
+
+		Task(const VectorWithOffsetType& phi_,
+		     MatrixComplexOrRealType& T_,
+		     MatrixComplexOrRealType& V_,
+		     SizeType& steps_,
+		     SizeType ii_)
+		    : phi(phi_), T(T_), V(V_), steps(steps_), ii(ii_), residual(0)
+		{}
+
+		const VectorWithOffsetType& phi;
+		MatrixComplexOrRealType& T;
+		MatrixComplexOrRealType& V;
+		SizeType& steps;
+		SizeType ii;
+		RealType residual;
+	};
+
+	typedef typename PsimagLite::Vector<Task>::Type VectorTaskType;
+
 	SizeType triDiag(const VectorWithOffsetType& phi,
 	                 MatrixComplexOrRealType& T,
 	                 MatrixComplexOrRealType& V,
-	                 SizeType i0)
+	                 RealType& residual,
+	                 SizeType i0) const
 	{
 		const SizeType p = lrs_.super().findPartitionNumber(phi.offset(i0));
 		typename ModelHelperType::Aux aux(p, lrs_);
@@ -142,8 +250,8 @@ private:
 		                                                 model_.superOpHelper());
 		typename LanczosSolverType::MatrixType lanczosHelper(model_, hc, aux);
 
-		typename LanczosSolverType::ParametersSolverType params(io_,"Tridiag");
-		params.lotaMemory = true;
+		// a copy for each task, the input file is read only once, in the ctor
+		ParametersSolverType params = params_;
 
 		LanczosSolverType lanczosSolver(lanczosHelper, params);
 
@@ -156,17 +264,17 @@ private:
 
 		V = lanczosSolver.lanczosVectors();
 
-		return lanczosSolver.steps();
+		// ab.b(j) is the norm of the residual after step j; T holds b(0) to b(steps-2)
+		const SizeType steps = lanczosSolver.steps();
+		residual = (steps > 0) ? std::abs(ab.b(steps - 1)) : 0;
+		return steps;
 	}
 
-	const VectorWithOffsetType& phi_;
-	VectorMatrixFieldType& T_;
-	VectorMatrixFieldType& V_;
-	typename PsimagLite::Vector<SizeType>::Type& steps_;
 	const LeftRightSuperType& lrs_;
 	RealType currentTime_;
 	const ModelType& model_;
-	InputValidatorType& io_;
+	ParametersSolverType params_;
+	VectorTaskType tasks_;
 }; // class ParallelTriDiag
 } // namespace Dmrg
 
@@ -94,6 +94,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "ProgressIndicator.h"
 #include <sstream>
 #include "Options.h"
+#include "Hdf5ThreadSafe.h"
 #include <sys/types.h>
 #include <unistd.h>
 
@@ -132,6 +133,13 @@ The first movement starts from where the infinite loop left off, at the middle o
  lattice.
 See the below for more information and examples on Finite Loops.
 
+\item[ObserveMemory=integer] Only used by observe. If positive, the data of
+the finite steps is read from disk when needed, and at most this many bytes of it
+are kept in memory, evicting the least recently used; see ObserverHelper.
+If zero, the default, all of it is read at the start.
+With pthreads, the next step is read in the background, which needs an HDF5
+library built thread safe, checked at startup.
+
 \end{itemize}
 */
 template<typename FieldType,typename InputValidatorType, typename QnType>
@@ -157,6 +165,7 @@ struct ParametersDmrgSolver {
 	SizeType precision;
 	SizeType numberOfExcited;
 	SizeType gemmRnb;
+	SizeType observeMemory;
 	bool autoRestart;
 	PairRealSizeType truncationControl;
 	PsimagLite::String filename;
@@ -229,6 +238,7 @@ struct ParametersDmrgSolver {
 	      precision(6),
 	      numberOfExcited(1),
 	      gemmRnb(0),
+	      observeMemory(0),
 	      autoRestart(false),
 	      options("SolverOptions=", io),
 	      recoverySave(""),
@@ -367,6 +377,14 @@ struct ParametersDmrgSolver {
 			io.readline(denseSparseThreshold, "DenseSparseThreshold=");
 		} catch (std::exception&) {}
 
+		try {
+			io.readline(observeMemory, "ObserveMemory=");
+		} catch (std::exception&) {}
+
+#ifdef USE_PTHREADS
+		if (isObserveCode && observeMemory > 0) checkHdf5ThreadSafe("ObserveMemory");
+#endif
+
 		if (isObserveCode) return;
 		bool hasRestart = false;
 		PsimagLite::String restartFrom;
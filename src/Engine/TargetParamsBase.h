@@ -249,6 +249,12 @@ public:
 		return unimplemented("timeDirection");
 	}
 
+	// zero means no error control for the Krylov time vectors
+	virtual RealType krylovTolerance() const
+	{
+		return 0;
+	}
+
 	virtual PsimagLite::String targeting() const { return targeting_; }
 
 private:
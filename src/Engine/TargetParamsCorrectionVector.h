@@ -94,6 +94,7 @@ public:
 
 	typedef TargetParamsCommon<ModelType> BaseType;
 	typedef typename ModelType::RealType RealType;
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
 	typedef typename BaseType::BaseType::PairFreqType PairFreqType;
 	typedef typename ModelType::OperatorType OperatorType;
 	typedef typename OperatorType::PairType PairType;
@@ -122,9 +123,31 @@ public:
 			throw PsimagLite::RuntimeError(msg += "must be either Real or Matsubara\n");
 		}
 
-		RealType omega;
-		io.readline(omega,"CorrectionVectorOmega=");
-		omega_=PairFreqType(freqEnum, omega);
+		// CorrectionVectorOmegas is a list of frequencies done in one run,
+		// sharing the Krylov tridiagonalization of each step, see
+		// CorrectionVectorSkeleton; CorrectionVectorOmega is the first one
+		try {
+			io.read(omegas_,"CorrectionVectorOmegas");
+		} catch (std::exception&) {}
+
+		if (omegas_.size() == 0) {
+			RealType omega = 0;
+			io.readline(omega,"CorrectionVectorOmega=");
+			omegas_.resize(1, omega);
+		}
+
+		omega_=PairFreqType(freqEnum, omegas_[0]);
+
+		// only the first CorrectionVectorOmegasTargeted frequencies are
+		// targeted, the others are computed with zero weight, default all
+		omegasTargeted_ = omegas_.size();
+		try {
+			io.readline(omegasTargeted_,"CorrectionVectorOmegasTargeted=");
+		} catch (std::exception&) {}
+
+		if (omegasTargeted_ > omegas_.size())
+			err("CorrectionVectorOmegasTargeted= cannot exceed the number of omegas\n");
+
 		io.readline(eta_,"CorrectionVectorEta=");
 
 		io.readline(tmp,"CorrectionVectorAlgorithm=");
@@ -142,6 +165,9 @@ public:
 			throw PsimagLite::RuntimeError(str);
 		}
 
+		if (omegas_.size() > 1 && algorithm_ != BaseType::AlgorithmEnum::KRYLOV)
+			err("CorrectionVectorOmegas with more than one omega needs Krylov\n");
+
 		try {
 			io.readline(cgSteps_,"ConjugateGradientSteps=");
 		} catch (std::exception& e) {}
@@ -187,6 +213,16 @@ public:
 		omega_ = PairFreqType(freqEnum,x);
 	}
 
+	virtual const VectorRealType& omegas() const
+	{
+		return omegas_;
+	}
+
+	virtual SizeType omegasTargeted() const
+	{
+		return omegasTargeted_;
+	}
+
 	virtual RealType eta() const
 	{
 		return eta_;
@@ -209,6 +245,8 @@ private:
 	SizeType cgSteps_;
 	RealType correctionA_;
 	PairFreqType omega_;
+	VectorRealType omegas_;
+	SizeType omegasTargeted_;
 	RealType eta_;
 	RealType cgEps_;
 }; // class TargetParamsCorrectionVector
@@ -222,6 +260,8 @@ inline std::ostream& operator<<(std::ostream& os,
 	os<<tp;
 	os<<"DynamicDmrgType="<<t.type()<<"\n";
 	os<<"CorrectionVectorOmega="<<t.omega()<<"\n";
+	os<<"CorrectionVectorOmegas="<<t.omegas()<<"\n";
+	os<<"CorrectionVectorOmegasTargeted="<<t.omegasTargeted()<<"\n";
 	os<<"CorrectionVectorEta="<<t.eta()<<"\n";
 	os<<"ConjugateGradientSteps"<<t.cgSteps()<<"\n";
 	os<<"ConjugateGradientEps"<<t.cgEps()<<"\n";
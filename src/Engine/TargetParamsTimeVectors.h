@@ -102,7 +102,8 @@ public:
 	      advanceEach_(0),
 	      algorithm_(BaseType::AlgorithmEnum::KRYLOV),
 	      tau_(0),
-	      timeDirection_(1.0)
+	      timeDirection_(1.0),
+	      krylovTolerance_(0)
 	{
 		/*PSIDOC TargetParamsTimeVectors
 		\item[TSPTau] [RealType], $\tau$ for the Krylov,
@@ -114,6 +115,10 @@ public:
 		\item[TSPAlgorithm] [String] Either
 		\verb!Krylov! or \verb!RungeKutta! or \verb!SuzukiTrotter!\\
 		Note that SuzukiTrotter is currently very experimental and unsupported.
+		\item[TSPKrylovTolerance] [RealType] Optional, zero by default.
+		If positive, and TSPAlgorithm is Krylov, the estimated relative error of
+		each time vector is kept below this value, by sub-steps of $\tau$ and
+		by adjusting the number of Lanczos steps, see TimeVectorsKrylovAdaptive.
 		*/
 
 		io.readline(tau_,"TSPTau=");
@@ -136,6 +141,13 @@ public:
 		try {
 			io.readline(timeDirection_,"TSPTimeFactor=");
 		} catch (std::exception&) {}
+
+		try {
+			io.readline(krylovTolerance_,"TSPKrylovTolerance=");
+		} catch (std::exception&) {}
+
+		if (krylovTolerance_ < 0)
+			err("TSPKrylovTolerance= cannot be negative\n");
 	}
 
 	virtual SizeType timeSteps() const
@@ -163,6 +175,11 @@ public:
 		return timeDirection_;
 	}
 
+	virtual RealType krylovTolerance() const
+	{
+		return krylovTolerance_;
+	}
+
 	virtual const VectorRealType& chebyTransform() const
 	{
 		return chebyTransform_;
@@ -175,6 +192,7 @@ private:
 	typename BaseType::AlgorithmEnum algorithm_;
 	RealType tau_;
 	RealType timeDirection_;
+	RealType krylovTolerance_;
 	VectorRealType chebyTransform_;
 }; // class TargetParamsTimeVectors
 
@@ -188,6 +206,7 @@ operator<<(std::ostream& os,const TargetParamsTimeVectors<ModelType>& t)
 	os<<"TargetParams.advanceEach="<<t.advanceEach()<<"\n";
 	os<<"TargetParams.algorithm="<<t.algorithm()<<"\n";
 	os<<"TargetParams.timeDirection="<<t.timeDirection()<<"\n";
+	os<<"TargetParams.krylovTolerance="<<t.krylovTolerance()<<"\n";
 	return os;
 }
 } // namespace Dmrg
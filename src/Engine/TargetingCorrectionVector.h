@@ -142,6 +142,8 @@ public:
 	BaseType,
 	TargetParamsType> CorrectionVectorSkeletonType;
 	typedef typename BasisType::QnType QnType;
+	typedef typename CorrectionVectorSkeletonType::VectorVectorWithOffsetPointerType
+	VectorVectorWithOffsetPointerType;
 
 	TargetingCorrectionVector(const LeftRightSuperType& lrs,
 	                          const ModelType& model,
@@ -162,7 +164,8 @@ public:
 
 	SizeType sites() const { return tstStruct_.sites(); }
 
-	SizeType targets() const { return 4; }
+	// phi, and then xi and xr for each omega, see setWeights
+	SizeType targets() const { return 2 + 2*tstStruct_.omegas().size(); }
 
 	RealType weight(SizeType i) const
 	{
@@ -253,9 +256,19 @@ private:
 		if (count==0) return;
 
 		this->common().aoe().targetVectors(1) = phiNew;
+
+		const SizeType nomegas = tstStruct_.omegas().size();
+		VectorVectorWithOffsetPointerType xis(nomegas);
+		VectorVectorWithOffsetPointerType xrs(nomegas);
+		for (SizeType w = 0; w < nomegas; ++w) {
+			xis[w] = &(this->common().aoe().targetVectors(2 + 2*w));
+			xrs[w] = &(this->common().aoe().targetVectors(3 + 2*w));
+		}
+
 		skeleton_.calcDynVectors(this->common().aoe().targetVectors(1),
-		                         this->common().aoe().targetVectors(2),
-		                         this->common().aoe().targetVectors(3));
+		                         tstStruct_.omegas(),
+		                         xis,
+		                         xrs);
 
 		setWeights();
 
@@ -268,10 +281,12 @@ private:
 	{
 		gsWeight_ = tstStruct_.gsWeight();
 
+		// omegas past omegasTargeted() are computed but not targeted
+		const SizeType targeted = 2 + 2*tstStruct_.omegasTargeted();
 		RealType sum  = 0;
 		weight_.resize(this->common().aoe().targetVectors().size());
 		for (SizeType r=1;r<weight_.size();r++) {
-			weight_[r] = 1;
+			weight_[r] = (r < targeted) ? 1 : 0;
 			sum += weight_[r];
 		}
 
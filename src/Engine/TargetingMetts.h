@@ -275,7 +275,7 @@ public:
 		for (SizeType i=0;i<this->common().aoe().targetVectors().size();i++)
 			assert(this->common().aoe().targetVectors()[i].size()==0 ||
 			       this->common().aoe().targetVectors()[i].size()==
-			       lrs_.super().permutationVector().size());
+			       lrs_.super().permutationSize());
 
 		bool doBorderIfBorder = true;
 		this->common().cocoon(block1, direction, doBorderIfBorder);
@@ -83,7 +83,6 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include <vector>
 #include "TimeVectorsBase.h"
 #include "ParallelTriDiag.h"
-#include "NoPthreadsNg.h"
 #include "Parallelizer.h"
 #include "ScaledHamiltonian.h"
 #include "Sort.h"
@@ -392,9 +391,6 @@ private:
 		ScaledMatrixType lanczosHelper2(lanczosHelper, tstStruct_, Eg, verbose);
 
 		const RealType fakeTime = 0;
-		typedef PsimagLite::NoPthreadsNg<ParallelTriDiagType> ParallelizerType;
-		ParallelizerType threadedTriDiag(PsimagLite::CodeSectionParams(1));
-
 
 		VectorMatrixFieldType T(phi.sectors());
 		VectorSizeType steps(phi.sectors());
@@ -408,7 +404,7 @@ private:
 		                                  model_,
 		                                  ioIn_);
 
-		threadedTriDiag.loopCreate(helperTriDiag);
+		helperTriDiag.run();
 
 		VectorVectorRealType eigs(phi.sectors());
 
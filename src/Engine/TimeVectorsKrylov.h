@@ -83,9 +83,9 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include <vector>
 #include "TimeVectorsBase.h"
 #include "ParallelTriDiag.h"
-#include "NoPthreadsNg.h"
 #include "Parallelizer.h"
 #include "KrylovHelper.h"
+#include "ProgressIndicator.h"
 
 namespace Dmrg {
 
@@ -130,6 +130,7 @@ public:
 	typedef typename ModelType::InputValidatorType InputValidatorType;
 	typedef typename PsimagLite::Vector<VectorWithOffsetType>::Type VectorVectorWithOffsetType;
 	typedef typename PsimagLite::Vector<VectorRealType>::Type VectorVectorRealType;
+	typedef typename PsimagLite::Vector<SizeType>::Type VectorSizeType;
 
 	struct Action {
 
@@ -163,7 +164,10 @@ public:
 	      lrs_(lrs),
 	      ioIn_(ioIn),
 	      timeHasAdvanced_(false),
-	      krylovHelper_(model.params())
+	      krylovHelper_(model.params()),
+	      krylovSteps_(0),
+	      maxKrylovSteps_(0),
+	      progress_("TimeVectorsKrylov")
 	{}
 
 	virtual void calcTimeVectors(const PsimagLite::Vector<SizeType>::Type& indices,
@@ -202,19 +206,34 @@ public:
 
 		if (times_.size() == 1 && fabs(times_[0])<1e-10) return;
 
-		VectorMatrixFieldType V(phi.sectors());
-		VectorMatrixFieldType T(phi.sectors());
+		const PsimagLite::MemoryUsage::TimeHandle time1 = PsimagLite::ProgressIndicator::time();
 
-		typename PsimagLite::Vector<SizeType>::Type steps(phi.sectors());
+		Cost cost;
+		if (tstStruct_.krylovTolerance() > 0) {
+			calcTargetVectorsAdaptive(cost, indices, phi, Eg, extra.time);
+		} else {
+			VectorMatrixFieldType V(phi.sectors());
+			VectorMatrixFieldType T(phi.sectors());
 
-		triDiag(phi, T, V, steps, extra.time);
+			typename PsimagLite::Vector<SizeType>::Type steps(phi.sectors());
+			VectorRealType residuals(phi.sectors());
 
-		VectorVectorRealType eigs(phi.sectors());
+			triDiag(phi, T, V, steps, residuals, extra.time);
 
-		for (SizeType ii=0;ii<phi.sectors();ii++)
-			PsimagLite::diag(T[ii],eigs[ii],'V');
+			VectorVectorRealType eigs(phi.sectors());
 
-		calcTargetVectors(indices, phi, T, V, Eg, eigs, steps);
+			for (SizeType ii=0;ii<phi.sectors();ii++)
+				PsimagLite::diag(T[ii],eigs[ii],'V');
+
+			calcTargetVectors(indices, phi, T, V, Eg, eigs, steps);
+
+			cost.substeps = 1;
+			for (SizeType ii = 0; ii < steps.size(); ++ii)
+				cost.krylovVectors += steps[ii];
+		}
+
+		const PsimagLite::MemoryUsage::TimeHandle time2 = PsimagLite::ProgressIndicator::time();
+		printCost(cost, (time2 - time1).millis(), times_[indices.size() - 1]);
 
 		//checkNorms();
 		if (extra.isLastCall) timeHasAdvanced_ = false;
@@ -228,6 +247,263 @@ public:
 
 private:
 
+	static const SizeType MAX_HALVINGS = 10;
+
+	struct Cost {
+
+		Cost() : substeps(0), krylovVectors(0), error(0) {}
+
+		SizeType substeps;
+		SizeType krylovVectors;
+		RealType error;
+	};
+
+	/* PSIDOC TimeVectorsKrylovAdaptive
+	 If TSPKrylovTolerance is positive, the time vectors are computed with
+	 error control. The error of $\exp(-iHt)\phi$ in a Krylov space of dimension m is
+	 estimated, for each sector, from the tridiagonal matrix $T_m$ as
+	 $\beta_m |[\exp(-iT_mt)e_1]_{m-1}|$, relative to the norm of $\phi$ in that sector,
+	 where $\beta_m$ is the coefficient of $T$ past $T_m$, or, if m is the full Krylov
+	 dimension, the norm of the residual of the last Lanczos step, which is zero
+	 if the Lanczos process stopped early in an invariant subspace. The time vectors
+	 are then computed in sub-steps: each one goes as far as the time vectors whose
+	 estimated error is below the tolerance, and the last of them starts the Krylov
+	 space of the next sub-step. If not even the next time vector is within the
+	 tolerance, the interval up to it is halved, up to MAX\_HALVINGS times, until it is,
+	 and the vector at the end of that part starts the next sub-step; if it is
+	 still not within the tolerance, a warning is printed and the sub-step goes to
+	 the next time vector anyway.
+	 The number of Lanczos steps is then adjusted for the next time step, to the
+	 smallest one that would have done the whole time step within the tolerance, or
+	 doubled, up to the one of the input file, if sub-steps were needed.
+	 The cost of each time step, in sub-steps, Krylov vectors, and milliseconds, and
+	 that cost per unit of simulated time, are printed in both cases.
+	 */
+	void calcTargetVectorsAdaptive(Cost& cost,
+	                               const VectorSizeType& indices,
+	                               const VectorWithOffsetType& phi,
+	                               RealType Eg,
+	                               RealType currentTime)
+	{
+		const RealType tolerance = tstStruct_.krylovTolerance();
+		const SizeType n = indices.size();
+		VectorWithOffsetType psi = phi;
+		// psi is at time timeOfPsi, between times_[start] and times_[start + 1]
+		SizeType start = 0;
+		RealType timeOfPsi = times_[0];
+		SizeType neededSteps = 0;
+		SizeType usedSteps = 0;
+
+		while (start + 1 < n) {
+			const SizeType sectors = psi.sectors();
+			VectorMatrixFieldType V(sectors);
+			VectorMatrixFieldType T(sectors);
+			VectorSizeType steps(sectors);
+			VectorRealType residuals(sectors);
+
+			triDiag(psi, T, V, steps, residuals, currentTime + timeOfPsi);
+
+			const VectorMatrixFieldType tridiagonal = T;
+			VectorVectorRealType eigs(sectors);
+			for (SizeType ii = 0; ii < sectors; ++ii)
+				PsimagLite::diag(T[ii], eigs[ii], 'V');
+
+			for (SizeType ii = 0; ii < sectors; ++ii) {
+				cost.krylovVectors += steps[ii];
+				usedSteps = std::max(usedSteps, steps[ii]);
+			}
+
+			// the Krylov dimension needed for the whole time step
+			if (cost.substeps == 0) {
+				const RealType time = times_[n - 1] - times_[0];
+				for (SizeType ii = 0; ii < sectors; ++ii) {
+					const SizeType m = stepsNeeded(tridiagonal[ii],
+					                               steps[ii],
+					                               residuals[ii],
+					                               Eg,
+					                               time,
+					                               tolerance);
+					neededSteps = std::max(neededSteps, m);
+				}
+			}
+
+			++cost.substeps;
+
+			// the last time vector within the tolerance
+			SizeType end = start;
+			while (end + 1 < n) {
+				const RealType time = times_[end + 1] - timeOfPsi;
+				if (errorEstimate(tridiagonal, T, eigs, steps, residuals, Eg, time) > tolerance)
+					break;
+				++end;
+			}
+
+			if (end == start) {
+				// not even the next one; go part of the way to it
+				RealType dt = times_[start + 1] - timeOfPsi;
+				RealType error = 0;
+				for (SizeType h = 0; h < MAX_HALVINGS; ++h) {
+					dt *= 0.5;
+					error = errorEstimate(tridiagonal, T, eigs, steps, residuals, Eg, dt);
+					if (error <= tolerance) break;
+				}
+
+				if (error <= tolerance) {
+					cost.error = std::max(cost.error, error);
+					VectorWithOffsetType tmp;
+					calcTargetVector(tmp, psi, T, V, Eg, eigs, steps, dt);
+					psi = tmp;
+					timeOfPsi += dt;
+					continue;
+				}
+
+				// halving does not help; go all the way
+				printToleranceWarning(times_[start + 1] - timeOfPsi);
+				end = start + 1;
+			}
+
+			const RealType timeOfSubstep = times_[end] - timeOfPsi;
+			cost.error = std::max(cost.error,
+			                      errorEstimate(tridiagonal,
+			                                    T,
+			                                    eigs,
+			                                    steps,
+			                                    residuals,
+			                                    Eg,
+			                                    timeOfSubstep));
+
+			for (SizeType i = start + 1; i <= end; ++i) {
+				const SizeType ii = indices[i];
+				assert(ii < targetVectors_.size());
+				const RealType time = times_[i] - timeOfPsi;
+				calcTargetVector(targetVectors_[ii], psi, T, V, Eg, eigs, steps, time);
+			}
+
+			start = end;
+			timeOfPsi = times_[start];
+			if (start + 1 < n) psi = targetVectors_[indices[start]];
+		}
+
+		// the Lanczos steps for the next time step, see PSIDOC above
+		krylovSteps_ = (cost.substeps > 1) ? 2*usedSteps : neededSteps + 2;
+		krylovSteps_ = std::min(krylovSteps_, maxKrylovSteps_);
+	}
+
+	void printToleranceWarning(RealType time)
+	{
+		PsimagLite::OstringStream msgg(std::cout.precision());
+		PsimagLite::OstringStream::OstringStreamType& msg = msgg();
+		msg<<"WARNING: the error estimate of a sub-step of time "<<time;
+		msg<<" is above TSPKrylovTolerance "<<tstStruct_.krylovTolerance();
+		msg<<" even if halved "<<MAX_HALVINGS<<" times; increase the Lanczos steps";
+		progress_.printline(msgg, std::cout);
+	}
+
+	// the largest over sectors of the relative error estimate of exp(-iHt)
+	// in the Krylov spaces of tridiagonal, whose eigenvectors are in T,
+	// see PSIDOC TimeVectorsKrylovAdaptive
+	RealType errorEstimate(const VectorMatrixFieldType& tridiagonal,
+	                       const VectorMatrixFieldType& T,
+	                       const VectorVectorRealType& eigs,
+	                       const VectorSizeType& steps,
+	                       const VectorRealType& residuals,
+	                       RealType Eg,
+	                       RealType time) const
+	{
+		RealType maxError = 0;
+		for (SizeType ii = 0; ii < T.size(); ++ii) {
+			const SizeType m = steps[ii];
+			if (m == 0) continue;
+			const RealType beta = betaPast(tridiagonal[ii], m, steps[ii], residuals[ii]);
+			const RealType error = beta*std::abs(lastCoefficient(T[ii], eigs[ii], m, Eg, time));
+			maxError = std::max(maxError, error);
+		}
+
+		return maxError;
+	}
+
+	// the smallest Krylov dimension, up to steps, of the sector with this
+	// tridiagonal matrix whose estimated error is below tolerance
+	SizeType stepsNeeded(const MatrixComplexOrRealType& tridiagonal,
+	                     SizeType steps,
+	                     RealType residual,
+	                     RealType Eg,
+	                     RealType time,
+	                     RealType tolerance) const
+	{
+		if (steps < 3) return steps;
+
+		SizeType low = 2;
+		SizeType high = steps;
+		while (low < high) {
+			const SizeType m = (low + high)/2;
+			MatrixComplexOrRealType Tm(m, m);
+			for (SizeType i = 0; i < m; ++i)
+				for (SizeType j = 0; j < m; ++j)
+					Tm(i, j) = tridiagonal(i, j);
+
+			VectorRealType eigsm;
+			PsimagLite::diag(Tm, eigsm, 'V');
+			const RealType beta = betaPast(tridiagonal, m, steps, residual);
+			const RealType error = beta*std::abs(lastCoefficient(Tm, eigsm, m, Eg, time));
+			if (error > tolerance)
+				low = m + 1;
+			else
+				high = m;
+		}
+
+		return low;
+	}
+
+	// beta_m, the coefficient past the leading m x m block of tridiagonal, which has
+	// steps rows, or the residual of the last Lanczos step if m == steps
+	static RealType betaPast(const MatrixComplexOrRealType& tridiagonal,
+	                         SizeType m,
+	                         SizeType steps,
+	                         RealType residual)
+	{
+		assert(m > 0 && m <= steps);
+		return (m == steps) ? residual : std::abs(tridiagonal(m, m - 1));
+	}
+
+	// the last entry of exp(-iTt)e_1, with T = U eigs U^\dagger, U in T
+	ComplexOrRealType lastCoefficient(const MatrixComplexOrRealType& T,
+	                                  const VectorRealType& eigs,
+	                                  SizeType m,
+	                                  RealType Eg,
+	                                  RealType time) const
+	{
+		const RealType timeDirection = tstStruct_.timeDirection();
+		ComplexOrRealType sum = 0.0;
+		for (SizeType k = 0; k < m; ++k) {
+			RealType tmp = (eigs[k]-Eg)*time*timeDirection;
+			ComplexOrRealType c = 0.0;
+			PsimagLite::expComplexOrReal(c, -tmp);
+			sum += T(m - 1, k)*c*PsimagLite::conj(T(0, k));
+		}
+
+		return sum;
+	}
+
+	void printCost(const Cost& cost, double millis, RealType simulatedTime)
+	{
+		PsimagLite::OstringStream msgg(std::cout.precision());
+		PsimagLite::OstringStream::OstringStreamType& msg = msgg();
+		msg<<"Time step with "<<cost.substeps<<" sub-steps, ";
+		msg<<cost.krylovVectors<<" Krylov vectors, "<<millis<<" ms";
+		if (simulatedTime > 0) {
+			msg<<"; per unit time "<<(cost.krylovVectors/simulatedTime)<<" Krylov vectors, ";
+			msg<<(millis/simulatedTime)<<" ms";
+		}
+
+		if (tstStruct_.krylovTolerance() > 0) {
+			msg<<"; error estimate "<<cost.error;
+			msg<<", next Lanczos steps "<<krylovSteps_;
+		}
+
+		progress_.printline(msgg, std::cout);
+	}
+
 	//! Do not normalize states here, it leads to wrong results (!)
 	void calcTargetVectors(typename PsimagLite::Vector<SizeType>::Type indices,
 	                       const VectorWithOffsetType& phi,
@@ -242,7 +518,7 @@ private:
 			assert(ii < targetVectors_.size());
 			targetVectors_[ii] = phi;
 			// Only time differences here (i.e. times_[i] not times_[i]+currentTime_)
-			calcTargetVector(targetVectors_[ii], phi, T, V, Eg, eigs, steps, i);
+			calcTargetVector(targetVectors_[ii], phi, T, V, Eg, eigs, steps, times_[i]);
 		}
 	}
 
@@ -253,11 +529,10 @@ private:
 	                      RealType Eg,
 	                      const VectorVectorRealType& eigs,
 	                      typename PsimagLite::Vector<SizeType>::Type steps,
-	                      SizeType timeIndex)
+	                      RealType time)
 	{
 		v = phi;
 		for (SizeType ii = 0;ii < phi.sectors(); ++ii) {
-			const RealType time = times_[timeIndex];
 			const RealType timeDirection = tstStruct_.timeDirection();
 			const VectorRealType& eigsii = eigs[ii];
 			auto action = [eigsii, Eg, time, timeDirection](SizeType k)
@@ -306,14 +581,22 @@ private:
 	             VectorMatrixFieldType& T,
 	             VectorMatrixFieldType& V,
 	             typename PsimagLite::Vector<SizeType>::Type& steps,
+	             VectorRealType& residuals,
 	             RealType currentTime)
 	{
-		typedef PsimagLite::NoPthreadsNg<ParallelTriDiagType> ParallelizerType;
-		ParallelizerType threadedTriDiag(PsimagLite::CodeSectionParams(1));
-
 		ParallelTriDiagType helperTriDiag(phi,T,V,steps,lrs_,currentTime,model_,ioIn_);
 
-		threadedTriDiag.loopCreate(helperTriDiag);
+		// krylovSteps_ is set only with TSPKrylovTolerance
+		maxKrylovSteps_ = helperTriDiag.maxSteps();
+		if (krylovSteps_ > 0 && krylovSteps_ < maxKrylovSteps_)
+			helperTriDiag.maxSteps(krylovSteps_);
+
+		helperTriDiag.run();
+
+		// one task per sector of phi, in order
+		assert(helperTriDiag.tasks() == residuals.size());
+		for (SizeType ii = 0; ii < residuals.size(); ++ii)
+			residuals[ii] = helperTriDiag.residual(ii);
 	}
 
 	const SizeType& currentTimeStep_;
@@ -326,6 +609,9 @@ private:
 	InputValidatorType& ioIn_;
 	bool timeHasAdvanced_;
 	KrylovHelperType krylovHelper_;
+	SizeType krylovSteps_;
+	SizeType maxKrylovSteps_;
+	PsimagLite::ProgressIndicator progress_;
 }; //class TimeVectorsKrylov
 } // namespace Dmrg
 /*@}*/
@@ -366,7 +366,6 @@ private:
 				                 phi0,
 				                 xp,
 				                 yp,
-				                 packSuper,
 				                 block,
 				                 m,
 				                 i,
@@ -379,7 +378,6 @@ private:
 				                  phi0,
 				                  xp,
 				                  yp,
-				                  packSuper,
 				                  block,
 				                  m,
 				                  i,
@@ -395,7 +393,6 @@ private:
 	                      const TargetVectorType& phi0,
 	                      SizeType xp,
 	                      SizeType yp,
-	                      const PackIndicesType& packSuper,
 	                      const BlockType& block,
 	                      const MatrixComplexOrRealType& m,
 	                      SizeType i,
@@ -438,9 +435,7 @@ private:
 						SizeType x = packLeft.pack(x1,
 						                           x2,
 						                           lrs_.left().permutationInverse());
-						SizeType j = packSuper.pack(x,
-						                            y,
-						                            lrs_.super().permutationInverse());
+						SizeType j = lrs_.super().permutationInverse(x + y*ns);
 						ComplexOrRealType tmp = m(iperm[x2+y1*hilbertSize],
 						        iperm[x2p+y1p*hilbertSize]);
 						if (PsimagLite::norm(tmp)<1e-12) continue;
@@ -458,7 +453,6 @@ private:
 	                       const TargetVectorType& phi0,
 	                       SizeType xp,
 	                       SizeType yp,
-	                       const PackIndicesType& packSuper,
 	                       const BlockType& block,
 	                       const MatrixComplexOrRealType& m,
 	                       SizeType i,
@@ -503,9 +497,7 @@ private:
 						SizeType y = packRight.pack(y1,
 						                            y2,
 						                            lrs_.right().permutationInverse());
-						SizeType j = packSuper.pack(x,
-						                            y,
-						                            lrs_.super().permutationInverse());
+						SizeType j = lrs_.super().permutationInverse(x + y*ns);
 
 						ComplexOrRealType tmp = m(iperm[x2+y1*hilbertSize],
 						        iperm[x2p+y1p*hilbertSize]);
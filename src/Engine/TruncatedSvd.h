@@ -0,0 +1,290 @@
+/*
+Copyright (c) 2009-2020, UT-Battelle, LLC
+All rights reserved
+
+[DMRG++, Version 5.]
+[by G.A., Oak Ridge National Laboratory]
+
+UT Battelle Open Source Software License 11242008
+
+OPEN SOURCE LICENSE
+
+Subject to the conditions of this License, each
+contributor to this software hereby grants, free of
+charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), a
+perpetual, worldwide, non-exclusive, no-charge,
+royalty-free, irrevocable copyright license to use, copy,
+modify, merge, publish, distribute, and/or sublicense
+copies of the Software.
+
+1. Redistributions of Software must retain the above
+copyright and license notices, this list of conditions,
+and the following disclaimer.  Changes or modifications
+to, or derivative works of, the Software should be noted
+with comments and the contributor and organization's
+name.
+
+2. Neither the names of UT-Battelle, LLC or the
+Department of Energy nor the names of the Software
+contributors may be used to endorse or promote products
+derived from this software without specific prior written
+permission of UT-Battelle.
+
+3. The software and the end-user documentation included
+with the redistribution, with or without modification,
+must include the following acknowledgment:
+
+"This product includes software produced by UT-Battelle,
+LLC under Contract No. DE-AC05-00OR22725  with the
+Department of Energy."
+
+*********************************************************
+DISCLAIMER
+
+THE SOFTWARE IS SUPPLIED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER, CONTRIBUTORS, UNITED STATES GOVERNMENT,
+OR THE UNITED STATES DEPARTMENT OF ENERGY BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+NEITHER THE UNITED STATES GOVERNMENT, NOR THE UNITED
+STATES DEPARTMENT OF ENERGY, NOR THE COPYRIGHT OWNER, NOR
+ANY OF THEIR EMPLOYEES, REPRESENTS THAT THE USE OF ANY
+INFORMATION, DATA, APPARATUS, PRODUCT, OR PROCESS
+DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
+
+*********************************************************
+
+
+*/
+/** \ingroup DMRG */
+/*@{*/
+/** \file TruncatedSvd.h
+*/
+
+#ifndef TRUNCATEDSVD_H
+#define TRUNCATEDSVD_H
+#include "Vector.h"
+#include "Matrix.h"
+#include "BLAS.h"
+#include "Svd.h"
+#include "Random48.h"
+
+namespace Dmrg {
+
+/* PSIDOC TruncatedSvd
+ Leading singular values and left singular vectors of a dense matrix m, by
+ randomized range finding. With l = k + OVERSAMPLING, the range of m is
+ sampled with m times a random cols x l matrix, refined with POWER\_ITERATIONS
+ products with m and its adjoint, and orthonormalized into Q. The SVD of the
+ small l x cols matrix Q$^\dagger$ m gives the singular values and, times Q, the left
+ singular vectors. These are then completed, with Householder reflections,
+ to a unitary rows x rows matrix, so that the result has the shape of svd('A'),
+ with singular values zero for the completion. The cost is of order rows*cols*l
+ instead of rows*cols*min(rows, cols).
+ */
+template<typename ComplexOrRealType>
+class TruncatedSvd {
+
+	typedef typename PsimagLite::Real<ComplexOrRealType>::Type RealType;
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
+	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixType;
+
+	static const SizeType OVERSAMPLING = 10;
+	static const SizeType POWER_ITERATIONS = 2;
+
+public:
+
+	TruncatedSvd(long int seed) : rng_(seed) {}
+
+	// Returns false, and does nothing, if the full SVD would be as cheap
+	bool operator()(MatrixType& m, VectorRealType& s, MatrixType& vt, SizeType k)
+	{
+		const SizeType rows = m.rows();
+		const SizeType cols = m.cols();
+		const SizeType l = k + OVERSAMPLING;
+		if (k == 0 || 2*l >= std::min(rows, cols)) return false;
+
+		MatrixType omega(cols, l);
+		for (SizeType j = 0; j < l; ++j)
+			for (SizeType i = 0; i < cols; ++i)
+				omega(i, j) = rng_() - 0.5;
+
+		MatrixType q(rows, l);
+		multiply(q, 'N', m, omega);
+		orthonormalize(q);
+
+		for (SizeType it = 0; it < POWER_ITERATIONS; ++it) {
+			multiply(omega, 'C', m, q);
+			orthonormalize(omega);
+			multiply(q, 'N', m, omega);
+			orthonormalize(q);
+		}
+
+		// b = q^dagger m
+		MatrixType b(l, cols);
+		multiply(b, 'C', q, m);
+
+		PsimagLite::Svd<ComplexOrRealType> svd;
+		svd('A', b, s, vt);
+
+		// leading left singular vectors of m are q times those of b
+		MatrixType u(rows, l);
+		multiply(u, 'N', q, b);
+
+		complete(m, u);
+		return true;
+	}
+
+private:
+
+	// c = op(a) * b, with op 'N' or 'C'
+	static void multiply(MatrixType& c, char op, const MatrixType& a, const MatrixType& b)
+	{
+		const SizeType rows = (op == 'N') ? a.rows() : a.cols();
+		const SizeType inner = (op == 'N') ? a.cols() : a.rows();
+		assert(inner == b.rows());
+		c.resize(rows, b.cols());
+		psimag::BLAS::GEMM(op,
+		                   'N',
+		                   rows,
+		                   b.cols(),
+		                   inner,
+		                   1.0,
+		                   &(a(0, 0)),
+		                   a.rows(),
+		                   &(b(0, 0)),
+		                   b.rows(),
+		                   0.0,
+		                   &(c(0, 0)),
+		                   c.rows());
+	}
+
+	// Gram-Schmidt twice on the columns of a; a column that becomes
+	// dependent on the previous ones is replaced by a random one
+	void orthonormalize(MatrixType& a)
+	{
+		const SizeType n = a.rows();
+		for (SizeType j = 0; j < a.cols(); ++j) {
+			RealType norm0 = columnNorm(a, j);
+			for (SizeType pass = 0; pass < 2; ++pass)
+				removeProjections(a, j);
+
+			RealType norm1 = columnNorm(a, j);
+			if (norm1 < 1e-10*norm0 || norm1 == 0) {
+				for (SizeType i = 0; i < n; ++i)
+					a(i, j) = rng_() - 0.5;
+				for (SizeType pass = 0; pass < 2; ++pass)
+					removeProjections(a, j);
+				norm1 = columnNorm(a, j);
+			}
+
+			assert(norm1 > 0);
+			for (SizeType i = 0; i < n; ++i)
+				a(i, j) /= norm1;
+		}
+	}
+
+	static void removeProjections(MatrixType& a, SizeType j)
+	{
+		const SizeType n = a.rows();
+		for (SizeType jj = 0; jj < j; ++jj) {
+			ComplexOrRealType c = 0.0;
+			for (SizeType i = 0; i < n; ++i)
+				c += PsimagLite::conj(a(i, jj))*a(i, j);
+			for (SizeType i = 0; i < n; ++i)
+				a(i, j) -= c*a(i, jj);
+		}
+	}
+
+	static RealType columnNorm(const MatrixType& a, SizeType j)
+	{
+		RealType sum = 0;
+		for (SizeType i = 0; i < a.rows(); ++i)
+			sum += PsimagLite::real(PsimagLite::conj(a(i, j))*a(i, j));
+		return sqrt(sum);
+	}
+
+	// m = [u, complement of u], a unitary rows x rows matrix
+	static void complete(MatrixType& m, const MatrixType& u)
+	{
+		const SizeType rows = u.rows();
+		const SizeType l = u.cols();
+
+		// Householder QR of u: reflector j maps column j of r to a multiple of e_j
+		MatrixType r = u;
+		MatrixType v(rows, l);
+		v.setTo(0.0);
+		for (SizeType j = 0; j < l; ++j) {
+			RealType norm = 0;
+			for (SizeType i = j; i < rows; ++i)
+				norm += PsimagLite::real(PsimagLite::conj(r(i, j))*r(i, j));
+			norm = sqrt(norm);
+
+			const RealType absX0 = std::abs(r(j, j));
+			const ComplexOrRealType phase = (absX0 > 0) ? r(j, j)/absX0 : 1.0;
+			for (SizeType i = j; i < rows; ++i)
+				v(i, j) = r(i, j);
+			v(j, j) += phase*norm;
+
+			RealType vnorm = 0;
+			for (SizeType i = j; i < rows; ++i)
+				vnorm += PsimagLite::real(PsimagLite::conj(v(i, j))*v(i, j));
+			vnorm = sqrt(vnorm);
+			if (vnorm == 0) {
+				v(j, j) = 1.0;
+				vnorm = 1.0;
+			}
+
+			for (SizeType i = j; i < rows; ++i)
+				v(i, j) /= vnorm;
+
+			for (SizeType jj = j; jj < l; ++jj)
+				reflect(r, jj, v, j);
+		}
+
+		// the columns l, ..., rows - 1 of H_0 H_1 ... H_{l-1}
+		// are orthogonal to the columns of u
+		m.resize(rows, rows);
+		m.setTo(0.0);
+		for (SizeType j = 0; j < l; ++j)
+			for (SizeType i = 0; i < rows; ++i)
+				m(i, j) = u(i, j);
+
+		for (SizeType c = l; c < rows; ++c) {
+			m(c, c) = 1.0;
+			for (SizeType j = l; j > 0; --j)
+				reflect(m, c, v, j - 1);
+		}
+	}
+
+	// column c of a = (1 - 2 v_j v_j^dagger) column c of a
+	static void reflect(MatrixType& a, SizeType c, const MatrixType& v, SizeType j)
+	{
+		const SizeType rows = a.rows();
+		ComplexOrRealType sum = 0.0;
+		for (SizeType i = j; i < rows; ++i)
+			sum += PsimagLite::conj(v(i, j))*a(i, c);
+		sum *= 2.0;
+		for (SizeType i = j; i < rows; ++i)
+			a(i, c) -= v(i, j)*sum;
+	}
+
+	PsimagLite::Random48<RealType> rng_;
+}; // class TruncatedSvd
+} // namespace Dmrg
+
+/*@}*/
+#endif // TRUNCATEDSVD_H
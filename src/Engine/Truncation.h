@@ -245,7 +245,16 @@ private:
 		bool useSvd = !parameters_.options.isSet("truncationNoSvd");
 		bool enablePersistentSvd = parameters_.options.isSet("EnablePersistentSvd");
 		bool serialSvd = parameters_.options.isSet("SerialSvd");
-		ParamsDensityMatrixType p(useSvd, direction, debug, enablePersistentSvd, serialSvd);
+		bool truncatedSvd = parameters_.options.isSet("TruncatedSvd");
+		bool twoLevelSvd = parameters_.options.isSet("TwoLevelSvd");
+		ParamsDensityMatrixType p(useSvd,
+		                          direction,
+		                          debug,
+		                          enablePersistentSvd,
+		                          serialSvd,
+		                          truncatedSvd,
+		                          keptStates,
+		                          twoLevelSvd);
 		TruncationCache& cache = (direction == expandSys) ? leftCache_ :
 		                                                    rightCache_;
 
@@ -86,6 +86,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Parallel2PointCorrelations.h"
 #include "Concurrency.h"
 #include "Parallelizer.h"
+#include "LoadBalancerWeights.h"
 #include "ProgramGlobals.h"
 #include "GetBraOrKet.h"
 
@@ -108,7 +109,7 @@ public:
 	typedef typename CorrelationsSkeletonType::SparseMatrixType SparseMatrixType;
 	typedef typename ObserverHelperType::MatrixType MatrixType;
 	typedef Parallel2PointCorrelations<ThisType> Parallel2PointCorrelationsType;
-	typedef typename Parallel2PointCorrelationsType::PairType PairType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
 
 	TwoPointCorrelations(const CorrelationsSkeletonType& skeleton) : skeleton_(skeleton)
 	{}
@@ -123,27 +124,68 @@ public:
 		SizeType rows = w.n_row();
 		SizeType cols = w.n_col();
 
-		typename PsimagLite::Vector<PairType>::Type pairs;
-		for (SizeType i=0;i<rows;i++) {
-			for (SizeType j=i;j<cols;j++) {
-				if (i>j) continue;
-				pairs.push_back(PairType(i,j));
-			}
-		}
+		// the cost of row i goes as the number of its j >= i
+		VectorSizeType weights(rows, 0);
+		for (SizeType i = 0; i < rows; ++i)
+			weights[i] = (i < cols) ? cols - i : 0;
 
-		typedef PsimagLite::Parallelizer<Parallel2PointCorrelationsType> ParallelizerType;
+		typedef PsimagLite::Parallelizer<Parallel2PointCorrelationsType,
+		        PsimagLite::LoadBalancerWeights> ParallelizerType;
 		ParallelizerType threaded2Points(PsimagLite::Concurrency::codeSectionParams);
 
 		Parallel2PointCorrelationsType helper2Points(w,
 		                                             *this,
-		                                             pairs,
+		                                             rows,
 		                                             O1,
 		                                             O2,
 		                                             fermionicSign,
 		                                             bra,
 		                                             ket);
 
-		threaded2Points.loopCreate(helper2Points);
+		threaded2Points.loopCreate(helper2Points, weights);
+	}
+
+	// w(i, j) for all j >= i; O1 is grown once for the row and carried from
+	// each j to the next, instead of being grown from site i for each j
+	void calcRow(PsimagLite::Matrix<FieldType>& w,
+	             SizeType i,
+	             const SparseMatrixType& O1,
+	             const SparseMatrixType& O2,
+	             ProgramGlobals::FermionOrBosonEnum fermionicSign,
+	             const PsimagLite::GetBraOrKet& bra,
+	             const PsimagLite::GetBraOrKet& ket) const
+	{
+		const SizeType cols = w.n_col();
+		if (i >= cols) return;
+
+		w(i, i) = calcDiagonalCorrelation(i, O1, O2, fermionicSign, bra, ket);
+
+		SparseMatrixType O1g, O2m;
+		skeleton_.createWithModification(O1g,O1,'n');
+		skeleton_.createWithModification(O2m,O2,'n');
+
+		const SizeType last = skeleton_.numberOfSites() - 1;
+		SizeType s = CorrelationsSkeletonType::growStart(i);
+		for (SizeType j = i + 1; j < cols; ++j) {
+			const SizeType ns = j - 1;
+			if (j == last) {
+				w(i, j) = (i == j - 1) ? calcCorrelation_(i, j, O1, O2, fermionicSign, bra, ket)
+				                       : calcRightCorner(O1g, s, i, O2m, fermionicSign, bra, ket);
+				continue;
+			}
+
+			for (; s < ns; ++s)
+				skeleton_.growByOneSite(O1g, i, fermionicSign, s, true);
+
+			SparseMatrixType O2g;
+			const SizeType ptr = skeleton_.dmrgMultiply(O2g, O1g, O2m, fermionicSign, ns);
+
+			w(i, j) = skeleton_.bracket(O2g,
+			                            ProgramGlobals::FermionOrBosonEnum::BOSON,
+			                            ptr,
+			                            bra,
+			                            ket);
+		}
 	}
 
 	// Return the vector: O1 * O2 |psi>
@@ -254,6 +296,25 @@ private:
 		                         ket);
 	}
 
+	// as calcCorrelation_ for j the last site and i < j - 1, with O1g
+	// already grown up to s, which is left grown up to j - 1
+	FieldType calcRightCorner(SparseMatrixType& O1g,
+	                          SizeType& s,
+	                          SizeType i,
+	                          const SparseMatrixType& O2m,
+	                          ProgramGlobals::FermionOrBosonEnum fermionicSign,
+	                          const PsimagLite::GetBraOrKet& bra,
+	                          const PsimagLite::GetBraOrKet& ket) const
+	{
+		const SizeType j = skeleton_.numberOfSites() - 1;
+		const SizeType ns = j - 1;
+		for (; s < ns; ++s)
+			skeleton_.growByOneSite(O1g, i, fermionicSign, s, (s + 1 < ns));
+
+		// j - 2 below is the pointer
+		return skeleton_.bracketRightCorner(O1g, O2m, fermionicSign, j - 2, bra, ket);
+	}
+
 	static SparseMatrixType identity(SizeType n)
 	{
 		SparseMatrixType ret(n, n);
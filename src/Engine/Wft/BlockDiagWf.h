@@ -42,7 +42,6 @@ class BlockDiagWf {
 		    : patchesLeft_(patcheLeft),
 		      patchesRight_(patchesRight),
 		      lrs_(lrs),
-		      packSuper_(lrs.left().size()),
 		      src_(src),
 		      srcIndex_(src.sector(iSrc)),
 		      offset_(src.offset(srcIndex_)),
@@ -67,9 +66,8 @@ class BlockDiagWf {
 				SizeType row = r + offsetL;
 				for (SizeType c = 0; c < ctotal; ++c) {
 					SizeType col = c + offsetR;
-					SizeType ind = packSuper_.pack(row,
-					                               col,
-					                               lrs_.super().permutationInverse());
+					SizeType ind = lrs_.super().permutationInverse(row +
+					                                               col*lrs_.left().size());
 					assert(ind >= offset_);
 					m(r, c) = src_.fastAccess(srcIndex_, ind - offset_);
 					//sum += PsimagLite::conj(m(r, c))*m(r, c);
@@ -82,7 +80,6 @@ class BlockDiagWf {
 		const VectorSizeType& patchesLeft_;
 		const VectorSizeType& patchesRight_;
 		const LeftRightSuperType& lrs_;
-		const PackIndicesType packSuper_;
 		const VectorWithOffsetType& src_;
 		SizeType srcIndex_;
 		SizeType offset_;
@@ -563,7 +560,6 @@ private:
 
 		SizeType npatches = data_.size();
 		SizeType ns = lrs.left().size();
-		PackIndicesType packSuper(ns);
 		PackIndicesType packLeft(lrs.left().size()/hilbert);
 		PackIndicesType packRight(hilbert);
 		SizeType offset = lrs.super().partition(destIndex);
@@ -588,9 +584,7 @@ private:
 					assert(k < hilbert);
 					SizeType lind = packLeft.pack(row, k, lrs.left().permutationInverse());
 
-					SizeType ind = packSuper.pack(lind,
-					                              rind,
-					                              lrs.super().permutationInverse());
+					SizeType ind = lrs.super().permutationInverse(lind + rind*ns);
 					const ComplexOrRealType& value = m(r, c);
 					//sum += PsimagLite::conj(value)*value;
 					//if (ind < offset || ind >= lrs.super().partition(destIndex + 1))
@@ -614,7 +608,6 @@ private:
 
 		SizeType npatches = data_.size();
 		SizeType ns = lrs.left().size();
-		PackIndicesType packSuper(ns);
 		PackIndicesType packLeft(lrs_.left().permutationInverse().size()/hilbert);
 		PackIndicesType packRight(hilbert);
 		SizeType offset = lrs.super().partition(destIndex);
@@ -639,9 +632,7 @@ private:
 					assert(k < hilbert);
 					SizeType rind = packRight.pack(k, col, lrs.right().permutationInverse());
 
-					SizeType ind = packSuper.pack(lind,
-					                              rind,
-					                              lrs.super().permutationInverse());
+					SizeType ind = lrs.super().permutationInverse(lind + rind*ns);
 					const ComplexOrRealType& value = m(r, c);
 					//sum += PsimagLite::conj(value)*value;
 					//if (ind < offset || ind >= lrs.super().partition(destIndex + 1))
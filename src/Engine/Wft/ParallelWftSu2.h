@@ -138,7 +138,7 @@ public:
 			       dmrgWaveStruct_.getTransform(ProgramGlobals::SysOrEnvEnum::SYSTEM).rows());
 			assert(lrs_.right().permutationInverse().size()/volumeOf(nk)==
 			       dmrgWaveStruct_.getTransform(ProgramGlobals::SysOrEnvEnum::ENVIRON).cols());
-			pack1_ = new PackIndicesType(lrs.super().permutationInverse().size()/
+			pack1_ = new PackIndicesType(lrs.super().permutationSize()/
 			                             lrs.right().permutationInverse().size());
 			pack2_ = new PackIndicesType(volumeOf(nk));
 		}
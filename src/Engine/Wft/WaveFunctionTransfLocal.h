@@ -294,7 +294,7 @@ private:
 	{
 		typedef PsimagLite::Parallelizer<WftSparseTwoSiteType> ParallelizerType;
 
-		assert(dmrgWaveStruct_.lrs().super().permutationInverse().size() == psiSrc.size());
+		assert(dmrgWaveStruct_.lrs().super().permutationSize() == psiSrc.size());
 
 		bool inBlocks = (lrs.right().block().size() > 1 &&
 		                 wftOptions_.accel == WftOptionsType::ACCEL_BLOCKS);
@@ -366,10 +366,10 @@ private:
 	                    const MatrixOrIdentityType& wsRef) const
 	{
 		SizeType volumeOfNk = ProgramGlobals::volumeOf(nk);
-		SizeType nip = lrs.super().permutationInverse().size()/
+		SizeType nip = lrs.super().permutationSize()/
 		        lrs.right().permutationInverse().size();
 
-		assert(dmrgWaveStruct_.lrs().super().permutationInverse().size() == psiSrc.size());
+		assert(dmrgWaveStruct_.lrs().super().permutationSize() == psiSrc.size());
 
 		SizeType start = psiDest.offset(i0);
 		SizeType total = psiDest.effectiveSize(i0);
@@ -422,7 +422,7 @@ private:
 		SizeType nip = lrs.left().permutationInverse().size()/volumeOfNk;
 		SizeType nalpha = lrs.left().permutationInverse().size();
 
-		assert(dmrgWaveStruct_.lrs().super().permutationInverse().size()==psiSrc.size());
+		assert(dmrgWaveStruct_.lrs().super().permutationSize()==psiSrc.size());
 
 		SizeType start = psiDest.offset(i0);
 		SizeType total = psiDest.effectiveSize(i0);
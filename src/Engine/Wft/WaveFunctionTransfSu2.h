@@ -246,7 +246,7 @@ private:
 	                                  const SparseMatrixType& weT) const
 	{
 		SizeType volumeOfNk = ParallelWftType::volumeOf(nk);
-		SizeType nip = lrs.super().permutationInverse().size()/
+		SizeType nip = lrs.super().permutationSize()/
 		        lrs.right().permutationInverse().size();
 
 		assert(lrs.left().permutationInverse().size() == volumeOfNk ||
@@ -348,7 +348,7 @@ private:
 		msg<<" Source sectors "<<psiSrc.sectors();
 		progress_.printline(msgg, std::cout);
 		const LeftRightSuperType& lrsOld = dmrgWaveStruct_.lrs();
-		assert(lrsOld.super().permutationInverse().size() == psiSrc.size());
+		assert(lrsOld.super().permutationSize() == psiSrc.size());
 
 		SparseMatrixType we;
 		dmrgWaveStruct_.getTransform(ProgramGlobals::SysOrEnvEnum::ENVIRON).toSparse(we);
@@ -502,10 +502,10 @@ private:
 	                            const SparseMatrixType& ws) const
 	{
 		SizeType volumeOfNk = ParallelWftType::volumeOf(nk);
-		SizeType nip = lrs.super().permutationInverse().size()/
+		SizeType nip = lrs.super().permutationSize()/
 		        lrs.right().permutationInverse().size();
 
-		assert(dmrgWaveStruct_.lrs().super().permutationInverse().size() == psiSrc.size());
+		assert(dmrgWaveStruct_.lrs().super().permutationSize() == psiSrc.size());
 
 		SizeType start = psiDest.offset(i0);
 		SizeType total = psiDest.effectiveSize(i0);
@@ -611,7 +611,7 @@ private:
 		SizeType nip = lrs.left().permutationInverse().size()/volumeOfNk;
 		SizeType nalpha = lrs.left().permutationInverse().size();
 
-		assert(dmrgWaveStruct_.lrs().super().permutationInverse().size() == psiSrc.size());
+		assert(dmrgWaveStruct_.lrs().super().permutationSize() == psiSrc.size());
 
 		const FactorsType* fptrS = lrs.left().getFactors();
 		assert(fptrS);
@@ -679,7 +679,7 @@ private:
 	                    const LeftRightSuperType& lrs,
 	                    SizeType volumeOfNk) const
 	{
-		SizeType nip = lrs.super().permutationInverse().size()/
+		SizeType nip = lrs.super().permutationSize()/
 		        lrs.right().permutationInverse().size();
 		PackIndicesType pack1(nip);
 		PackIndicesType pack2(volumeOfNk);
@@ -47,7 +47,7 @@ public:
 	      volumeOfNk_(ProgramGlobals::volumeOf(nk)),
 	      pack1_((sysOrEnv == ProgramGlobals::SysOrEnvEnum::SYSTEM)
 	             ? lrs.left().permutationInverse().size() :
-	               lrs.super().permutationInverse().size()/
+	               lrs.super().permutationSize()/
 	               lrs.right().permutationInverse().size()),
 	      pack2_((sysOrEnv == ProgramGlobals::SysOrEnvEnum::SYSTEM)
 	             ?  lrs.left().permutationInverse().size()/volumeOfNk_ : volumeOfNk_),
@@ -2,6 +2,7 @@
 #include "den_csr_kron_mult.cpp"
 #include "den_kron_mult.cpp"
 #include "csr_den_kron_mult.cpp"
+#include "den_kron_mult_block.cpp"
 #ifndef USE_FLOAT
 typedef double RealType;
 #else
@@ -114,4 +115,32 @@ void csr_den_kron_mult
                           const RealType,
                           PsimagLite::GemmR<std::complex<RealType> >&);
 
+//-----------------------------------------------------------------------------------
+
+template
+void den_kron_mult_block<RealType>(const char transA,
+                                   const char transB,
+                                   const PsimagLite::Matrix<RealType>& a_,
+                                   const PsimagLite::Matrix<RealType>& b_,
+                                   const PsimagLite::Vector<RealType>::Type& yin,
+                                   SizeType offsetY,
+                                   PsimagLite::Vector<RealType>::Type& xout,
+                                   SizeType offsetX,
+                                   SizeType nvectors,
+                                   PsimagLite::Vector<RealType>::Type&,
+                                   PsimagLite::GemmR<RealType>&);
+
+template
+void den_kron_mult_block
+<std::complex<RealType> >(const char transA,
+                          const char transB,
+                          const PsimagLite::Matrix<std::complex<RealType> >& a_,
+                          const PsimagLite::Matrix<std::complex<RealType> >& b_,
+                          const PsimagLite::Vector<std::complex<RealType> >::Type& yin,
+                          SizeType offsetY,
+                          PsimagLite::Vector<std::complex<RealType> >::Type& xout,
+                          SizeType offsetX,
+                          SizeType nvectors,
+                          PsimagLite::Vector<std::complex<RealType> >::Type&,
+                          PsimagLite::GemmR<std::complex<RealType> >&);
 
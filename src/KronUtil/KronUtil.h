@@ -58,5 +58,21 @@ void csr_den_kron_mult( const char transA,
 	                    SizeType offsetX,
                         const typename PsimagLite::Real<ComplexOrRealType>::Type,
                         PsimagLite::GemmR<ComplexOrRealType>&);
+
+//-----------------------------------------------------------------------------------
+
+template<typename ComplexOrRealType>
+void den_kron_mult_block(const char transA,
+                         const char transB,
+                         const PsimagLite::Matrix<ComplexOrRealType>& a_,
+                         const PsimagLite::Matrix<ComplexOrRealType>& b_,
+                         const typename PsimagLite::Vector<ComplexOrRealType>::Type& yin,
+                         SizeType offsetY,
+                         typename PsimagLite::Vector<ComplexOrRealType>::Type& xout,
+                         SizeType offsetX,
+                         SizeType nvectors,
+                         typename PsimagLite::Vector<ComplexOrRealType>::Type&,
+                         PsimagLite::GemmR<ComplexOrRealType>&);
 #endif
 
+
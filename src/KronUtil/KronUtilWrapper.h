@@ -68,6 +68,24 @@ void den_kron_mult(const char transA,
 	throw PsimagLite::RuntimeError(msg);
 }
 
+template<typename ComplexOrRealType>
+void den_kron_mult_block(const char transA,
+                         const char transB,
+                         const PsimagLite::Matrix<ComplexOrRealType>& a_,
+                         const PsimagLite::Matrix<ComplexOrRealType>& b_,
+                         const typename PsimagLite::Vector<ComplexOrRealType>::Type& yin,
+                         SizeType offsetY,
+                         typename PsimagLite::Vector<ComplexOrRealType>::Type& xout,
+                         SizeType offsetX,
+                         SizeType nvectors,
+                         typename PsimagLite::Vector<ComplexOrRealType>::Type&,
+                         PsimagLite::GemmR<ComplexOrRealType>&)
+{
+	PsimagLite::String msg("den_kron_mult_block: please #undefine DO_NOT_USE_KRON_UTIL");
+	msg += " and link against libkronutil\n";
+	throw PsimagLite::RuntimeError(msg);
+}
+
 #endif
 
 #endif // KRON_UTIL_WRAPPER_H
@@ -62,6 +62,40 @@ public:
 		};
 	}
 
+	// copy of other, with its values converted to the precision of this
+	template<typename OtherSparseMatrixType>
+	explicit MatrixDenseOrSparse(const MatrixDenseOrSparse<OtherSparseMatrixType>& other)
+	    : isDense_(other.isDense()),
+	      sparseMatrix_(other.rows(), other.cols()),
+	      denseMatrix_(0, 0)
+	{
+		if (isDense_) {
+			typedef typename OtherSparseMatrixType::value_type OtherValueType;
+			const PsimagLite::Matrix<OtherValueType>& dense = other.dense();
+			denseMatrix_.resize(dense.rows(), dense.cols());
+			for (SizeType j = 0; j < dense.cols(); ++j)
+				for (SizeType i = 0; i < dense.rows(); ++i)
+					denseMatrix_(i, j) = static_cast<ComplexOrRealType>(dense(i, j));
+			return;
+		}
+
+		const OtherSparseMatrixType& sparse = other.sparse();
+		const SizeType nrows = sparse.rows();
+		sparseMatrix_.reserve(sparse.nonZeros());
+		SizeType counter = 0;
+		for (SizeType i = 0; i < nrows; ++i) {
+			sparseMatrix_.setRow(i, counter);
+			for (int k = sparse.getRowPtr(i); k < sparse.getRowPtr(i + 1); ++k) {
+				sparseMatrix_.pushCol(sparse.getCol(k));
+				sparseMatrix_.pushValue(static_cast<ComplexOrRealType>(sparse.getValue(k)));
+				++counter;
+			}
+		}
+
+		sparseMatrix_.setRow(nrows, counter);
+		sparseMatrix_.checkValidity();
+	}
+
 	void conjugate()
 	{
 		SparseMatrixType& nonconst = const_cast<SparseMatrixType&>(sparseMatrix_);
@@ -210,5 +244,64 @@ void kronMult(typename PsimagLite::Vector<typename SparseMatrixType::value_type>
 	};
 } // kron_mult
 
+// nvectors consecutive Y's of size cols(op(A))*cols(op(B)) starting at offsetY
+// into nvectors consecutive X's of size rows(op(A))*rows(op(B)) starting at offsetX
+// work is kept by the caller across calls, and only grows when too small
+template<typename SparseMatrixType>
+void kronMultBlock(typename PsimagLite::Vector<typename SparseMatrixType::value_type>::Type& xout,
+                   SizeType offsetX,
+                   const typename PsimagLite::Vector<typename SparseMatrixType::value_type>::Type& yin,
+                   SizeType offsetY,
+                   SizeType nvectors,
+                   char transA,
+                   char transB,
+                   const MatrixDenseOrSparse<SparseMatrixType>& A,
+                   const MatrixDenseOrSparse<SparseMatrixType>& B,
+                   const typename PsimagLite::Real<typename SparseMatrixType::value_type>::Type
+                   denseFlopDiscount,
+                   typename PsimagLite::Vector<typename SparseMatrixType::value_type>::Type& work,
+                   PsimagLite::GemmR<typename SparseMatrixType::value_type>& gemmR)
+{
+	typedef typename SparseMatrixType::value_type ComplexOrRealType;
+
+	const bool isComplex = PsimagLite::IsComplexNumber<ComplexOrRealType>::True;
+	const bool isConjTransA = (transA == 'C' || transA == 'c');
+	if (nvectors > 1 && A.isDense() && B.isDense() && !(isComplex && isConjTransA)) {
+		den_kron_mult_block(transA,
+		                    transB,
+		                    A.dense(),
+		                    B.dense(),
+		                    yin,
+		                    offsetY,
+		                    xout,
+		                    offsetX,
+		                    nvectors,
+		                    work,
+		                    gemmR);
+		return;
+	}
+
+	const bool isTransA = (transA != 'N' && transA != 'n');
+	const bool isTransB = (transB != 'N' && transB != 'n');
+	const SizeType rowsA = (isTransA) ? A.cols() : A.rows();
+	const SizeType colsA = (isTransA) ? A.rows() : A.cols();
+	const SizeType rowsB = (isTransB) ? B.cols() : B.rows();
+	const SizeType colsB = (isTransB) ? B.rows() : B.cols();
+	const SizeType sizeX = rowsA*rowsB;
+	const SizeType sizeY = colsA*colsB;
+
+	for (SizeType v = 0; v < nvectors; ++v)
+		kronMult(xout,
+		         offsetX + v*sizeX,
+		         yin,
+		         offsetY + v*sizeY,
+		         transA,
+		         transB,
+		         A,
+		         B,
+		         denseFlopDiscount,
+		         gemmR);
+} // kronMultBlock
+
 } // namespace Dmrg
 #endif // MATRIXDENSEORSPARSE_H
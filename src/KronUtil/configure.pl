@@ -29,7 +29,8 @@ defined($cfiles) or $cfiles = "../../dmrgpp/TestSuite/inputs/ConfigBase.psiTag";
 defined($flavor) or $flavor = NewMake::noFlavor();
 defined($gccdash) or $gccdash = "";
 
-my @names = ("KronUtil", "util", "utilComplex", "csc_nnz");
+my @names = ("KronUtil", "util", "utilComplex", "csc_nnz",
+             "KronUtilFloat", "utilFloat", "utilComplexFloat");
 
 my @drivers;
 my $dotos = "";
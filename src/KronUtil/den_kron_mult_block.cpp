@@ -0,0 +1,104 @@
+#include "util.h"
+
+template<typename ComplexOrRealType>
+void den_kron_mult_block(const char transA,
+                         const char transB,
+                         const PsimagLite::Matrix<ComplexOrRealType>& a_,
+                         const PsimagLite::Matrix<ComplexOrRealType>& b_,
+                         const typename PsimagLite::Vector<ComplexOrRealType>::Type& yin_,
+                         SizeType offsetY,
+                         typename PsimagLite::Vector<ComplexOrRealType>::Type& xout_,
+                         SizeType offsetX,
+                         SizeType nvectors,
+                         typename PsimagLite::Vector<ComplexOrRealType>::Type& by_,
+                         PsimagLite::GemmR<ComplexOrRealType>& gemmR)
+{
+	const bool is_complex = PsimagLite::IsComplexNumber<ComplexOrRealType>::True;
+	const int nrow_A = a_.n_row();
+	const int ncol_A = a_.n_col();
+	const int nrow_B = b_.n_row();
+	const int ncol_B = b_.n_col();
+
+	const int isTransA = (transA == 'T') || (transA == 't');
+	const int isTransB = (transB == 'T') || (transB == 't');
+	const int isConjTransA = (transA == 'C') || (transA == 'c');
+	const int isConjTransB = (transB == 'C') || (transB == 'c');
+
+	const int nrow_1 = (isTransA || isConjTransA) ? ncol_A : nrow_A;
+	const int ncol_1 = (isTransA || isConjTransA) ? nrow_A : ncol_A;
+	const int nrow_2 = (isTransB || isConjTransB) ? ncol_B : nrow_B;
+	const int ncol_2 = (isTransB || isConjTransB) ? nrow_B : ncol_B;
+
+	const int nrow_X = nrow_2;
+	const int ncol_X = nrow_1;
+	const int nrow_Y = ncol_2;
+	const int ncol_Y = ncol_1;
+
+	const SizeType size_X = nrow_X * ncol_X;
+	const SizeType size_Y = nrow_Y * ncol_Y;
+
+	/*
+ *   -------------------------------------------------------------
+ *   A and B in dense matrix format
+ *
+ *   X_v += kron( op(A), op(B)) * Y_v,  for v = 0, ..., nvectors - 1
+ *
+ *   The Y_v are stored one after the other starting at yin_[offsetY],
+ *   so that  [Y_0, Y_1, ...] is a nrow_Y by (ncol_Y * nvectors) matrix,
+ *   and the X_v are stored one after the other starting at xout_[offsetX].
+ *
+ *   BY = op(B) * [Y_0, Y_1, ...]  is a single GEMM for all vectors,
+ *   stored in the caller's workspace by_, which only grows when too small
+ *
+ *   X_v += BY_v * transpose(op(A))  reuses A for each vector
+ *
+ *   op(A) = conj(transpose(A)) is not supported for complex A, because
+ *   transpose(op(A)) = conj(A) is not a BLAS operation
+ *   -------------------------------------------------------------
+ */
+	assert(!(is_complex && isConjTransA));
+	assert(offsetX + nvectors * size_X <= xout_.size());
+	assert(offsetY + nvectors * size_Y <= yin_.size());
+
+	if (size_X == 0 || size_Y == 0 || nvectors == 0) return;
+
+	const ComplexOrRealType d_one = 1.0;
+	const ComplexOrRealType d_zero = 0.0;
+
+	const int nrow_BY = nrow_X;
+	const int ncol_BY = ncol_Y * nvectors;
+	const SizeType size_BY = nrow_BY * ncol_BY;
+	if (by_.size() < size_BY) by_.resize(size_BY);
+
+	{
+		/*
+	 * ---------------------------------------
+	 * BY(:, 1:ncol_BY) = op(B) * [Y_0, Y_1, ...]
+	 * ---------------------------------------
+	 */
+		const char trans1 = (isConjTransB) ? 'C' : ((isTransB) ? 'T' : 'N');
+		const char trans2 = 'N';
+		gemmR(trans1, trans2,
+		      nrow_BY, ncol_BY, nrow_Y,
+		      d_one, &(b_(0,0)), nrow_B,
+		      &(yin_[offsetY]), nrow_Y,
+		      d_zero, &(by_[0]), nrow_BY);
+	}
+
+	/*
+	 * ----------------------------------------------
+	 * X_v += BY_v * transpose(op(A)), for real A
+	 * conj(transpose(A)) is the same as transpose(A)
+	 * ----------------------------------------------
+	 */
+	const char trans1 = 'N';
+	const char trans2 = (isTransA || isConjTransA) ? 'N' : 'T';
+	for (SizeType v = 0; v < nvectors; ++v) {
+		gemmR(trans1, trans2,
+		      nrow_X, ncol_X, ncol_Y,
+		      d_one, &(by_[v * ncol_Y * nrow_BY]), nrow_BY,
+		      &(a_(0,0)), nrow_A,
+		      d_one, &(xout_[offsetX + v * size_X]), nrow_X);
+	}
+}
+
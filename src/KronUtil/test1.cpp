@@ -25,6 +25,8 @@ int main()
 	const SizeType gemmRnb = 100;
 	const SizeType threadsForGemmR = 1;
 	PsimagLite::GemmR<RealType> gemmR(needsPrinting, gemmRnb, threadsForGemmR);
+	// reused by all den_kron_mult_block calls below, as the engine does
+	PsimagLite::Vector<RealType>::Type blockWork;
 
 	for(thresholdB=0; thresholdB <= 1.1; thresholdB += 0.1) {
 		for(thresholdA=0; thresholdA <= 1.1; thresholdA += 0.1) {
@@ -260,6 +262,66 @@ int main()
 									}
 
 
+									/*
+	 * ---------------------------------------------
+	 * test nvectors products at once against
+	 * nvectors separate single vector products
+	 * ---------------------------------------------
+	 */
+									{
+										const SizeType nvectors = 3;
+										const SizeType size_X = nrow_X*ncol_X;
+										const SizeType size_Y = nrow_Y*ncol_Y;
+
+										PsimagLite::Matrix<RealType> yb_(nrow_Y, ncol_Y*nvectors);
+										den_gen_matrix(nrow_Y, ncol_Y*nvectors, 1.0, yb_);
+										PsimagLite::MatrixNonOwned<const RealType> ybRef(yb_);
+
+										PsimagLite::Matrix<RealType> xb1_(nrow_X, ncol_X*nvectors);
+										PsimagLite::MatrixNonOwned<RealType> xb1Ref(xb1_);
+										PsimagLite::Matrix<RealType> xb2_(nrow_X, ncol_X*nvectors);
+										PsimagLite::MatrixNonOwned<RealType> xb2Ref(xb2_);
+										den_zeros(nrow_X, ncol_X*nvectors, xb1_);
+										den_zeros(nrow_X, ncol_X*nvectors, xb2_);
+
+										den_kron_mult_block(transA, transB,
+										                    a_,
+										                    b_,
+										                    ybRef.getVector(),
+										                    0,
+										                    xb1Ref.getVector(),
+										                    0,
+										                    nvectors,
+										                    blockWork,
+										                    gemmR);
+
+										imethod = 1;
+										for (SizeType v = 0; v < nvectors; ++v)
+											den_kron_mult_method(imethod,
+											                     transA, transB,
+											                     a_,
+											                     b_,
+											                     ybRef.getVector(),
+											                     v*size_Y,
+											                     xb2Ref.getVector(),
+											                     v*size_X,
+											                     gemmR);
+
+										for(jx=0; jx < ncol_X*static_cast<int>(nvectors); jx++) {
+											for(ix=0; ix < nrow_X; ix++) {
+												RealType diff = std::abs(xb1_(ix,jx) - xb2_(ix,jx));
+												const RealType tol = 1.0/(1000.0*1000.0*1000.0);
+												int isok = (diff <= tol);
+												if (!isok) {
+													nerrors += 1;
+													printf("den_block: transA=%c transB=%c nrow_A %d ncol_A %d nrow_B %d ncol_B %d \n",
+													       transA, transB, nrow_A, ncol_A, nrow_B, ncol_B);
+													printf("ix %d, jx %d, diff %f \n", ix, jx, diff);
+												}
+											}
+										}
+									}
+
 									/*
 	 * ------------------
 	 * test sparse matrix
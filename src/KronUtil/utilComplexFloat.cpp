@@ -0,0 +1,6 @@
+// Single precision instances of utilComplex.cpp, used by the mixed precision
+// Kron products; nothing to add when the whole build is already float
+#ifndef USE_FLOAT
+#define USE_FLOAT
+#include "utilComplex.cpp"
+#endif
@@ -128,6 +128,9 @@ operator: dmrg
 testQn: testQn.o Qn.o
 	\$(CXX) Qn.o testQn.o \$(LDFLAGS) -o testQn
 
+testBasis: testBasis.o Qn.o ProgramGlobals.o Utils.o
+	\$(CXX) testBasis.o Qn.o ProgramGlobals.o Utils.o \$(LDFLAGS) -o testBasis
+
 libkronutil.a:
 	\$(MAKE) -C KronUtil
 
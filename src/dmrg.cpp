@@ -3,6 +3,7 @@
 #include "Provenance.h"
 #include "RegisterSignals.h"
 #include "DmrgDriver.h"
+#include "KronCostModel.h"
 
 typedef PsimagLite::Vector<PsimagLite::String>::Type VectorStringType;
 typedef  PsimagLite::CrsMatrix<std::complex<RealType> > MySparseMatrixComplex;
@@ -167,6 +168,35 @@ void mainLoop0(InputNgType::Readable& io,
 	                                                             opOptions);
 }
 
+// DenseSparseThreshold from KronCostModel, unless given in the input
+void kronAutoTune(InputNgType::Readable& io,
+                  ParametersDmrgSolverType& dmrgSolverParams,
+                  bool isComplex)
+{
+	try {
+		RealType threshold = 0;
+		io.readline(threshold, "DenseSparseThreshold=");
+		std::cout<<"KronAutoTune: DenseSparseThreshold="<<threshold;
+		std::cout<<" given in the input, not measuring\n";
+		return;
+	} catch (std::exception&) {}
+
+	PsimagLite::String kronCostFile("KronCostModel.txt");
+	try {
+		io.readline(kronCostFile, "KronCostModelFile=");
+	} catch (std::exception&) {}
+
+	const SizeType threads = dmrgSolverParams.nthreads;
+	if (isComplex) {
+		KronCostModel<std::complex<RealType> > kronCostModel(kronCostFile, threads);
+		dmrgSolverParams.denseSparseThreshold = kronCostModel.denseFlopDiscount();
+		return;
+	}
+
+	KronCostModel<RealType> kronCostModel(kronCostFile, threads);
+	dmrgSolverParams.denseSparseThreshold = kronCostModel.denseFlopDiscount();
+}
+
 int main(int argc, char **argv)
 {
 	PsimagLite::PsiApp application("DMRG++",&argc,&argv,1);
@@ -391,6 +421,9 @@ to the main dmrg driver are the following.
 	bool isComplex = (dmrgSolverParams.options.isSet("useComplex") ||
 	                  dmrgSolverParams.options.isSet("TimeStepTargeting"));
 
+	if (dmrgSolverParams.options.isSet("KronAutoTune"))
+		kronAutoTune(io, dmrgSolverParams, isComplex);
+
 	if (isComplex) {
 		mainLoop0<MySparseMatrixComplex>(io, dmrgSolverParams, options);
 	} else {
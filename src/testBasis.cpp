@@ -0,0 +1,103 @@
+#include "Basis.h"
+#include "CrsMatrix.h"
+#include <cstdlib>
+
+typedef PsimagLite::CrsMatrix<double> SparseMatrixType;
+typedef Dmrg::Basis<SparseMatrixType> BasisType;
+typedef BasisType::QnType QnType;
+typedef QnType::VectorQnType VectorQnType;
+typedef QnType::VectorSizeType VectorSizeType;
+typedef QnType::PairSizeType PairSizeType;
+
+// exposes setSymmetryRelated, so that a basis can be built from quantum numbers
+class TestBasis : public BasisType {
+
+public:
+
+	TestBasis(PsimagLite::String name, SizeType partitions)
+	    : BasisType(name)
+	{
+		VectorSizeType szPlusConst(2, 0);
+		VectorQnType qns;
+		for (SizeType p = 0; p < partitions; ++p) {
+			// partition p has electrons p and spin up p/2, so they differ
+			szPlusConst[0] = p;
+			szPlusConst[1] = p/2;
+			const SizeType states = 1 + static_cast<SizeType>(4*drand48());
+			for (SizeType i = 0; i < states; ++i)
+				qns.push_back(QnType(p & 1, szPlusConst, PairSizeType(0, 0), 0));
+		}
+
+		setSymmetryRelated(qns);
+	}
+};
+
+// compares the sector only product of basis1 and basis2 with the full one
+int testProduct(const TestBasis& basis1, const TestBasis& basis2)
+{
+	BasisType full("full");
+	full.setToProduct(basis1, basis2);
+
+	int nerrors = 0;
+	const SizeType npartitions = full.partition() - 1;
+	for (SizeType m = 0; m < npartitions; ++m) {
+		const QnType pseudoQn = full.qnEx(m);
+		BasisType sector("sector");
+		const SizeType initialSizeOfHashTable = 10;
+		const bool sectorOnly = true;
+		sector.setToProduct(basis1, basis2, &pseudoQn, initialSizeOfHashTable, sectorOnly);
+
+		if (sector.permutationSize() != full.permutationSize()) {
+			std::cerr<<"permutationSize "<<sector.permutationSize();
+			std::cerr<<" expected "<<full.permutationSize()<<"\n";
+			++nerrors;
+			continue;
+		}
+
+		const VectorSizeType& permutation = full.permutationVector();
+		const VectorSizeType& permutationInverse = full.permutationInverse();
+		for (SizeType i = 0; i < permutation.size(); ++i) {
+			if (sector.permutation(i) != permutation[i]) {
+				std::cerr<<"sector "<<m<<" permutation("<<i<<")="<<sector.permutation(i);
+				std::cerr<<" expected "<<permutation[i]<<"\n";
+				++nerrors;
+			}
+
+			if (static_cast<SizeType>(sector.permutationInverse(i)) != permutationInverse[i]) {
+				std::cerr<<"sector "<<m<<" permutationInverse("<<i<<")=";
+				std::cerr<<sector.permutationInverse(i);
+				std::cerr<<" expected "<<permutationInverse[i]<<"\n";
+				++nerrors;
+			}
+
+			if (sector.fermionicSign(i, -1) != full.fermionicSign(i, -1)) {
+				std::cerr<<"sector "<<m<<" fermionicSign("<<i<<") differs\n";
+				++nerrors;
+			}
+		}
+	}
+
+	return nerrors;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 3) {
+		std::cerr<<"USAGE: "<<argv[0]<<" partitionsLeft partitionsRight [seed]\n";
+		return 1;
+	}
+
+	if (argc == 4) srand48(atoi(argv[3]));
+
+	TestBasis basis1("left", atoi(argv[1]));
+	TestBasis basis2("right", atoi(argv[2]));
+
+	const int nerrors = testProduct(basis1, basis2);
+	if (nerrors > 0) {
+		std::cerr<<nerrors<<" errors\n";
+		return 1;
+	}
+
+	std::cout<<"pass all tests\n";
+	return 0;
+}